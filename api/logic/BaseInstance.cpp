@@ -25,6 +25,8 @@
 #include "minecraft/MinecraftVersionList.h"
 #include "FileSystem.h"
 #include "Commandline.h"
+#include "Env.h"
+#include "TrashBin.h"
 
 BaseInstance::BaseInstance(SettingsObjectPtr globalSettings, SettingsObjectPtr settings, const QString &rootDir)
 	: QObject()
@@ -49,6 +51,7 @@ BaseInstance::BaseInstance(SettingsObjectPtr globalSettings, SettingsObjectPtr s
 	m_settings->registerOverride(globalSettings->getSetting("ShowConsole"), consoleSetting);
 	m_settings->registerOverride(globalSettings->getSetting("AutoCloseConsole"), consoleSetting);
 	m_settings->registerOverride(globalSettings->getSetting("LogPrePostOutput"), consoleSetting);
+	m_settings->registerOverride(globalSettings->getSetting("ConsoleMaxLinesPerSecond"), consoleSetting);
 }
 
 QString BaseInstance::getPreLaunchCommand()
@@ -76,7 +79,7 @@ void BaseInstance::iconUpdated(QString key)
 
 void BaseInstance::nuke()
 {
-	FS::deletePath(instanceRoot());
+	ENV.trash()->moveToTrash(instanceRoot());
 	emit nuked(this);
 }
 
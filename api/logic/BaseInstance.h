@@ -182,6 +182,24 @@ public:
 	 */
 	virtual QString getLogFileRoot() = 0;
 
+	/*!
+	 * Folders worth knowing the size of (worlds, mods, ...), by what they hold.
+	 * Paths are absolute. None by default.
+	 */
+	virtual QMap<QString, QStringList> diskUsageParts() const
+	{
+		return {};
+	}
+
+	/*!
+	 * Folders of mod files that get replaced, never changed in place, like the mod store wants them.
+	 * Paths are absolute. None by default.
+	 */
+	virtual QStringList modFolders() const
+	{
+		return {};
+	}
+
 	/*!
 	 * does any necessary cleanups after the instance finishes. also runs before\
 	 * TODO: turn into a task that can run asynchronously
@@ -0,0 +1,213 @@
+#include "DiskUsageScanner.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QThread>
+#include <QDebug>
+#include <QtConcurrentRun>
+
+namespace
+{
+const quint32 cacheMagic = 0x4D4D4344; // MMCD
+const quint32 cacheVersion = 1;
+}
+
+DiskUsageScanner::DiskUsageScanner(const QString &cachePath, QObject *parent)
+	: QObject(parent), m_cachePath(cachePath), m_stopping(false), m_queued(0)
+{
+	// one folder at a time, the disk is the limit anyway
+	m_pool.setMaxThreadCount(1);
+}
+
+DiskUsageScanner::~DiskUsageScanner()
+{
+	m_stopping = true;
+	m_pool.waitForDone();
+}
+
+void DiskUsageScanner::scan(const QString &id, const QString &root, const QMap<QString, QStringList> &parts, bool full)
+{
+	m_queued++;
+	QtConcurrent::run(&m_pool, [this, id, root, parts, full]()
+	{
+		QThread::currentThread()->setPriority(QThread::IdlePriority);
+		if(!m_cacheLoaded)
+		{
+			loadCache();
+		}
+		if(!m_stopping)
+		{
+			run(id, root, parts, full);
+		}
+		if(--m_queued == 0)
+		{
+			if(m_cacheChanged)
+			{
+				saveCache();
+			}
+			emit idle();
+		}
+	});
+}
+
+void DiskUsageScanner::run(const QString &id, const QString &root, const QMap<QString, QStringList> &parts, bool full)
+{
+	auto rootPath = QDir::cleanPath(QDir(root).absolutePath());
+	if(!QFileInfo(rootPath).isDir())
+	{
+		forget(rootPath);
+		emit scanned(id, 0, QVariantMap());
+		return;
+	}
+	QHash<QString, qint64> totals;
+	qint64 total = measure(rootPath, full, totals);
+	if(m_stopping)
+	{
+		return;
+	}
+
+	QVariantMap partTotals;
+	for(auto iter = parts.begin(); iter != parts.end(); iter++)
+	{
+		qint64 partTotal = 0;
+		for(auto &path : iter.value())
+		{
+			// only what was counted for root, so links out of it count for nothing here too
+			partTotal += totals.value(QDir::cleanPath(QDir(path).absolutePath()), 0);
+		}
+		partTotals.insert(iter.key(), partTotal);
+	}
+	emit scanned(id, total, partTotals);
+}
+
+qint64 DiskUsageScanner::measure(const QString &path, bool full, QHash<QString, qint64> &totals)
+{
+	if(m_stopping)
+	{
+		return 0;
+	}
+	qint64 modified = QFileInfo(path).lastModified().toMSecsSinceEpoch();
+	auto iter = m_cache.find(path);
+	if(full || iter == m_cache.end() || iter->modified != modified)
+	{
+		Node node;
+		node.modified = modified;
+		QDir dir(path);
+		auto entries = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System, QDir::NoSort);
+		for(auto &entry : entries)
+		{
+			// links count for nothing, what they point to belongs to someone else
+			if(entry.isSymLink())
+			{
+				continue;
+			}
+			if(entry.isDir())
+			{
+				node.dirs.append(entry.fileName());
+			}
+			else
+			{
+				node.files += entry.size();
+			}
+		}
+		// folders that are gone take their cached subtrees with them
+		if(iter != m_cache.end())
+		{
+			for(auto &old : iter->dirs)
+			{
+				if(!node.dirs.contains(old))
+				{
+					forget(path + "/" + old);
+				}
+			}
+		}
+		iter = m_cache.insert(path, node);
+		m_cacheChanged = true;
+	}
+
+	qint64 total = iter->files;
+	// measure may add to the cache, so don't hold on to the iterator
+	auto dirs = iter->dirs;
+	for(auto &sub : dirs)
+	{
+		total += measure(path + "/" + sub, full, totals);
+	}
+	totals.insert(path, total);
+	return total;
+}
+
+void DiskUsageScanner::forget(const QString &path)
+{
+	auto iter = m_cache.find(path);
+	if(iter == m_cache.end())
+	{
+		return;
+	}
+	auto dirs = iter->dirs;
+	m_cache.erase(iter);
+	m_cacheChanged = true;
+	for(auto &sub : dirs)
+	{
+		forget(path + "/" + sub);
+	}
+}
+
+void DiskUsageScanner::loadCache()
+{
+	m_cacheLoaded = true;
+	QFile file(m_cachePath);
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_0);
+	quint32 magic = 0, version = 0, count = 0;
+	in >> magic >> version >> count;
+	if(in.status() != QDataStream::Ok || magic != cacheMagic || version != cacheVersion)
+	{
+		return;
+	}
+	QHash<QString, Node> cache;
+	cache.reserve(qMin<quint32>(count, 1000000));
+	for(quint32 i = 0; i < count; i++)
+	{
+		QString path;
+		Node node;
+		in >> path >> node.modified >> node.files >> node.dirs;
+		if(in.status() != QDataStream::Ok)
+		{
+			qWarning() << "Disk usage cache" << m_cachePath << "is damaged, starting over";
+			return;
+		}
+		cache.insert(path, node);
+	}
+	m_cache.swap(cache);
+}
+
+void DiskUsageScanner::saveCache()
+{
+	m_cacheChanged = false;
+	QSaveFile file(m_cachePath);
+	if(!file.open(QIODevice::WriteOnly))
+	{
+		return;
+	}
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_0);
+	out << cacheMagic << cacheVersion << quint32(m_cache.size());
+	for(auto iter = m_cache.begin(); iter != m_cache.end(); iter++)
+	{
+		out << iter.key() << iter->modified << iter->files << iter->dirs;
+	}
+	if(out.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return;
+	}
+	file.commit();
+}
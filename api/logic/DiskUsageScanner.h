@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVariantMap>
+#include <atomic>
+
+#include "multimc_logic_export.h"
+
+/**
+ * Adds up how much space folder trees take, in the background.
+ *
+ * Scans run one after another on a single thread at idle priority. What every folder holds
+ * (the total size of its files and the names of its subfolders) is cached by the folder's modification time,
+ * so a folder is only listed again when something was added, removed or renamed in it.
+ * The cache is kept in a file between runs.
+ *
+ * Files that grow in place (logs, region files) don't touch their folder's time. Ask for a full scan
+ * when that matters, for example after the game has run.
+ */
+class MULTIMC_LOGIC_EXPORT DiskUsageScanner : public QObject
+{
+	Q_OBJECT
+public:
+	explicit DiskUsageScanner(const QString &cachePath, QObject *parent = nullptr);
+	virtual ~DiskUsageScanner();
+
+	/**
+	 * Queue a scan of root.
+	 * parts are named lists of folders inside root that also get their own totals.
+	 * A full scan lists every folder again, ignoring the cache.
+	 */
+	void scan(const QString &id, const QString &root, const QMap<QString, QStringList> &parts = {}, bool full = false);
+
+signals:
+	/// size of root and of each part, in bytes. Emitted from the scanner thread.
+	void scanned(const QString &id, qint64 total, const QVariantMap &parts);
+	/// the queue is empty
+	void idle();
+
+private:
+	struct Node
+	{
+		qint64 modified = 0;
+		qint64 files = 0;
+		QStringList dirs;
+	};
+	void run(const QString &id, const QString &root, const QMap<QString, QStringList> &parts, bool full);
+	qint64 measure(const QString &path, bool full, QHash<QString, qint64> &totals);
+	void forget(const QString &path);
+	void loadCache();
+	void saveCache();
+
+private:
+	QString m_cachePath;
+	QThreadPool m_pool;
+	std::atomic<bool> m_stopping;
+	std::atomic<int> m_queued;
+
+	// only touched by the scanner thread
+	QHash<QString, Node> m_cache;
+	bool m_cacheLoaded = false;
+	bool m_cacheChanged = false;
+};
@@ -0,0 +1,119 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include "DiskUsageScanner.h"
+#include "FileSystem.h"
+
+class DiskUsageScannerTest : public QObject
+{
+	Q_OBJECT
+
+	struct Result
+	{
+		qint64 total = -1;
+		QVariantMap parts;
+	};
+
+	static Result scan(DiskUsageScanner &scanner, const QString &root, const QMap<QString, QStringList> &parts = {}, bool full = false)
+	{
+		QSignalSpy scanned(&scanner, SIGNAL(scanned(QString, qint64, QVariantMap)));
+		scanner.scan("test", root, parts, full);
+		Result result;
+		if(scanned.wait(10000))
+		{
+			result.total = scanned.first()[1].toLongLong();
+			result.parts = scanned.first()[2].toMap();
+		}
+		return result;
+	}
+
+	static void makeFile(const QString &path, int size)
+	{
+		FS::ensureFilePathExists(path);
+		FS::write(path, QByteArray(size, 'x'));
+	}
+
+private
+slots:
+	void test_scan()
+	{
+		QTemporaryDir dir;
+		auto root = FS::PathCombine(dir.path(), "instance");
+		makeFile(FS::PathCombine(root, "instance.cfg"), 100);
+		makeFile(FS::PathCombine(root, "minecraft", "saves", "world", "level.dat"), 1000);
+		makeFile(FS::PathCombine(root, "minecraft", "saves", "world", "region", "r.0.0.mca"), 5000);
+		makeFile(FS::PathCombine(root, "minecraft", "mods", "mod.jar"), 2000);
+		makeFile(FS::PathCombine(root, "minecraft", "logs", "latest.log"), 300);
+
+		QMap<QString, QStringList> parts;
+		parts["worlds"] = QStringList{FS::PathCombine(root, "minecraft", "saves")};
+		parts["mods"] = QStringList{FS::PathCombine(root, "minecraft", "mods"), FS::PathCombine(root, "minecraft", "coremods")};
+
+		DiskUsageScanner scanner(FS::PathCombine(dir.path(), "diskusage.cache"));
+		auto result = scan(scanner, root, parts);
+		QCOMPARE(result.total, qint64(8400));
+		QCOMPARE(result.parts["worlds"].toLongLong(), qint64(6000));
+		QCOMPARE(result.parts["mods"].toLongLong(), qint64(2000));
+
+		// a new file shows up, the folders that didn't change come from the cache
+		QThread::msleep(10);
+		makeFile(FS::PathCombine(root, "minecraft", "mods", "other.jar"), 500);
+		result = scan(scanner, root, parts);
+		QCOMPARE(result.total, qint64(8900));
+		QCOMPARE(result.parts["mods"].toLongLong(), qint64(2500));
+
+		// a folder goes away
+		QThread::msleep(10);
+		QVERIFY(FS::deletePath(FS::PathCombine(root, "minecraft", "saves", "world")));
+		result = scan(scanner, root, parts);
+		QCOMPARE(result.total, qint64(2900));
+		QCOMPARE(result.parts["worlds"].toLongLong(), qint64(0));
+	}
+
+	void test_fullScan()
+	{
+		QTemporaryDir dir;
+		auto root = FS::PathCombine(dir.path(), "instance");
+		auto log = FS::PathCombine(root, "logs", "latest.log");
+		makeFile(log, 100);
+		DiskUsageScanner scanner(FS::PathCombine(dir.path(), "diskusage.cache"));
+		QCOMPARE(scan(scanner, root).total, qint64(100));
+
+		// growing in place doesn't touch the folder, only a full scan sees it
+		QFile file(log);
+		QVERIFY(file.open(QIODevice::Append));
+		file.write(QByteArray(50, 'y'));
+		file.close();
+		QCOMPARE(scan(scanner, root, {}, true).total, qint64(150));
+	}
+
+	void test_cacheFile()
+	{
+		QTemporaryDir dir;
+		auto root = FS::PathCombine(dir.path(), "instance");
+		auto cache = FS::PathCombine(dir.path(), "diskusage.cache");
+		makeFile(FS::PathCombine(root, "a", "b", "c.txt"), 42);
+		{
+			DiskUsageScanner scanner(cache);
+			QSignalSpy idle(&scanner, SIGNAL(idle()));
+			QCOMPARE(scan(scanner, root).total, qint64(42));
+			QVERIFY(idle.count() || idle.wait(10000));
+		}
+		QVERIFY(QFile::exists(cache));
+		DiskUsageScanner scanner(cache);
+		QCOMPARE(scan(scanner, root).total, qint64(42));
+	}
+
+	void test_missing()
+	{
+		QTemporaryDir dir;
+		DiskUsageScanner scanner(FS::PathCombine(dir.path(), "diskusage.cache"));
+		QCOMPARE(scan(scanner, FS::PathCombine(dir.path(), "nothing")).total, qint64(0));
+	}
+};
+
+QTEST_GUILESS_MAIN(DiskUsageScannerTest)
+
+#include "DiskUsageScanner_test.moc"
@@ -8,6 +8,7 @@
 #include <QDebug>
 #include "tasks/Task.h"
 #include "wonko/WonkoIndex.h"
+#include "TrashBin.h"
 #include <QDebug>
 
 /*
@@ -17,6 +18,7 @@
 Env::Env()
 {
 	m_qnam = std::make_shared<QNetworkAccessManager>();
+	m_trash = std::make_shared<TrashBin>();
 }
 
 void Env::destroy()
@@ -24,6 +26,11 @@ void Env::destroy()
 	m_metacache.reset();
 	m_qnam.reset();
 	m_versionLists.clear();
+	if(m_trash)
+	{
+		m_trash->shutdown();
+		m_trash.reset();
+	}
 }
 
 Env& Env::Env::getInstance()
@@ -43,6 +50,11 @@ std::shared_ptr< QNetworkAccessManager > Env::qnam()
 	return m_qnam;
 }
 
+std::shared_ptr<TrashBin> Env::trash()
+{
+	return m_trash;
+}
+
 std::shared_ptr<IIconList> Env::icons()
 {
 	return m_iconlist;
@@ -12,6 +12,7 @@ class HttpMetaCache;
 class BaseVersionList;
 class BaseVersion;
 class WonkoIndex;
+class TrashBin;
 
 #if defined(ENV)
 	#undef ENV
@@ -35,6 +36,9 @@ public:
 
 	std::shared_ptr<IIconList> icons();
 
+	/// deletes folders in the background
+	std::shared_ptr<TrashBin> trash();
+
 	/// init the cache. FIXME: possible future hook point
 	void initHttpMetaCache();
 
@@ -62,5 +66,6 @@ protected:
 	std::shared_ptr<IIconList> m_iconlist;
 	QMap<QString, std::shared_ptr<BaseVersionList>> m_versionLists;
 	std::shared_ptr<WonkoIndex> m_wonkoIndex;
+	std::shared_ptr<TrashBin> m_trash;
 	QString m_wonkoRootUrl;
 };
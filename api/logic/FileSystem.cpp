@@ -8,6 +8,28 @@
 #include <QDebug>
 #include <QUrl>
 #include <QStandardPaths>
+#include <QMutex>
+#include <QtConcurrentMap>
+#include <atomic>
+
+#if defined Q_OS_LINUX
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#elif defined Q_OS_MAC
+#include <unistd.h>
+#include <sys/clonefile.h>
+#elif defined Q_OS_WIN32
+#include <windows.h>
+#elif defined Q_OS_UNIX
+#include <unistd.h>
+#endif
 
 namespace FS {
 
@@ -78,13 +100,181 @@ bool ensureFolderPathExists(QString foldernamepath)
 	return success;
 }
 
-bool copy::operator()(const QString &offset)
+namespace {
+#if defined Q_OS_LINUX
+bool writeAll(int fd, const char *data, ssize_t size)
 {
-	//NOTE always deep copy on windows. the alternatives are too messy.
-	#if defined Q_OS_WIN32
-	m_followSymlinks = true;
-	#endif
+	while (size > 0)
+	{
+		auto written = ::write(fd, data, size);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		data += written;
+		size -= written;
+	}
+	return true;
+}
 
+bool copyFileContents(const QString &src, const QString &dst, const std::function<void(qint64)> &advance)
+{
+	int in = ::open(QFile::encodeName(src).constData(), O_RDONLY | O_CLOEXEC);
+	if (in < 0)
+		return false;
+	struct stat info;
+	if (::fstat(in, &info) != 0)
+	{
+		::close(in);
+		return false;
+	}
+	// like QFile::copy, never overwrite
+	int out = ::open(QFile::encodeName(dst).constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+	if (out < 0)
+	{
+		::close(in);
+		return false;
+	}
+
+	bool ok = true;
+	// btrfs, xfs and friends can share the data blocks, then nothing is copied at all
+	if (::ioctl(out, FICLONE, in) == 0)
+	{
+		advance(info.st_size);
+	}
+	else
+	{
+		bool byHand = true;
+#if defined __NR_copy_file_range
+		// the kernel copies without the data going through here, and can do server side copies on NFS and SMB
+		byHand = false;
+		qint64 copied = 0;
+		while (true)
+		{
+			auto chunk = ::syscall(__NR_copy_file_range, in, nullptr, out, nullptr, size_t(64 * 1024 * 1024), 0u);
+			if (chunk < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				if (copied == 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP))
+				{
+					byHand = true;
+				}
+				else
+				{
+					ok = false;
+				}
+				break;
+			}
+			if (chunk == 0)
+				break;
+			copied += chunk;
+			advance(chunk);
+		}
+#endif
+		if (byHand)
+		{
+			QByteArray buffer(1024 * 1024, Qt::Uninitialized);
+			while (true)
+			{
+				auto got = ::read(in, buffer.data(), buffer.size());
+				if (got < 0 && errno == EINTR)
+					continue;
+				if (got <= 0)
+				{
+					ok = got == 0;
+					break;
+				}
+				if (!writeAll(out, buffer.constData(), got))
+				{
+					ok = false;
+					break;
+				}
+				advance(got);
+			}
+		}
+	}
+	// same permissions as the original, the umask doesn't apply
+	if (ok && ::fchmod(out, info.st_mode & 07777) != 0)
+		ok = false;
+	::close(in);
+	if (::close(out) != 0)
+		ok = false;
+	if (!ok)
+		::unlink(QFile::encodeName(dst).constData());
+	return ok;
+}
+#else
+bool copyFileContents(const QString &src, const QString &dst, const std::function<void(qint64)> &advance)
+{
+#if defined Q_OS_MAC
+	// APFS can share the data blocks, then nothing is copied at all
+	if (::clonefile(QFile::encodeName(src).constData(), QFile::encodeName(dst).constData(), 0) == 0)
+	{
+		advance(QFileInfo(src).size());
+		return true;
+	}
+#endif
+	if (!QFile::copy(src, dst))
+		return false;
+	advance(QFileInfo(dst).size());
+	return true;
+}
+#endif
+
+bool linkFile(const QString &src, const QString &dst)
+{
+#if defined Q_OS_WIN32
+	return ::CreateHardLinkW((LPCWSTR)QDir::toNativeSeparators(dst).utf16(), (LPCWSTR)QDir::toNativeSeparators(src).utf16(), nullptr);
+#else
+	return ::link(QFile::encodeName(src).constData(), QFile::encodeName(dst).constData()) == 0;
+#endif
+}
+}
+
+bool cloneFile(const QString &src, const QString &dst)
+{
+#if defined Q_OS_LINUX
+	int in = ::open(QFile::encodeName(src).constData(), O_RDONLY | O_CLOEXEC);
+	if (in < 0)
+		return false;
+	struct stat info;
+	if (::fstat(in, &info) != 0)
+	{
+		::close(in);
+		return false;
+	}
+	int out = ::open(QFile::encodeName(dst).constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+	if (out < 0)
+	{
+		::close(in);
+		return false;
+	}
+	bool ok = ::ioctl(out, FICLONE, in) == 0 && ::fchmod(out, info.st_mode & 07777) == 0;
+	::close(in);
+	if (::close(out) != 0)
+		ok = false;
+	if (!ok)
+		::unlink(QFile::encodeName(dst).constData());
+	return ok;
+#elif defined Q_OS_MAC
+	return ::clonefile(QFile::encodeName(src).constData(), QFile::encodeName(dst).constData(), 0) == 0;
+#else
+	Q_UNUSED(src);
+	Q_UNUSED(dst);
+	return false;
+#endif
+}
+
+bool hardlinkFile(const QString &src, const QString &dst)
+{
+	return linkFile(src, dst);
+}
+
+bool copy::plan(const QString &offset, QVector<FileJob> &files)
+{
 	auto src = PathCombine(m_src.absolutePath(), offset);
 	auto dst = PathCombine(m_dst.absolutePath(), offset);
 
@@ -94,7 +284,6 @@ bool copy::operator()(const QString &offset)
 
 	if(!m_followSymlinks && currentSrc.isSymLink())
 	{
-		qDebug() << "creating symlink" << src << " - " << dst;
 		if (!ensureFilePathExists(dst))
 		{
 			qWarning() << "Cannot create path!";
@@ -104,17 +293,18 @@ bool copy::operator()(const QString &offset)
 	}
 	else if(currentSrc.isFile())
 	{
-		qDebug() << "copying file" << src << " - " << dst;
 		if (!ensureFilePathExists(dst))
 		{
 			qWarning() << "Cannot create path!";
 			return false;
 		}
-		return QFile::copy(src, dst);
+		bool link = m_hardlink && m_hardlink->matches(offset);
+		files.append({src, dst, currentSrc.size(), link});
+		m_bytesTotal += currentSrc.size();
+		return true;
 	}
 	else if(currentSrc.isDir())
 	{
-		qDebug() << "recursing" << offset;
 		if (!ensureFolderPathExists(dst))
 		{
 			qWarning() << "Cannot create path!";
@@ -129,7 +319,7 @@ bool copy::operator()(const QString &offset)
 			{
 				continue;
 			}
-			if(!operator()(inner_offset))
+			if(!plan(inner_offset, files))
 			{
 				qWarning() << "Failed to copy" << inner_offset;
 				return false;
@@ -144,6 +334,52 @@ bool copy::operator()(const QString &offset)
 	return true;
 }
 
+bool copy::operator()()
+{
+	//NOTE always deep copy on windows. the alternatives are too messy.
+	#if defined Q_OS_WIN32
+	m_followSymlinks = true;
+	#endif
+
+	m_bytesTotal = 0;
+	QVector<FileJob> files;
+	if (!plan(QString(), files))
+	{
+		return false;
+	}
+
+	qint64 done = 0;
+	std::atomic<bool> failed(false);
+	QMutex progressMutex;
+	auto total = m_bytesTotal;
+	auto &progress = m_progress;
+	auto advance = [&](qint64 bytes)
+	{
+		if (!progress)
+			return;
+		// one at a time, so the numbers only ever go up
+		QMutexLocker locker(&progressMutex);
+		done += bytes;
+		progress(done, total);
+	};
+	QtConcurrent::blockingMap(files, [&](const FileJob &job)
+	{
+		// one failure is enough, don't bother with the rest
+		if (failed)
+			return;
+		if (job.link && linkFile(job.src, job.dst))
+		{
+			advance(job.size);
+			return;
+		}
+		if (!copyFileContents(job.src, job.dst, advance))
+		{
+			qWarning() << "Failed to copy" << job.src << "to" << job.dst;
+			failed = true;
+		}
+	});
+	return !failed;
+}
 
 #if defined Q_OS_WIN32
 #include <windows.h>
@@ -152,6 +388,13 @@ bool copy::operator()(const QString &offset)
 bool deletePath(QString path)
 {
 	bool OK = true;
+#if !defined Q_OS_WIN32
+	// a symlink to a folder is removed, never followed
+	if(QFileInfo(path).isSymLink())
+	{
+		return QFile::remove(path);
+	}
+#endif
 	QDir dir(path);
 
 	if (!dir.exists())
@@ -8,6 +8,8 @@
 #include "multimc_logic_export.h"
 #include <QDir>
 #include <QFlags>
+#include <QVector>
+#include <functional>
 
 namespace FS
 {
@@ -40,6 +42,13 @@ MULTIMC_LOGIC_EXPORT bool ensureFilePathExists(QString filenamepath);
  */
 MULTIMC_LOGIC_EXPORT bool ensureFolderPathExists(QString filenamepath);
 
+/**
+ * Copy a file or a folder with everything in it.
+ *
+ * The whole tree is walked first: folders and symlinks are made right away and the files are
+ * collected. The files are then copied on the thread pool. Where the file system can share data
+ * blocks between files (btrfs, xfs, APFS), nothing is copied at all.
+ */
 class MULTIMC_LOGIC_EXPORT copy
 {
 public:
@@ -59,21 +68,62 @@ public:
 		m_blacklist = filter;
 		return *this;
 	}
-	bool operator()()
+	/**
+	 * Hard link the files that match instead of copying them, where the file system allows it.
+	 * Only for files that are replaced but never changed in place, like mod jars or libraries:
+	 * both copies are the same file afterwards.
+	 */
+	copy & hardlink(const IPathMatcher * filter)
+	{
+		m_hardlink = filter;
+		return *this;
+	}
+	/// Called with the bytes copied so far and the total, from the threads doing the copying
+	copy & progress(std::function<void(qint64, qint64)> callback)
+	{
+		m_progress = callback;
+		return *this;
+	}
+	bool operator()();
+
+	qint64 bytesTotal() const
 	{
-		return operator()(QString());
+		return m_bytesTotal;
 	}
 
+private: /* types */
+	struct FileJob
+	{
+		QString src;
+		QString dst;
+		qint64 size;
+		bool link;
+	};
+
 private:
-	bool operator()(const QString &offset);
+	bool plan(const QString &offset, QVector<FileJob> &files);
 
 private:
 	bool m_followSymlinks = true;
 	const IPathMatcher * m_blacklist = nullptr;
+	const IPathMatcher * m_hardlink = nullptr;
+	std::function<void(qint64, qint64)> m_progress;
+	qint64 m_bytesTotal = 0;
 	QDir m_src;
 	QDir m_dst;
 };
 
+/**
+ * Make dst a copy of src that shares its data blocks with it (btrfs, xfs, APFS).
+ * Nothing is copied where the file system can't do that, it just fails.
+ */
+MULTIMC_LOGIC_EXPORT bool cloneFile(const QString &src, const QString &dst);
+
+/**
+ * Make dst another name for the file src. Both have to be on the same file system.
+ */
+MULTIMC_LOGIC_EXPORT bool hardlinkFile(const QString &src, const QString &dst);
+
 /**
  * Delete a folder recursively
  */
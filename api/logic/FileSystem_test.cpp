@@ -4,6 +4,7 @@
 #include "TestUtil.h"
 
 #include "FileSystem.h"
+#include "pathmatcher/RegexpMatcher.h"
 
 class FileSystemTest : public QObject
 {
@@ -112,6 +113,100 @@ slots:
 		f();
 	}
 
+	void test_copy_progress()
+	{
+		QTemporaryDir source;
+		QDir root(source.path());
+		QVERIFY(root.mkpath("a/b/c"));
+		QVERIFY(root.mkpath("empty"));
+		qint64 expected = 0;
+		for(int i = 0; i < 20; i++)
+		{
+			QByteArray data(i * 100000 + 1, char('a' + i));
+			FS::write(root.absoluteFilePath(QString("a/b/c/file%1").arg(i)), data);
+			expected += data.size();
+		}
+		FS::write(root.absoluteFilePath("top"), "top");
+		expected += 3;
+
+		QTemporaryDir target;
+		auto dst = FS::PathCombine(target.path(), "copy");
+		qint64 lastDone = 0;
+		qint64 lastTotal = 0;
+		bool monotonic = true;
+		FS::copy c(source.path(), dst);
+		c.progress([&](qint64 done, qint64 total)
+		{
+			monotonic &= done >= lastDone;
+			lastDone = done;
+			lastTotal = total;
+		});
+		QVERIFY(c());
+		QVERIFY(monotonic);
+		QCOMPARE(c.bytesTotal(), expected);
+		QCOMPARE(lastTotal, expected);
+		QCOMPARE(lastDone, expected);
+
+		QDir copied(dst);
+		QVERIFY(copied.exists("empty"));
+		for(int i = 0; i < 20; i++)
+		{
+			auto name = QString("a/b/c/file%1").arg(i);
+			QCOMPARE(FS::read(copied.absoluteFilePath(name)), FS::read(root.absoluteFilePath(name)));
+		}
+
+		// never overwrites
+		FS::copy again(source.path(), dst);
+		QVERIFY(!again());
+	}
+
+	void test_copy_hardlink()
+	{
+		QTemporaryDir source;
+		QDir root(source.path());
+		FS::write(root.absoluteFilePath("mods/mod.jar"), "mod");
+		FS::write(root.absoluteFilePath("config/mod.cfg"), "config");
+
+		QTemporaryDir target;
+		auto dst = FS::PathCombine(target.path(), "copy");
+		RegexpMatcher jars(".*\\.jar$");
+		FS::copy c(source.path(), dst);
+		c.hardlink(&jars);
+		QVERIFY(c());
+
+		// the link is the same file, the copy is not
+		QDir copied(dst);
+		{
+			QFile jar(copied.absoluteFilePath("mods/mod.jar"));
+			QVERIFY(jar.open(QIODevice::Append));
+			jar.write("!");
+		}
+		{
+			QFile cfg(copied.absoluteFilePath("config/mod.cfg"));
+			QVERIFY(cfg.open(QIODevice::Append));
+			cfg.write("!");
+		}
+		QCOMPARE(FS::read(root.absoluteFilePath("mods/mod.jar")), QByteArray("mod!"));
+		QCOMPARE(FS::read(root.absoluteFilePath("config/mod.cfg")), QByteArray("config"));
+	}
+
+#if !defined(Q_OS_WIN)
+	void test_deletePath_symlink()
+	{
+		QTemporaryDir tempDir;
+		tempDir.setAutoRemove(true);
+		QDir root(tempDir.path());
+		QVERIFY(root.mkpath("target"));
+		QVERIFY(QFile::copy(QFINDTESTDATA("data/test_folder/pack.mcmeta"), root.absoluteFilePath("target/pack.mcmeta")));
+		QVERIFY(QFile::link(root.absoluteFilePath("target"), root.absoluteFilePath("link")));
+
+		// deleting the link must not touch what it points at
+		QVERIFY(FS::deletePath(root.absoluteFilePath("link")));
+		QVERIFY(!QFileInfo(root.absoluteFilePath("link")).exists());
+		QVERIFY(QFileInfo(root.absoluteFilePath("target/pack.mcmeta")).exists());
+	}
+#endif
+
 	void test_getDesktop()
 	{
 		QCOMPARE(FS::getDesktopDir(), QStandardPaths::writableLocation(QStandardPaths::DesktopLocation));
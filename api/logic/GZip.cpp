@@ -1,6 +1,47 @@
 #include "GZip.h"
 #include <zlib.h>
 #include <QByteArray>
+#include <QtConcurrentMap>
+#include <QtEndian>
+#include <numeric>
+#include <limits>
+
+namespace
+{
+// don't trust the size stored in the gzip trailer beyond this
+const quint32 maxSizeHint = 256 * 1024 * 1024;
+
+// the gzip trailer holds the uncompressed size modulo 2^32 in the last four bytes
+quint32 sizeHint(const QByteArray &compressedBytes)
+{
+	if (compressedBytes.size() < 18)
+	{
+		return 0;
+	}
+	auto hint = qFromLittleEndian<quint32>((const uchar *)compressedBytes.constData() + compressedBytes.size() - 4);
+	return hint <= maxSizeHint ? hint : 0;
+}
+
+template <typename F>
+QVector<bool> runBatch(const QVector<QByteArray> &input, QVector<QByteArray> &output, F function)
+{
+	int count = input.size();
+	output.clear();
+	output.resize(count);
+	QVector<bool> success(count, false);
+	// take the pointers before going parallel, so nothing detaches on the worker threads
+	const QByteArray *in = input.constData();
+	QByteArray *out = output.data();
+	bool *ok = success.data();
+	QVector<int> indexes(count);
+	std::iota(indexes.begin(), indexes.end(), 0);
+	QtConcurrent::blockingMap(indexes, [&](int index)
+	{
+		ok[index] = function(in[index], out[index]);
+	});
+	return success;
+}
+}
 
 bool GZip::unzip(const QByteArray &compressedBytes, QByteArray &uncompressedBytes)
 {
@@ -10,9 +51,12 @@ bool GZip::unzip(const QByteArray &compressedBytes, QByteArray &uncompressedByte
 		return true;
 	}
 
-	unsigned uncompLength = compressedBytes.size();
+	// usually exact, so there is no need to grow the buffer at all
+	unsigned uncompLength = qMax<unsigned>(sizeHint(compressedBytes), compressedBytes.size());
 	uncompressedBytes.clear();
-	uncompressedBytes.resize(uncompLength);
+	// one more byte, so running out of space is always noticed
+	uncompressedBytes.resize(uncompLength + 1);
+	uncompLength++;
 
 	z_stream strm;
 	memset(&strm, 0, sizeof(strm));
@@ -41,7 +85,7 @@ bool GZip::unzip(const QByteArray &compressedBytes, QByteArray &uncompressedByte
 		strm.avail_out = uncompLength - strm.total_out;
 
 		// Inflate another chunk.
-		err = inflate(&strm, Z_SYNC_FLUSH);
+		err = inflate(&strm, Z_NO_FLUSH);
 		if (err == Z_STREAM_END)
 			done = true;
 		else if (err != Z_OK)
@@ -67,10 +111,6 @@ bool GZip::zip(const QByteArray &uncompressedBytes, QByteArray &compressedBytes)
 		return true;
 	}
 
-	unsigned compLength = std::min(uncompressedBytes.size(), 16);
-	compressedBytes.clear();
-	compressedBytes.resize(compLength);
-
 	z_stream zs;
 	memset(&zs, 0, sizeof(zs));
 
@@ -82,34 +122,280 @@ bool GZip::zip(const QByteArray &uncompressedBytes, QByteArray &compressedBytes)
 	zs.next_in = (Bytef*)uncompressedBytes.data();
 	zs.avail_in = uncompressedBytes.size();
 
-	int ret;
-	compressedBytes.resize(uncompressedBytes.size());
+	// big enough for anything, so it all happens in one go
+	compressedBytes.clear();
+	compressedBytes.resize(deflateBound(&zs, uncompressedBytes.size()));
+	zs.next_out = (Bytef *) compressedBytes.data();
+	zs.avail_out = compressedBytes.size();
 
-	unsigned offset = 0;
-	unsigned temp = 0;
-	do
+	int ret = deflate(&zs, Z_FINISH);
+	compressedBytes.resize(zs.total_out);
+
+	if (deflateEnd(&zs) != Z_OK)
+	{
+		return false;
+	}
+
+	if (ret != Z_STREAM_END)
+	{
+		return false;
+	}
+	return true;
+}
+
+QVector<bool> GZip::unzipBatch(const QVector<QByteArray> &compressed, QVector<QByteArray> &uncompressed)
+{
+	return runBatch(compressed, uncompressed, &GZip::unzip);
+}
+
+QVector<bool> GZip::zipBatch(const QVector<QByteArray> &uncompressed, QVector<QByteArray> &compressed)
+{
+	return runBatch(uncompressed, compressed, &GZip::zip);
+}
+
+struct GZipInflateDevice::Private
+{
+	QIODevice *source;
+	QByteArray buffer;
+	z_stream strm;
+	bool initialized = false;
+	bool finished = false;
+};
+
+GZipInflateDevice::GZipInflateDevice(QIODevice *source, int bufferSize, QObject *parent)
+	: QIODevice(parent), d(new Private)
+{
+	d->source = source;
+	d->buffer.resize(bufferSize);
+	memset(&d->strm, 0, sizeof(d->strm));
+}
+
+GZipInflateDevice::~GZipInflateDevice()
+{
+	close();
+}
+
+bool GZipInflateDevice::open(OpenMode mode)
+{
+	if ((mode & ReadWrite) != ReadOnly)
+	{
+		setErrorString(tr("Inflating devices can only be read from."));
+		return false;
+	}
+	memset(&d->strm, 0, sizeof(d->strm));
+	// 47 = detect gzip or zlib headers
+	if (inflateInit2(&d->strm, 47) != Z_OK)
+	{
+		setErrorString(tr("Could not initialize zlib."));
+		return false;
+	}
+	d->initialized = true;
+	d->finished = false;
+	return QIODevice::open(mode | Unbuffered);
+}
+
+void GZipInflateDevice::close()
+{
+	if (d->initialized)
 	{
-		auto remaining = compressedBytes.size() - offset;
-		if(remaining < 1)
+		inflateEnd(&d->strm);
+		d->initialized = false;
+	}
+	QIODevice::close();
+}
+
+bool GZipInflateDevice::isSequential() const
+{
+	return true;
+}
+
+bool GZipInflateDevice::atEnd() const
+{
+	return d->finished && QIODevice::atEnd();
+}
+
+qint64 GZipInflateDevice::readData(char *data, qint64 maxSize)
+{
+	if (!d->initialized || d->finished)
+	{
+		return 0;
+	}
+	auto &strm = d->strm;
+	strm.next_out = (Bytef *)data;
+	strm.avail_out = qMin<qint64>(maxSize, std::numeric_limits<uInt>::max());
+	while (strm.avail_out)
+	{
+		if (strm.avail_in == 0)
+		{
+			auto got = d->source->read(d->buffer.data(), d->buffer.size());
+			if (got < 0)
+			{
+				setErrorString(d->source->errorString());
+				return -1;
+			}
+			if (got == 0)
+			{
+				if (d->source->atEnd() && strm.total_in == 0)
+				{
+					// ended between members, or the source was empty, which is fine
+					d->finished = true;
+					break;
+				}
+				if (d->source->atEnd() && strm.next_out == (Bytef *)data)
+				{
+					setErrorString(tr("Unexpected end of compressed data."));
+					return -1;
+				}
+				// nothing more available right now
+				break;
+			}
+			strm.next_in = (Bytef *)d->buffer.data();
+			strm.avail_in = got;
+		}
+		int ret = inflate(&strm, Z_NO_FLUSH);
+		if (ret == Z_STREAM_END)
+		{
+			// another gzip member may follow
+			if (strm.avail_in == 0 && d->source->atEnd())
+			{
+				d->finished = true;
+				break;
+			}
+			inflateReset(&strm);
+			continue;
+		}
+		if (ret != Z_OK && ret != Z_BUF_ERROR)
 		{
-			compressedBytes.resize(compressedBytes.size() * 2);
+			setErrorString(strm.msg ? QString::fromLatin1(strm.msg) : tr("Invalid compressed data."));
+			return -1;
 		}
-		zs.next_out = (Bytef *) (compressedBytes.data() + offset);
-		temp = zs.avail_out = compressedBytes.size() - offset;
-		ret = deflate(&zs, Z_FINISH);
-		offset += temp - zs.avail_out;
-	} while (ret == Z_OK);
+	}
+	return (char *)strm.next_out - data;
+}
 
-	compressedBytes.resize(offset);
+qint64 GZipInflateDevice::writeData(const char *, qint64)
+{
+	return -1;
+}
 
-	if (deflateEnd(&zs) != Z_OK)
+struct GZipDeflateDevice::Private
+{
+	QIODevice *sink;
+	int level;
+	QByteArray buffer;
+	z_stream strm;
+	bool initialized = false;
+	bool failed = false;
+};
+
+GZipDeflateDevice::GZipDeflateDevice(QIODevice *sink, int level, int bufferSize, QObject *parent)
+	: QIODevice(parent), d(new Private)
+{
+	d->sink = sink;
+	d->level = level;
+	d->buffer.resize(bufferSize);
+	memset(&d->strm, 0, sizeof(d->strm));
+}
+
+GZipDeflateDevice::~GZipDeflateDevice()
+{
+	close();
+}
+
+bool GZipDeflateDevice::open(OpenMode mode)
+{
+	if ((mode & ReadWrite) != WriteOnly)
 	{
+		setErrorString(tr("Deflating devices can only be written to."));
 		return false;
 	}
-
-	if (ret != Z_STREAM_END)
+	memset(&d->strm, 0, sizeof(d->strm));
+	if (deflateInit2(&d->strm, d->level, Z_DEFLATED, (16 + MAX_WBITS), 8, Z_DEFAULT_STRATEGY) != Z_OK)
 	{
+		setErrorString(tr("Could not initialize zlib."));
 		return false;
 	}
+	d->initialized = true;
+	d->failed = false;
+	return QIODevice::open(mode | Unbuffered);
+}
+
+bool GZipDeflateDevice::drain(int flush)
+{
+	auto &strm = d->strm;
+	int ret;
+	do
+	{
+		strm.next_out = (Bytef *)d->buffer.data();
+		strm.avail_out = d->buffer.size();
+		ret = deflate(&strm, flush);
+		if (ret == Z_STREAM_ERROR)
+		{
+			setErrorString(tr("Could not compress data."));
+			return false;
+		}
+		qint64 have = d->buffer.size() - strm.avail_out;
+		if (have && d->sink->write(d->buffer.constData(), have) != have)
+		{
+			setErrorString(d->sink->errorString());
+			return false;
+		}
+		// deflate filled the whole buffer, there may be more
+	} while (strm.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
 	return true;
-}
\ No newline at end of file
+}
+
+qint64 GZipDeflateDevice::writeData(const char *data, qint64 maxSize)
+{
+	if (!d->initialized || d->failed)
+	{
+		return -1;
+	}
+	auto &strm = d->strm;
+	qint64 done = 0;
+	while (done < maxSize)
+	{
+		auto chunk = qMin<qint64>(maxSize - done, std::numeric_limits<uInt>::max());
+		strm.next_in = (Bytef *)(data + done);
+		strm.avail_in = chunk;
+		if (!drain(Z_NO_FLUSH))
+		{
+			d->failed = true;
+			return -1;
+		}
+		done += chunk;
+	}
+	return done;
+}
+
+bool GZipDeflateDevice::finish()
+{
+	if (!d->initialized)
+	{
+		return !d->failed;
+	}
+	bool ok = !d->failed && drain(Z_FINISH);
+	deflateEnd(&d->strm);
+	d->initialized = false;
+	d->failed = !ok;
+	return ok;
+}
+
+void GZipDeflateDevice::close()
+{
+	if (isOpen())
+	{
+		finish();
+	}
+	QIODevice::close();
+}
+
+bool GZipDeflateDevice::isSequential() const
+{
+	return true;
+}
+
+qint64 GZipDeflateDevice::readData(char *, qint64)
+{
+	return -1;
+}
@@ -1,5 +1,8 @@
 #pragma once
 #include <QByteArray>
+#include <QIODevice>
+#include <QVector>
+#include <memory>
 
 #include "multimc_logic_export.h"
 
@@ -8,5 +11,70 @@ class MULTIMC_LOGIC_EXPORT GZip
 public:
 	static bool unzip(const QByteArray &compressedBytes, QByteArray &uncompressedBytes);
 	static bool zip(const QByteArray &uncompressedBytes, QByteArray &compressedBytes);
+
+	/**
+	 * Unzip or zip many independent blobs at once, spread over the global thread pool.
+	 * The output has the same order as the input. Returns which of the blobs succeeded.
+	 */
+	static QVector<bool> unzipBatch(const QVector<QByteArray> &compressed, QVector<QByteArray> &uncompressed);
+	static QVector<bool> zipBatch(const QVector<QByteArray> &uncompressed, QVector<QByteArray> &compressed);
+};
+
+/**
+ * Sequential, read-only device that inflates gzip data read from another device.
+ *
+ * Only a fixed size input buffer is held, the output goes straight into the buffer given to read().
+ * Concatenated gzip members are read one after another, like gzip itself does.
+ */
+class MULTIMC_LOGIC_EXPORT GZipInflateDevice : public QIODevice
+{
+	Q_OBJECT
+public:
+	/// source has to be open for reading and stay alive while this device is used
+	explicit GZipInflateDevice(QIODevice *source, int bufferSize = 64 * 1024, QObject *parent = nullptr);
+	virtual ~GZipInflateDevice();
+
+	bool open(OpenMode mode) override;
+	void close() override;
+	bool isSequential() const override;
+	bool atEnd() const override;
+
+protected:
+	qint64 readData(char *data, qint64 maxSize) override;
+	qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+	struct Private;
+	std::unique_ptr<Private> d;
 };
 
+/**
+ * Sequential, write-only device that deflates everything written to it into another device, as gzip.
+ *
+ * Only a fixed size output buffer is held. The gzip trailer is written by finish() or close().
+ */
+class MULTIMC_LOGIC_EXPORT GZipDeflateDevice : public QIODevice
+{
+	Q_OBJECT
+public:
+	/// sink has to be open for writing and stay alive while this device is used
+	explicit GZipDeflateDevice(QIODevice *sink, int level = -1, int bufferSize = 64 * 1024, QObject *parent = nullptr);
+	virtual ~GZipDeflateDevice();
+
+	bool open(OpenMode mode) override;
+	/// flush everything and write the gzip trailer, returns false if that fails
+	bool finish();
+	void close() override;
+	bool isSequential() const override;
+
+protected:
+	qint64 readData(char *data, qint64 maxSize) override;
+	qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+	bool drain(int flush);
+
+private:
+	struct Private;
+	std::unique_ptr<Private> d;
+};
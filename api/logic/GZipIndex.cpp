@@ -0,0 +1,214 @@
+#include "GZipIndex.h"
+#include <zlib.h>
+#include <cstring>
+#include <algorithm>
+
+// this follows the approach of zran.c from the zlib examples
+
+namespace
+{
+const int windowSize = 32768;
+// uncompressed distance between checkpoints
+const qint64 checkpointSpan = 2 * 1024 * 1024;
+// zlib counts in unsigned ints, feed it big files in pieces
+const qint64 inputChunk = 1 << 30;
+}
+
+bool GZipIndex::build(const char *data, qint64 size, std::function<bool(const char *, int)> consumer)
+{
+	m_data = data;
+	m_size = size;
+	m_uncompressedSize = 0;
+	m_checkpoints.clear();
+
+	z_stream strm;
+	memset(&strm, 0, sizeof(strm));
+	// 47 = detect gzip or zlib headers
+	if (inflateInit2(&strm, 47) != Z_OK)
+	{
+		return false;
+	}
+	unsigned char window[windowSize];
+	qint64 totalIn = 0;
+	qint64 totalOut = 0;
+	qint64 last = 0;
+	qint64 fed = 0;
+	int ret = Z_OK;
+	strm.avail_out = 0;
+	do
+	{
+		if (strm.avail_in == 0)
+		{
+			if (fed == size)
+			{
+				// truncated
+				ret = Z_DATA_ERROR;
+				break;
+			}
+			qint64 chunk = qMin(inputChunk, size - fed);
+			strm.next_in = (Bytef *)(data + fed);
+			strm.avail_in = chunk;
+			fed += chunk;
+		}
+		if (strm.avail_out == 0)
+		{
+			strm.avail_out = windowSize;
+			strm.next_out = window;
+		}
+		auto outBefore = strm.next_out;
+		totalIn += strm.avail_in;
+		totalOut += strm.avail_out;
+		ret = inflate(&strm, Z_BLOCK);
+		totalIn -= strm.avail_in;
+		totalOut -= strm.avail_out;
+		if (ret == Z_NEED_DICT)
+		{
+			ret = Z_DATA_ERROR;
+		}
+		if (ret == Z_MEM_ERROR || ret == Z_DATA_ERROR)
+		{
+			break;
+		}
+		if (consumer && strm.next_out != outBefore && !consumer((const char *)outBefore, strm.next_out - outBefore))
+		{
+			ret = Z_DATA_ERROR;
+			break;
+		}
+		if (ret == Z_STREAM_END)
+		{
+			break;
+		}
+		// at the end of a deflate block header, but not the last one
+		if ((strm.data_type & 128) && !(strm.data_type & 64) && (totalOut == 0 || totalOut - last > checkpointSpan))
+		{
+			Checkpoint point;
+			point.out = totalOut;
+			point.in = totalIn;
+			point.bits = strm.data_type & 7;
+			point.window.resize(windowSize);
+			// the window is circular, the oldest output starts where the next output goes
+			int left = strm.avail_out;
+			if (left)
+			{
+				memcpy(point.window.data(), window + windowSize - left, left);
+			}
+			if (left < windowSize)
+			{
+				memcpy(point.window.data() + left, window, windowSize - left);
+			}
+			m_checkpoints.append(point);
+			last = totalOut;
+		}
+	} while (true);
+	inflateEnd(&strm);
+	if (ret != Z_STREAM_END)
+	{
+		m_checkpoints.clear();
+		return false;
+	}
+	m_uncompressedSize = totalOut;
+	return true;
+}
+
+qint64 GZipIndex::uncompressedSize() const
+{
+	return m_uncompressedSize;
+}
+
+void GZipIndex::span(qint64 offset, qint64 &start, qint64 &end) const
+{
+	// the first checkpoint after offset
+	auto next = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), offset, [](qint64 offset, const Checkpoint &point)
+	{
+		return offset < point.out;
+	});
+	start = next == m_checkpoints.begin() ? 0 : (next - 1)->out;
+	end = next == m_checkpoints.end() ? m_uncompressedSize : next->out;
+}
+
+bool GZipIndex::read(qint64 offset, qint64 length, QByteArray &out) const
+{
+	out.clear();
+	if (offset < 0 || length <= 0 || offset >= m_uncompressedSize)
+	{
+		return offset >= 0 && length >= 0;
+	}
+	length = qMin(length, m_uncompressedSize - offset);
+	if (m_checkpoints.isEmpty())
+	{
+		return false;
+	}
+	// the last checkpoint at or before offset
+	int index = 0;
+	while (index + 1 < m_checkpoints.size() && m_checkpoints[index + 1].out <= offset)
+	{
+		index++;
+	}
+	auto &point = m_checkpoints[index];
+
+	z_stream strm;
+	memset(&strm, 0, sizeof(strm));
+	if (inflateInit2(&strm, -15) != Z_OK)
+	{
+		return false;
+	}
+	qint64 fed = point.in;
+	if (point.bits)
+	{
+		// the checkpoint is in the middle of a byte, feed the remaining bits of it first
+		int ret = inflatePrime(&strm, point.bits, ((unsigned char)m_data[point.in - 1]) >> (8 - point.bits));
+		if (ret != Z_OK)
+		{
+			inflateEnd(&strm);
+			return false;
+		}
+	}
+	inflateSetDictionary(&strm, (const Bytef *)point.window.constData(), windowSize);
+
+	out.resize(length);
+	qint64 skip = offset - point.out;
+	unsigned char discard[windowSize];
+	qint64 produced = 0;
+	int ret = Z_OK;
+	while (produced < length)
+	{
+		if (strm.avail_in == 0)
+		{
+			if (fed == m_size)
+			{
+				break;
+			}
+			qint64 chunk = qMin(inputChunk, m_size - fed);
+			strm.next_in = (Bytef *)(m_data + fed);
+			strm.avail_in = chunk;
+			fed += chunk;
+		}
+		if (skip)
+		{
+			strm.next_out = discard;
+			strm.avail_out = qMin<qint64>(skip, windowSize);
+			auto before = strm.avail_out;
+			ret = inflate(&strm, Z_NO_FLUSH);
+			skip -= before - strm.avail_out;
+		}
+		else
+		{
+			strm.next_out = (Bytef *)(out.data() + produced);
+			strm.avail_out = qMin<qint64>(length - produced, inputChunk);
+			auto before = strm.avail_out;
+			ret = inflate(&strm, Z_NO_FLUSH);
+			produced += before - strm.avail_out;
+		}
+		if (ret == Z_NEED_DICT || ret == Z_MEM_ERROR || ret == Z_DATA_ERROR || ret == Z_STREAM_END)
+		{
+			break;
+		}
+	}
+	inflateEnd(&strm);
+	if (produced != length)
+	{
+		out.clear();
+		return false;
+	}
+	return true;
+}
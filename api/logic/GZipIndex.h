@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+#include <functional>
+
+#include "multimc_logic_export.h"
+
+/**
+ * Random access into gzip compressed data.
+ *
+ * Building the index inflates the data once and remembers a checkpoint every few megabytes:
+ * where the deflate block starts and the 32KiB of output before it. Reading from any offset
+ * then only inflates from the nearest checkpoint, instead of from the start.
+ *
+ * The compressed data is not copied and has to stay valid while the index is used.
+ */
+class MULTIMC_LOGIC_EXPORT GZipIndex
+{
+public:
+	/**
+	 * Index the compressed data. consumer is called with every piece of inflated output, in order.
+	 * Return false from the consumer to stop. Returns false if the data is not valid or indexing was stopped.
+	 */
+	bool build(const char *data, qint64 size, std::function<bool(const char *, int)> consumer = nullptr);
+
+	qint64 uncompressedSize() const;
+
+	/// inflate length bytes, starting at offset of the uncompressed data
+	bool read(qint64 offset, qint64 length, QByteArray &out) const;
+
+	/**
+	 * The stretch of uncompressed data between the checkpoints around offset.
+	 * Reading anything in it inflates from start, so it pays to read as much of it at once as is useful.
+	 */
+	void span(qint64 offset, qint64 &start, qint64 &end) const;
+
+private:
+	struct Checkpoint
+	{
+		qint64 out;
+		qint64 in;
+		int bits;
+		QByteArray window;
+	};
+	const char *m_data = nullptr;
+	qint64 m_size = 0;
+	qint64 m_uncompressedSize = 0;
+	QVector<Checkpoint> m_checkpoints;
+};
@@ -2,8 +2,85 @@
 #include "TestUtil.h"
 
 #include "GZip.h"
+#include <QBuffer>
 #include <random>
 
+QByteArray randomBytes(int size)
+{
+	std::default_random_engine eng(size);
+	std::uniform_int_distribution<uint8_t> idis(0, std::numeric_limits<uint8_t>::max());
+	QByteArray out;
+	out.reserve(size);
+	for(int i = 0; i < size; i++)
+	{
+		out.append((char)idis(eng));
+	}
+	return out;
+}
+
+// something that compresses about as well as a log or a level.dat
+QByteArray textBytes(int size)
+{
+	QByteArray out;
+	out.reserve(size + 64);
+	int line = 0;
+	while(out.size() < size)
+	{
+		out += "[12:34:56] [Client thread/INFO]: Line number " + QByteArray::number(line++) + "\n";
+	}
+	out.resize(size);
+	return out;
+}
+
+QByteArray deflateThroughDevice(const QByteArray &data, int chunk)
+{
+	QByteArray compressed;
+	QBuffer sink(&compressed);
+	sink.open(QIODevice::WriteOnly);
+	GZipDeflateDevice dev(&sink, -1, 4096);
+	if(!dev.open(QIODevice::WriteOnly))
+	{
+		return QByteArray();
+	}
+	for(int i = 0; i < data.size(); i += chunk)
+	{
+		auto len = qMin(chunk, data.size() - i);
+		if(dev.write(data.constData() + i, len) != len)
+		{
+			return QByteArray();
+		}
+	}
+	if(!dev.finish())
+	{
+		return QByteArray();
+	}
+	return compressed;
+}
+
+bool inflateThroughDevice(const QByteArray &compressed, int chunk, QByteArray &out)
+{
+	QByteArray input = compressed;
+	QBuffer source(&input);
+	source.open(QIODevice::ReadOnly);
+	GZipInflateDevice dev(&source, 4096);
+	if(!dev.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+	out.clear();
+	QByteArray buffer(chunk, Qt::Uninitialized);
+	while(!dev.atEnd())
+	{
+		auto got = dev.read(buffer.data(), chunk);
+		if(got < 0)
+		{
+			return false;
+		}
+		out.append(buffer.constData(), got);
+	}
+	return true;
+}
+
 void fib(int &prev, int &cur)
 {
 	auto ret = prev + cur;
@@ -50,6 +127,163 @@ slots:
 			fib(prev, cur);
 		} while (cur < size);
 	}
+
+	void test_Devices_data()
+	{
+		QTest::addColumn<QByteArray>("data");
+		QTest::addColumn<int>("chunk");
+		QTest::newRow("empty") << QByteArray() << 100;
+		QTest::newRow("tiny") << QByteArray("x") << 1;
+		QTest::newRow("random, small chunks") << randomBytes(100000) << 333;
+		QTest::newRow("random, large chunks") << randomBytes(1000000) << 100000;
+		QTest::newRow("text, small chunks") << textBytes(1000000) << 17;
+		QTest::newRow("text, large chunks") << textBytes(3000000) << 1000000;
+	}
+	void test_Devices()
+	{
+		QFETCH(QByteArray, data);
+		QFETCH(int, chunk);
+
+		// device to memory, memory to device
+		auto compressed = deflateThroughDevice(data, chunk);
+		QVERIFY(!compressed.isEmpty());
+		QByteArray decompressed;
+		QVERIFY(GZip::unzip(compressed, decompressed));
+		QCOMPARE(decompressed, data);
+
+		QVERIFY(GZip::zip(data, compressed));
+		QVERIFY(inflateThroughDevice(compressed, chunk, decompressed));
+		QCOMPARE(decompressed, data);
+	}
+
+	void test_InflateMultipleMembers()
+	{
+		auto first = textBytes(50000);
+		auto second = randomBytes(20000);
+		QByteArray a, b;
+		QVERIFY(GZip::zip(first, a));
+		QVERIFY(GZip::zip(second, b));
+		QByteArray decompressed;
+		QVERIFY(inflateThroughDevice(a + b, 1000, decompressed));
+		QCOMPARE(decompressed, first + second);
+	}
+
+	void test_InflateTruncated()
+	{
+		QByteArray compressed;
+		QVERIFY(GZip::zip(randomBytes(100000), compressed));
+		compressed.chop(1000);
+		QByteArray decompressed;
+		QVERIFY(!inflateThroughDevice(compressed, 1000, decompressed));
+	}
+
+	void test_Batch()
+	{
+		QVector<QByteArray> inputs;
+		for(int i = 0; i < 50; i++)
+		{
+			inputs.append(i % 2 ? textBytes(i * 1000) : randomBytes(i * 1000));
+		}
+		QVector<QByteArray> compressed;
+		auto zipped = GZip::zipBatch(inputs, compressed);
+		QCOMPARE(zipped.size(), inputs.size());
+		QCOMPARE(compressed.size(), inputs.size());
+		QVERIFY(!zipped.contains(false));
+
+		// one broken blob does not affect the others
+		compressed[7] = "not gzip";
+		QVector<QByteArray> decompressed;
+		auto unzipped = GZip::unzipBatch(compressed, decompressed);
+		QCOMPARE(unzipped.size(), inputs.size());
+		for(int i = 0; i < inputs.size(); i++)
+		{
+			if(i == 7)
+			{
+				QVERIFY(!unzipped[i]);
+				continue;
+			}
+			QVERIFY(unzipped[i]);
+			QCOMPARE(decompressed[i], inputs[i]);
+		}
+	}
+
+	void bench_Zip()
+	{
+		auto data = textBytes(8 * 1024 * 1024);
+		QByteArray compressed;
+		QBENCHMARK
+		{
+			GZip::zip(data, compressed);
+		}
+	}
+
+	void bench_Unzip()
+	{
+		auto data = textBytes(8 * 1024 * 1024);
+		QByteArray compressed;
+		QByteArray decompressed;
+		GZip::zip(data, compressed);
+		QBENCHMARK
+		{
+			GZip::unzip(compressed, decompressed);
+		}
+	}
+
+	void bench_DeflateDevice()
+	{
+		auto data = textBytes(8 * 1024 * 1024);
+		QBENCHMARK
+		{
+			deflateThroughDevice(data, 64 * 1024);
+		}
+	}
+
+	void bench_InflateDevice()
+	{
+		auto data = textBytes(8 * 1024 * 1024);
+		QByteArray compressed;
+		QByteArray decompressed;
+		GZip::zip(data, compressed);
+		QBENCHMARK
+		{
+			inflateThroughDevice(compressed, 64 * 1024, decompressed);
+		}
+	}
+
+	void bench_UnzipMany_data()
+	{
+		QTest::addColumn<bool>("batch");
+		QTest::newRow("serial") << false;
+		QTest::newRow("batch") << true;
+	}
+	void bench_UnzipMany()
+	{
+		QFETCH(bool, batch);
+		// about what a big instance folder full of worlds looks like
+		QVector<QByteArray> compressed;
+		for(int i = 0; i < 200; i++)
+		{
+			QByteArray blob;
+			GZip::zip(textBytes(64 * 1024 + i * 100), blob);
+			compressed.append(blob);
+		}
+		QVector<QByteArray> decompressed;
+		QBENCHMARK
+		{
+			if(batch)
+			{
+				GZip::unzipBatch(compressed, decompressed);
+			}
+			else
+			{
+				decompressed.resize(compressed.size());
+				for(int i = 0; i < compressed.size(); i++)
+				{
+					GZip::unzip(compressed[i], decompressed[i]);
+				}
+			}
+		}
+	}
 };
 
 QTEST_GUILESS_MAIN(GZipTest)
@@ -0,0 +1,57 @@
+#include "InstanceCopyTask.h"
+#include "FileSystem.h"
+#include "Env.h"
+#include "TrashBin.h"
+#include "pathmatcher/RegexpMatcher.h"
+
+#include <QtConcurrentRun>
+
+InstanceCopyTask::InstanceCopyTask(InstancePtr original, const QString &instDir, bool copySaves, bool linkFiles, QObject *parent)
+	: Task(parent), m_original(original), m_instDir(instDir)
+{
+	if(!copySaves)
+	{
+		auto matcherReal = new RegexpMatcher("[.]?minecraft/saves");
+		matcherReal->caseSensitive(false);
+		m_blacklist.reset(matcherReal);
+	}
+	if(linkFiles)
+	{
+		// only what gets replaced when it changes, never written to in place
+		m_hardlink.reset(new RegexpMatcher("^([.]?minecraft/(mods|coremods)|libraries)/"));
+	}
+	connect(&m_watcher, &QFutureWatcher<bool>::finished, this, &InstanceCopyTask::copyFinished);
+}
+
+InstanceCopyTask::~InstanceCopyTask()
+{
+	m_watcher.waitForFinished();
+}
+
+void InstanceCopyTask::executeTask()
+{
+	setStatus(tr("Copying instance %1").arg(m_original->name()));
+	m_watcher.setFuture(QtConcurrent::run(this, &InstanceCopyTask::run));
+}
+
+bool InstanceCopyTask::run()
+{
+	FS::copy folderCopy(m_original->instanceRoot(), m_instDir);
+	folderCopy.followSymlinks(false).blacklist(m_blacklist.get()).hardlink(m_hardlink.get());
+	folderCopy.progress([this](qint64 current, qint64 total)
+	{
+		QMetaObject::invokeMethod(this, "setProgress", Qt::QueuedConnection, Q_ARG(qint64, current), Q_ARG(qint64, total));
+	});
+	return folderCopy();
+}
+
+void InstanceCopyTask::copyFinished()
+{
+	if(!m_watcher.result())
+	{
+		ENV.trash()->moveToTrash(m_instDir);
+		emitFailed(tr("Failed to copy the instance folder."));
+		return;
+	}
+	emitSucceeded();
+}
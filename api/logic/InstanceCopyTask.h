@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QString>
+#include <QFutureWatcher>
+#include <memory>
+
+#include "tasks/Task.h"
+#include "BaseInstance.h"
+#include "pathmatcher/IPathMatcher.h"
+
+#include "multimc_logic_export.h"
+
+/**
+ * Copies the folder of an instance for InstanceList::copyInstance, on the thread pool, with the bytes copied as progress.
+ *
+ * Saves can be left out. Mods, core mods and libraries can be hard linked instead of copied where the file system
+ * allows it, which is opt-in: the two instances then share those files until one of them replaces them.
+ * If the copy fails, whatever made it to the new folder goes to the trash.
+ */
+class MULTIMC_LOGIC_EXPORT InstanceCopyTask : public Task
+{
+	Q_OBJECT
+public:
+	InstanceCopyTask(InstancePtr original, const QString &instDir, bool copySaves, bool linkFiles, QObject *parent = nullptr);
+	virtual ~InstanceCopyTask();
+
+protected:
+	virtual void executeTask() override;
+
+private slots:
+	void copyFinished();
+
+private:
+	bool run();
+
+private:
+	InstancePtr m_original;
+	QString m_instDir;
+	std::unique_ptr<IPathMatcher> m_blacklist;
+	std::unique_ptr<IPathMatcher> m_hardlink;
+	QFutureWatcher<bool> m_watcher;
+};
@@ -0,0 +1,71 @@
+#include "InstanceIndex.h"
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+namespace
+{
+const quint32 indexMagic = 0x4D4D4349; // MMCI
+const quint32 indexVersion = 1;
+}
+
+bool InstanceIndex::read(const QString &path, QVector<Entry> &entries)
+{
+	entries.clear();
+	QFile file(path);
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_0);
+	quint32 magic = 0, version = 0, count = 0;
+	in >> magic >> version >> count;
+	if(in.status() != QDataStream::Ok || magic != indexMagic || version != indexVersion)
+	{
+		return false;
+	}
+	// don't trust the count with the allocation, a damaged file ends the loop soon enough
+	entries.reserve(qMin<quint32>(count, 100000));
+	for(quint32 i = 0; i < count; i++)
+	{
+		Entry entry;
+		QMap<QString, QVariant> &config = entry.config;
+		in >> entry.id >> entry.modified >> entry.size >> config;
+		if(in.status() != QDataStream::Ok)
+		{
+			entries.clear();
+			return false;
+		}
+		entries.append(entry);
+	}
+	return true;
+}
+
+bool InstanceIndex::write(const QString &path, const QVector<Entry> &entries)
+{
+	QSaveFile file(path);
+	if(!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_0);
+	out << indexMagic << indexVersion << quint32(entries.size());
+	for(auto & entry: entries)
+	{
+		const QMap<QString, QVariant> &config = entry.config;
+		out << entry.id << entry.modified << entry.size << config;
+	}
+	if(out.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return false;
+	}
+	return file.commit();
+}
+
+bool InstanceIndex::isCurrent(const Entry &entry, const Entry &onDisk)
+{
+	return entry.modified == onDisk.modified && entry.size == onDisk.size;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include "settings/INIFile.h"
+
+#include "multimc_logic_export.h"
+
+/**
+ * The instances.idx file in the instance folder.
+ *
+ * It holds the parsed instance.cfg of every instance, together with the time and size the file had,
+ * in one file. The configuration covers everything the main window shows (name, icon, type,
+ * last launch time), the id is the folder name and groups come from instgroups.json.
+ * Reading one file is much faster than opening every instance.cfg, especially on a network share.
+ */
+class MULTIMC_LOGIC_EXPORT InstanceIndex
+{
+public:
+	struct Entry
+	{
+		/// instance folder name, which is also its id
+		QString id;
+		/// full path of the instance folder, not stored in the index
+		QString instDir;
+		/// of instance.cfg, in ms since the epoch
+		qint64 modified = 0;
+		qint64 size = 0;
+		INIFile config;
+	};
+
+	/// Reads the index. Returns false if it is missing, damaged or from a different version.
+	static bool read(const QString &path, QVector<Entry> &entries);
+	static bool write(const QString &path, const QVector<Entry> &entries);
+
+	/// True if the entry was made from the instance.cfg that is on disk now, going by the time and size it had
+	static bool isCurrent(const Entry &entry, const Entry &onDisk);
+};
@@ -0,0 +1,96 @@
+#include <QTest>
+#include <QTemporaryDir>
+
+#include "InstanceIndex.h"
+#include "FileSystem.h"
+
+class InstanceIndexTest : public QObject
+{
+	Q_OBJECT
+
+	static InstanceIndex::Entry entry(const QString &id, qint64 modified)
+	{
+		InstanceIndex::Entry entry;
+		entry.id = id;
+		entry.modified = modified;
+		entry.size = id.size() * 10;
+		entry.config["InstanceType"] = "OneSix";
+		entry.config["name"] = "Instance " + id;
+		entry.config["iconKey"] = "flame";
+		entry.config["lastLaunchTime"] = modified * 2;
+		return entry;
+	}
+
+private
+slots:
+	void test_roundTrip()
+	{
+		QTemporaryDir dir;
+		auto path = FS::PathCombine(dir.path(), "instances.idx");
+
+		QVector<InstanceIndex::Entry> written;
+		for(int i = 0; i < 100; i++)
+		{
+			written.append(entry(QString("instance%1").arg(i), 1000 + i));
+		}
+		QVERIFY(InstanceIndex::write(path, written));
+
+		QVector<InstanceIndex::Entry> read;
+		QVERIFY(InstanceIndex::read(path, read));
+		QCOMPARE(read.size(), written.size());
+		for(int i = 0; i < read.size(); i++)
+		{
+			QCOMPARE(read[i].id, written[i].id);
+			QCOMPARE(read[i].modified, written[i].modified);
+			QCOMPARE(read[i].size, written[i].size);
+			QCOMPARE(read[i].config.get("name", QVariant()), written[i].config.get("name", QVariant()));
+			QCOMPARE(read[i].config.get("lastLaunchTime", QVariant()).toLongLong(), written[i].modified * 2);
+			QVERIFY(InstanceIndex::isCurrent(read[i], written[i]));
+		}
+	}
+
+	void test_isCurrent()
+	{
+		auto indexed = entry("a", 1000);
+		auto onDisk = indexed;
+		QVERIFY(InstanceIndex::isCurrent(indexed, onDisk));
+		onDisk.modified++;
+		QVERIFY(!InstanceIndex::isCurrent(indexed, onDisk));
+		onDisk = indexed;
+		onDisk.size++;
+		QVERIFY(!InstanceIndex::isCurrent(indexed, onDisk));
+	}
+
+	void test_missing()
+	{
+		QTemporaryDir dir;
+		QVector<InstanceIndex::Entry> read;
+		QVERIFY(!InstanceIndex::read(FS::PathCombine(dir.path(), "instances.idx"), read));
+		QVERIFY(read.isEmpty());
+	}
+
+	void test_damaged()
+	{
+		QTemporaryDir dir;
+		auto path = FS::PathCombine(dir.path(), "instances.idx");
+		QVector<InstanceIndex::Entry> written = {entry("a", 1), entry("b", 2), entry("c", 3)};
+		QVERIFY(InstanceIndex::write(path, written));
+
+		// cut off in the middle of an entry
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::ReadWrite));
+		QVERIFY(file.resize(file.size() - 10));
+		file.close();
+		QVector<InstanceIndex::Entry> read;
+		QVERIFY(!InstanceIndex::read(path, read));
+		QVERIFY(read.isEmpty());
+
+		// not an index at all
+		FS::write(path, "[General]\nname=whatever\n");
+		QVERIFY(!InstanceIndex::read(path, read));
+	}
+};
+
+QTEST_GUILESS_MAIN(InstanceIndexTest)
+
+#include "InstanceIndex_test.moc"
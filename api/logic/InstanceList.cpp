@@ -25,8 +25,13 @@
 #include <QXmlStreamReader>
 #include <QRegularExpression>
 #include <QDebug>
+#include <QDateTime>
+#include <QtConcurrentRun>
+#include <QtConcurrentMap>
+#include <algorithm>
 
 #include "InstanceList.h"
+#include "DiskUsageScanner.h"
 #include "BaseInstance.h"
 
 //FIXME: this really doesn't belong *here*
@@ -37,7 +42,8 @@
 #include "settings/INISettingsObject.h"
 #include "NullInstance.h"
 #include "FileSystem.h"
-#include "pathmatcher/RegexpMatcher.h"
+#include "Env.h"
+#include "TrashBin.h"
 
 const static int GROUP_FILE_FORMAT_VERSION = 1;
 
@@ -49,6 +55,7 @@ InstanceList::InstanceList(SettingsObjectPtr globalSettings, const QString &inst
 	{
 		QDir::current().mkpath(m_instDir);
 	}
+	resetDiskUsage();
 }
 
 InstanceList::~InstanceList()
@@ -75,7 +82,12 @@ QVariant InstanceList::data(const QModelIndex &index, int role) const
 	{
 		return QVariant();
 	}
-	BaseInstance *pdata = static_cast<BaseInstance *>(index.internalPointer());
+	// by row, the instance in a row can be replaced by a reload
+	if (index.row() < 0 || index.row() >= m_instances.size())
+	{
+		return QVariant();
+	}
+	BaseInstance *pdata = m_instances.at(index.row()).get();
 	switch (role)
 	{
 	case InstancePointerRole:
@@ -104,6 +116,24 @@ QVariant InstanceList::data(const QModelIndex &index, int role) const
 	{
 		return pdata->group();
 	}
+	case DiskUsageRole:
+	{
+		auto iter = m_diskUsage.find(pdata->id());
+		if (iter == m_diskUsage.end())
+		{
+			return QVariant();
+		}
+		return iter->first;
+	}
+	case DiskUsagePartsRole:
+	{
+		auto iter = m_diskUsage.find(pdata->id());
+		if (iter == m_diskUsage.end())
+		{
+			return QVariant();
+		}
+		return iter->second;
+	}
 	default:
 		break;
 	}
@@ -122,6 +152,11 @@ Qt::ItemFlags InstanceList::flags(const QModelIndex &index) const
 
 void InstanceList::groupChanged()
 {
+	auto inst = qobject_cast<BaseInstance *>(sender());
+	if(inst)
+	{
+		trackGroup(inst->id(), inst->group());
+	}
 	// save the groups. save all of them.
 	saveGroupList();
 }
@@ -131,6 +166,41 @@ QStringList InstanceList::getGroups()
 	return m_groups.toList();
 }
 
+QSet<QString> InstanceList::getGroupMembers(const QString &group) const
+{
+	return m_groupMembers.value(group);
+}
+
+void InstanceList::trackGroup(const QString &id, const QString &group)
+{
+	untrackGroup(id);
+	if(group.isEmpty())
+	{
+		return;
+	}
+	m_instanceGroups.insert(id, group);
+	m_groupMembers[group].insert(id);
+}
+
+void InstanceList::untrackGroup(const QString &id)
+{
+	auto iter = m_instanceGroups.find(id);
+	if(iter == m_instanceGroups.end())
+	{
+		return;
+	}
+	auto members = m_groupMembers.find(*iter);
+	if(members != m_groupMembers.end())
+	{
+		members->remove(id);
+		if(members->isEmpty())
+		{
+			m_groupMembers.erase(members);
+		}
+	}
+	m_instanceGroups.erase(iter);
+}
+
 void InstanceList::suspendGroupSaving()
 {
 	suspendedGroupSave = true;
@@ -150,10 +220,12 @@ void InstanceList::resumeGroupSaving()
 
 void InstanceList::deleteGroup(const QString& name)
 {
-	for(auto & instance: m_instances)
+	// copy, the members change as we go
+	auto members = m_groupMembers.value(name);
+	for(auto & id: members)
 	{
-		auto instGroupName = instance->group();
-		if(instGroupName == name)
+		auto instance = getInstanceById(id);
+		if(instance)
 		{
 			instance->setGroupPost(QString());
 		}
@@ -169,28 +241,13 @@ void InstanceList::saveGroupList()
 	}
 
 	QString groupFileName = m_instDir + "/instgroups.json";
+	// sorted, so the file doesn't change when the groups don't
 	QMap<QString, QSet<QString>> groupMap;
-	for (auto instance : m_instances)
+	for (auto iter = m_groupMembers.begin(); iter != m_groupMembers.end(); iter++)
 	{
-		QString id = instance->id();
-		QString group = instance->group();
-		if (group.isEmpty())
-			continue;
-
 		// keep a list/set of groups for choosing
-		m_groups.insert(group);
-
-		if (!groupMap.count(group))
-		{
-			QSet<QString> set;
-			set.insert(id);
-			groupMap[group] = set;
-		}
-		else
-		{
-			QSet<QString> &set = groupMap[group];
-			set.insert(id);
-		}
+		m_groups.insert(iter.key());
+		groupMap.insert(iter.key(), iter.value());
 	}
 	QJsonObject toplevel;
 	toplevel.insert("formatVersion", QJsonValue(QString("1")));
@@ -315,45 +372,397 @@ void InstanceList::loadGroupList(QMap<QString, QString> &groupMap)
 
 InstanceList::InstListError InstanceList::loadList()
 {
+	// drop whatever a previous, unfinished load still has going
+	m_indexWatcher.disconnect(this);
+	m_folderWatcher.disconnect(this);
+	m_configWatcher.disconnect(this);
+	m_folderWatcher.cancel();
+	m_configWatcher.cancel();
+
 	// load the instance groups
-	QMap<QString, QString> groupMap;
-	loadGroupList(groupMap);
+	m_loadingGroupMap.clear();
+	loadGroupList(m_loadingGroupMap);
+
+	if(!m_loading)
+	{
+		// only some of the instances are there until the end, don't write their groups out in the meantime
+		suspendGroupSaving();
+		m_loading = true;
+	}
 
-	QList<InstancePtr> tempList;
+	m_indexChanged = false;
+	m_reloading = !m_instances.isEmpty();
+	m_instancesDropped = false;
+
+	if(m_reloading)
 	{
-		QDirIterator iter(m_instDir, QDir::Dirs | QDir::NoDot | QDir::NoDotDot | QDir::Readable,
-						  QDirIterator::FollowSymlinks);
-		while (iter.hasNext())
+		// what we have is newer than the index, only look for changes
+		syncGroups();
+		connect(&m_folderWatcher, &QFutureWatcher<QVector<InstanceIndex::Entry>>::finished, this, &InstanceList::instanceFoldersFound);
+		m_folderWatcher.setFuture(QtConcurrent::run(&InstanceList::findInstanceFolders, m_instDir));
+		return NoError;
+	}
+
+	m_index.clear();
+	// the instance folder may well be on a slow network share, so even reading the index happens elsewhere
+	connect(&m_indexWatcher, &QFutureWatcher<QVector<InstanceIndex::Entry>>::finished, this, &InstanceList::instanceIndexRead);
+	m_indexWatcher.setFuture(QtConcurrent::run(&InstanceList::readInstanceIndex, m_instDir));
+	return NoError;
+}
+
+void InstanceList::syncGroups()
+{
+	// somebody may have edited the group file
+	for (int i = 0; i < m_instances.size(); i++)
+	{
+		auto & inst = m_instances[i];
+		auto group = m_loadingGroupMap.value(inst->id());
+		if (group == inst->group())
+			continue;
+		inst->setGroupInitial(group);
+		trackGroup(inst->id(), group);
+		emit dataChanged(index(i), index(i));
+	}
+}
+
+QVector<InstanceIndex::Entry> InstanceList::readInstanceIndex(const QString &instDir)
+{
+	QVector<InstanceIndex::Entry> entries;
+	if(!InstanceIndex::read(FS::PathCombine(instDir, "instances.idx"), entries))
+	{
+		return {};
+	}
+	for(auto & entry: entries)
+	{
+		entry.instDir = FS::PathCombine(instDir, entry.id);
+	}
+	return entries;
+}
+
+QVector<InstanceIndex::Entry> InstanceList::findInstanceFolders(const QString &instDir)
+{
+	QVector<InstanceIndex::Entry> folders;
+	QDirIterator iter(instDir, QDir::Dirs | QDir::NoDot | QDir::NoDotDot | QDir::Readable,
+					  QDirIterator::FollowSymlinks);
+	while (iter.hasNext())
+	{
+		QString subDir = iter.next();
+		QFileInfo config(FS::PathCombine(subDir, "instance.cfg"));
+		if (!config.exists())
+			continue;
+		InstanceIndex::Entry folder;
+		folder.id = iter.fileName();
+		folder.instDir = subDir;
+		folder.modified = config.lastModified().toMSecsSinceEpoch();
+		folder.size = config.size();
+		folders.append(folder);
+	}
+	// the order the file system lists them in is anything but stable
+	std::sort(folders.begin(), folders.end(), [](const InstanceIndex::Entry &a, const InstanceIndex::Entry &b)
+	{
+		return a.id < b.id;
+	});
+	return folders;
+}
+
+InstanceIndex::Entry InstanceList::readInstanceConfig(const InstanceIndex::Entry &entry)
+{
+	InstanceIndex::Entry config = entry;
+	config.config.loadFile(FS::PathCombine(entry.instDir, "instance.cfg"));
+	return config;
+}
+
+InstancePtr InstanceList::instanceFromConfig(const InstanceIndex::Entry &entry)
+{
+	qDebug() << "Loading MultiMC instance from " << entry.instDir;
+	auto instanceSettings = std::make_shared<INISettingsObject>(FS::PathCombine(entry.instDir, "instance.cfg"), entry.config);
+	InstancePtr instPtr;
+	auto error = initInstance(instPtr, instanceSettings, entry.instDir);
+	if(!continueProcessInstance(instPtr, error, entry.instDir, m_loadingGroupMap))
+		return nullptr;
+	return instPtr;
+}
+
+void InstanceList::instanceIndexRead()
+{
+	m_indexWatcher.disconnect(this);
+
+	// everything from the index goes in at once, so the list is usable right away
+	QList<InstancePtr> loaded;
+	for(auto & entry: m_indexWatcher.result())
+	{
+		m_index.insert(entry.id, entry);
+		auto instPtr = instanceFromConfig(entry);
+		if(instPtr)
 		{
-			QString subDir = iter.next();
-			if (!QFileInfo(FS::PathCombine(subDir, "instance.cfg")).exists())
-				continue;
-			qDebug() << "Loading MultiMC instance from " << subDir;
-			InstancePtr instPtr;
-			auto error = loadInstance(instPtr, subDir);
-			if(!continueProcessInstance(instPtr, error, subDir, groupMap))
-				continue;
-			tempList.append(instPtr);
+			loaded.append(instPtr);
 		}
 	}
+	appendInstances(loaded);
+	if(!loaded.isEmpty())
+	{
+		emit dataIsInvalid();
+	}
+
+	// then see what changed since the index was written
+	connect(&m_folderWatcher, &QFutureWatcher<QVector<InstanceIndex::Entry>>::finished, this, &InstanceList::instanceFoldersFound);
+	m_folderWatcher.setFuture(QtConcurrent::run(&InstanceList::findInstanceFolders, m_instDir));
+}
+
+void InstanceList::instanceFoldersFound()
+{
+	m_folderWatcher.disconnect(this);
+	auto folders = m_folderWatcher.result();
+
+	QVector<InstanceIndex::Entry> changed;
+	QSet<QString> present;
+	for(auto & folder: folders)
+	{
+		present.insert(folder.id);
+		auto iter = m_index.constFind(folder.id);
+		if(iter == m_index.constEnd() || !InstanceIndex::isCurrent(*iter, folder))
+		{
+			changed.append(folder);
+		}
+	}
+	for(auto & id: m_instanceRows.keys())
+	{
+		if(!present.contains(id) && !m_ftbIds.contains(id))
+		{
+			// deleted while we weren't looking
+			removeInstance(id);
+		}
+	}
+	for(auto & id: m_index.keys())
+	{
+		if(!present.contains(id))
+		{
+			m_index.remove(id);
+			m_indexChanged = true;
+		}
+	}
+
+	m_nextConfig = 0;
+	connect(&m_configWatcher, &QFutureWatcher<InstanceIndex::Entry>::resultsReadyAt, this, &InstanceList::instanceConfigsRead);
+	connect(&m_configWatcher, &QFutureWatcher<InstanceIndex::Entry>::finished, this, &InstanceList::instanceConfigsDone);
+	m_configWatcher.setFuture(QtConcurrent::mapped(changed, &InstanceList::readInstanceConfig));
+}
+
+void InstanceList::instanceConfigsRead(int, int)
+{
+	// configurations finish in any order, the instances are added in the order of their folders
+	auto future = m_configWatcher.future();
+	QList<InstancePtr> loaded;
+	while (future.isResultReadyAt(m_nextConfig))
+	{
+		auto entry = future.resultAt(m_nextConfig++);
+		auto row = m_instanceRows.value(entry.id, -1);
+		if(row != -1 && m_instances[row]->isRunning())
+		{
+			// leave it alone, the next reload will pick up the change
+			continue;
+		}
+		auto indexed = m_index.constFind(entry.id);
+		bool sameConfig = indexed != m_index.constEnd() && indexed->config == entry.config;
+		m_index.insert(entry.id, entry);
+		m_indexChanged = true;
+		if(row != -1 && sameConfig)
+		{
+			// only touched, nothing to redo
+			continue;
+		}
+		if(row != -1 && refreshAt(row, entry.config.get("InstanceType", "Legacy").toString(), entry.config))
+		{
+			// same kind of instance, whoever holds on to it sees the new configuration
+			continue;
+		}
+		auto instPtr = instanceFromConfig(entry);
+		if(!instPtr)
+		{
+			if(row != -1)
+			{
+				removeAt(row);
+			}
+			continue;
+		}
+		if(row != -1)
+		{
+			// a different type needs a different object, it makes way for the new one in the same row
+			replaceAt(row, instPtr);
+			continue;
+		}
+		loaded.append(instPtr);
+	}
+	appendInstances(loaded);
+}
+
+void InstanceList::instanceConfigsDone()
+{
+	m_configWatcher.disconnect(this);
+	// pick up anything that was still waiting for an earlier result
+	instanceConfigsRead(0, 0);
 
 	// FIXME: generalize
-	FTBPlugin::loadInstances(m_globalSettings, groupMap, tempList);
+	QList<InstancePtr> ftbInstances;
+	FTBPlugin::loadInstances(m_globalSettings, m_loadingGroupMap, ftbInstances);
+	QSet<QString> ftbIds;
+	QList<InstancePtr> newFtbInstances;
+	for(auto & inst: ftbInstances)
+	{
+		ftbIds.insert(inst->id());
+		auto row = m_instanceRows.value(inst->id(), -1);
+		if(row == -1)
+		{
+			newFtbInstances.append(inst);
+			continue;
+		}
+		// the plugin makes new objects every time, keep the ones we have unless the type changed
+		auto settings = std::dynamic_pointer_cast<INISettingsObject>(inst->settings());
+		if(!settings || !refreshAt(row, settings->get("InstanceType").toString(), settings->contents()))
+		{
+			replaceAt(row, inst);
+		}
+	}
+	for(auto & id: m_ftbIds)
+	{
+		if(!ftbIds.contains(id))
+		{
+			removeInstance(id);
+		}
+	}
+	m_ftbIds = ftbIds;
+	appendInstances(newFtbInstances);
 
-	beginResetModel();
-	m_instances.clear();
-	for(auto inst: tempList)
+	if(m_indexChanged)
 	{
-		connect(inst.get(), SIGNAL(propertiesChanged(BaseInstance *)), this,
-				SLOT(propertiesChanged(BaseInstance *)));
-		connect(inst.get(), SIGNAL(groupChanged()), this, SLOT(groupChanged()));
-		connect(inst.get(), SIGNAL(nuked(BaseInstance *)), this,
-				SLOT(instanceNuked(BaseInstance *)));
+		QVector<InstanceIndex::Entry> entries;
+		entries.reserve(m_index.size());
+		for(auto & entry: m_index)
+		{
+			entries.append(entry);
+		}
+		// nobody waits for this, at worst the next start reads a few more files
+		QtConcurrent::run(&InstanceIndex::write, FS::PathCombine(m_instDir, "instances.idx"), entries);
+		m_indexChanged = false;
+	}
+
+	m_loading = false;
+	m_loadingGroupMap.clear();
+	resumeGroupSaving();
+	// rows that only changed were announced already
+	if(!m_reloading || m_instancesDropped)
+	{
+		emit dataIsInvalid();
+	}
+	updateDiskUsage();
+}
+
+void InstanceList::appendInstances(const QList<InstancePtr> &instances)
+{
+	if(instances.isEmpty())
+	{
+		return;
+	}
+	beginInsertRows(QModelIndex(), m_instances.size(), m_instances.size() + instances.size() - 1);
+	for(auto inst: instances)
+	{
+		connectInstance(inst);
+		m_instanceRows.insert(inst->id(), m_instances.size());
+		trackGroup(inst->id(), inst->group());
 		m_instances.append(inst);
 	}
-	endResetModel();
-	emit dataIsInvalid();
-	return NoError;
+	endInsertRows();
+}
+
+void InstanceList::connectInstance(InstancePtr inst)
+{
+	connect(inst.get(), SIGNAL(propertiesChanged(BaseInstance *)), this,
+			SLOT(propertiesChanged(BaseInstance *)));
+	connect(inst.get(), SIGNAL(groupChanged()), this, SLOT(groupChanged()));
+	connect(inst.get(), SIGNAL(nuked(BaseInstance *)), this,
+			SLOT(instanceNuked(BaseInstance *)));
+	connect(inst.get(), SIGNAL(runningStatusChanged(bool)), this, SLOT(instanceRunningChanged(bool)));
+	auto id = inst->id();
+	auto settings = inst->settings().get();
+	connect(settings, &SettingsObject::SettingChanged, this, [this, id](const Setting &, QVariant)
+	{
+		instanceSettingsSaved(id);
+	});
+	connect(settings, &SettingsObject::settingReset, this, [this, id](const Setting &)
+	{
+		instanceSettingsSaved(id);
+	});
+}
+
+void InstanceList::instanceSettingsSaved(const QString &id)
+{
+	// MultiMC wrote instance.cfg itself, the next reload shouldn't take that for a change from outside
+	auto indexed = m_index.find(id);
+	auto row = m_instanceRows.value(id, -1);
+	if(indexed == m_index.end() || row == -1)
+	{
+		return;
+	}
+	auto settings = std::dynamic_pointer_cast<INISettingsObject>(m_instances[row]->settings());
+	if(!settings)
+	{
+		return;
+	}
+	QFileInfo config(settings->filePath());
+	indexed->modified = config.lastModified().toMSecsSinceEpoch();
+	indexed->size = config.size();
+	indexed->config = settings->contents();
+	m_indexChanged = true;
+}
+
+void InstanceList::removeAt(int row)
+{
+	beginRemoveRows(QModelIndex(), row, row);
+	m_instancesDropped = true;
+	auto inst = m_instances.takeAt(row);
+	inst->disconnect(this);
+	inst->settings()->disconnect(this);
+	m_instanceRows.remove(inst->id());
+	untrackGroup(inst->id());
+	m_diskUsage.remove(inst->id());
+	for (int i = row; i < m_instances.size(); i++)
+	{
+		m_instanceRows[m_instances[i]->id()] = i;
+	}
+	endRemoveRows();
+}
+
+void InstanceList::replaceAt(int row, InstancePtr inst)
+{
+	m_instancesDropped = true;
+	auto old = m_instances[row];
+	auto oldIndex = createIndex(row, 0, (void *)old.get());
+	old->disconnect(this);
+	old->settings()->disconnect(this);
+	m_instanceRows.remove(old->id());
+	untrackGroup(old->id());
+
+	m_instances[row] = inst;
+	connectInstance(inst);
+	m_instanceRows.insert(inst->id(), row);
+	trackGroup(inst->id(), inst->group());
+
+	// indexes carry the instance pointer, the ones kept around have to follow
+	changePersistentIndex(oldIndex, index(row));
+	emit dataChanged(index(row), index(row));
+}
+
+bool InstanceList::refreshAt(int row, const QString &type, const INIFile &config)
+{
+	auto inst = m_instances[row];
+	auto settings = std::dynamic_pointer_cast<INISettingsObject>(inst->settings());
+	if(!settings || settings->get("InstanceType").toString() != type)
+	{
+		return false;
+	}
+	settings->setContents(config);
+	emit dataChanged(index(row), index(row));
+	return true;
 }
 
 /// Clear all instances. Triggers notifications.
@@ -362,26 +771,94 @@ void InstanceList::clear()
 	beginResetModel();
 	saveGroupList();
 	m_instances.clear();
+	m_instanceRows.clear();
+	m_groupMembers.clear();
+	m_instanceGroups.clear();
 	endResetModel();
 	emit dataIsInvalid();
 }
 
 void InstanceList::on_InstFolderChanged(const Setting &setting, QVariant value)
 {
+	// a different folder has nothing in common with what we have, start over
+	beginResetModel();
+	m_instances.clear();
+	m_instanceRows.clear();
+	m_groupMembers.clear();
+	m_instanceGroups.clear();
+	m_index.clear();
+	m_ftbIds.clear();
+	endResetModel();
 	m_instDir = value.toString();
+	resetDiskUsage();
 	loadList();
 }
 
+void InstanceList::resetDiskUsage()
+{
+	m_diskUsage.clear();
+	// the cache lives with the instances it describes
+	m_diskUsageScanner.reset(new DiskUsageScanner(FS::PathCombine(m_instDir, "diskusage.cache")));
+	connect(m_diskUsageScanner.get(), &DiskUsageScanner::scanned, this, &InstanceList::diskUsageScanned);
+}
+
+void InstanceList::updateDiskUsage()
+{
+	for (auto & inst: m_instances)
+	{
+		scanDiskUsage(inst, false);
+	}
+}
+
+void InstanceList::scanDiskUsage(InstancePtr inst, bool full)
+{
+	m_diskUsageScanner->scan(inst->id(), inst->instanceRoot(), inst->diskUsageParts(), full);
+}
+
+void InstanceList::instanceRunningChanged(bool running)
+{
+	if (running)
+	{
+		return;
+	}
+	auto inst = qobject_cast<BaseInstance *>(sender());
+	if (!inst)
+	{
+		return;
+	}
+	// the game grows files in place, which the folder times don't show
+	auto row = m_instanceRows.value(inst->id(), -1);
+	if (row != -1)
+	{
+		scanDiskUsage(m_instances[row], true);
+	}
+}
+
+void InstanceList::diskUsageScanned(const QString &id, qint64 total, const QVariantMap &parts)
+{
+	// late results from the scanner of a folder that isn't used anymore
+	if (sender() != m_diskUsageScanner.get())
+	{
+		return;
+	}
+	auto row = m_instanceRows.value(id, -1);
+	if (row == -1)
+	{
+		return;
+	}
+	m_diskUsage[id] = qMakePair(total, parts);
+	emit dataChanged(index(row), index(row), {DiskUsageRole, DiskUsagePartsRole});
+}
+
 /// Add an instance. Triggers notifications, returns the new index
 int InstanceList::add(InstancePtr t)
 {
 	beginInsertRows(QModelIndex(), m_instances.size(), m_instances.size());
+	m_instanceRows.insert(t->id(), m_instances.size());
+	trackGroup(t->id(), t->group());
 	m_instances.append(t);
 	t->setParent(this);
-	connect(t.get(), SIGNAL(propertiesChanged(BaseInstance *)), this,
-			SLOT(propertiesChanged(BaseInstance *)));
-	connect(t.get(), SIGNAL(groupChanged()), this, SLOT(groupChanged()));
-	connect(t.get(), SIGNAL(nuked(BaseInstance *)), this, SLOT(instanceNuked(BaseInstance *)));
+	connectInstance(t);
 	endInsertRows();
 	return count() - 1;
 }
@@ -390,14 +867,10 @@ InstancePtr InstanceList::getInstanceById(QString instId) const
 {
 	if(instId.isEmpty())
 		return InstancePtr();
-	for(auto & inst: m_instances)
-	{
-		if (inst->id() == instId)
-		{
-			return inst;
-		}
-	}
-	return InstancePtr();
+	auto row = m_instanceRows.value(instId, -1);
+	if(row == -1)
+		return InstancePtr();
+	return m_instances[row];
 }
 
 QModelIndex InstanceList::getInstanceIndexById(const QString &id) const
@@ -407,15 +880,12 @@ QModelIndex InstanceList::getInstanceIndexById(const QString &id) const
 
 int InstanceList::getInstIndex(BaseInstance *inst) const
 {
-	int count = m_instances.count();
-	for (int i = 0; i < count; i++)
-	{
-		if (inst == m_instances[i].get())
-		{
-			return i;
-		}
-	}
-	return -1;
+	if (!inst)
+		return -1;
+	auto row = m_instanceRows.value(inst->id(), -1);
+	if (row == -1 || m_instances[row].get() != inst)
+		return -1;
+	return row;
 }
 
 bool InstanceList::continueProcessInstance(InstancePtr instPtr, const int error,
@@ -459,7 +929,12 @@ InstanceList::InstLoadError
 InstanceList::loadInstance(InstancePtr &inst, const QString &instDir)
 {
 	auto instanceSettings = std::make_shared<INISettingsObject>(FS::PathCombine(instDir, "instance.cfg"));
+	return initInstance(inst, instanceSettings, instDir);
+}
 
+InstanceList::InstLoadError
+InstanceList::initInstance(InstancePtr &inst, SettingsObjectPtr instanceSettings, const QString &instDir)
+{
 	instanceSettings->registerSetting("InstanceType", "Legacy");
 
 	QString inst_type = instanceSettings->get("InstanceType").toString();
@@ -516,30 +991,9 @@ InstanceList::createInstance(InstancePtr &inst, BaseVersionPtr version, const QS
 }
 
 InstanceList::InstCreateError
-InstanceList::copyInstance(InstancePtr &newInstance, InstancePtr &oldInstance, const QString &instDir, bool copySaves)
+InstanceList::copyInstance(InstancePtr &newInstance, InstancePtr &oldInstance, const QString &instDir)
 {
-	QDir rootDir(instDir);
-	std::unique_ptr<IPathMatcher> matcher;
-	if(!copySaves)
-	{
-		auto matcherReal = new RegexpMatcher("[.]?minecraft/saves");
-		matcherReal->caseSensitive(false);
-		matcher.reset(matcherReal);
-	}
-
 	qDebug() << instDir.toUtf8();
-	FS::copy folderCopy(oldInstance->instanceRoot(), instDir);
-	folderCopy.followSymlinks(false).blacklist(matcher.get());
-	if (!folderCopy())
-	{
-		FS::deletePath(instDir);
-		return InstanceList::CantCreateDir;
-	}
-
-	INISettingsObject settings_obj(FS::PathCombine(instDir, "instance.cfg"));
-	settings_obj.registerSetting("InstanceType", "Legacy");
-	QString inst_type = settings_obj.get("InstanceType").toString();
-
 	oldInstance->copy(instDir);
 
 	auto error = loadInstance(newInstance, instDir);
@@ -549,23 +1003,31 @@ InstanceList::copyInstance(InstancePtr &newInstance, InstancePtr &oldInstance, c
 	case NoLoadError:
 		return NoCreateError;
 	case NotAnInstance:
-		rootDir.removeRecursively();
+		ENV.trash()->moveToTrash(instDir);
 		return CantCreateDir;
 	default:
 	case UnknownLoadError:
-		rootDir.removeRecursively();
+		ENV.trash()->moveToTrash(instDir);
 		return UnknownCreateError;
 	}
 }
 
+void InstanceList::removeInstance(const QString &id)
+{
+	int i = m_instanceRows.value(id, -1);
+	if (i != -1)
+	{
+		removeAt(i);
+	}
+}
+
 void InstanceList::instanceNuked(BaseInstance *inst)
 {
+	m_index.remove(inst->id());
 	int i = getInstIndex(inst);
 	if (i != -1)
 	{
-		beginRemoveRows(QModelIndex(), i, i);
-		m_instances.removeAt(i);
-		endRemoveRows();
+		removeAt(i);
 	}
 }
 
@@ -18,12 +18,18 @@
 #include <QObject>
 #include <QAbstractListModel>
 #include <QSet>
+#include <QMap>
+#include <QHash>
+#include <QFutureWatcher>
+#include <memory>
 
 #include "BaseInstance.h"
+#include "InstanceIndex.h"
 
 #include "multimc_logic_export.h"
 
 class BaseInstance;
+class DiskUsageScanner;
 class QDir;
 
 class MULTIMC_LOGIC_EXPORT InstanceList : public QAbstractListModel
@@ -51,7 +57,9 @@ public:
 	{
 		GroupRole = Qt::UserRole,
 		InstancePointerRole = 0x34B1CB48, ///< Return pointer to real instance
-		InstanceIDRole = 0x34B1CB49 ///< Return id if the instance
+		InstanceIDRole = 0x34B1CB49, ///< Return id if the instance
+		DiskUsageRole = 0x34B1CB4A, ///< Bytes the instance folder takes, invalid until it was measured
+		DiskUsagePartsRole = 0x34B1CB4B ///< Bytes by BaseInstance::diskUsageParts, as a QVariantMap
 	};
 	/*!
 	 * \brief Error codes returned by functions in the InstanceList class.
@@ -114,9 +122,11 @@ public:
 
 	QModelIndex getInstanceIndexById(const QString &id) const;
 
-	// FIXME: instead of iterating through all instances and forming a set, keep the set around
 	QStringList getGroups();
 
+	/// Ids of the instances in a group
+	QSet<QString> getGroupMembers(const QString &group) const;
+
 	void deleteGroup(const QString & name);
 
 	/*!
@@ -133,17 +143,15 @@ public:
 								   const QString &instDir);
 
 	/*!
-	 * \brief Creates a copy of an existing instance with a new name
+	 * \brief Loads the copy of an existing instance, once its folder was copied by an InstanceCopyTask
 	 *
 	 * \param newInstance Pointer to store the created instance in.
-	 * \param oldInstance The instance to copy
+	 * \param oldInstance The instance that was copied
 	 * \param instDir The new instance's directory.
 	 * \return An InstCreateError error code.
-	 * - InstExists if the given instance directory is already an instance.
-	 * - CantCreateDir if the given instance directory cannot be created.
+	 * - CantCreateDir if the copy isn't an instance.
 	 */
-	InstCreateError copyInstance(InstancePtr &newInstance, InstancePtr &oldInstance,
-								 const QString &instDir, bool copySaves);
+	InstCreateError copyInstance(InstancePtr &newInstance, InstancePtr &oldInstance, const QString &instDir);
 
 	/*!
 	 * \brief Loads an instance from the given directory.
@@ -155,6 +163,12 @@ public:
 	 */
 	InstLoadError loadInstance(InstancePtr &inst, const QString &instDir);
 
+	/// True while loadList() is still going through the instance folder
+	bool isLoading() const
+	{
+		return m_loading;
+	}
+
 signals:
 	void dataIsInvalid();
 
@@ -163,16 +177,53 @@ public slots:
 
 	/*!
 	 * \brief Loads the instance list. Triggers notifications.
+	 *
+	 * When the list is loaded already, only the differences are applied: instances whose configuration
+	 * changed take the new one, the others stay as they are, so views keep their state. An instance
+	 * object is only replaced when its type changed. Changes MultiMC saves itself don't count.
+	 *
+	 * Otherwise the instances are first made from the instance index (instances.idx), in one go.
+	 * Then the instance folders are checked on the thread pool, and configurations that changed
+	 * since the index was written are read again, also on the thread pool. Instances that changed
+	 * are updated, new ones show up in the order of their folder names as they are loaded,
+	 * and dataIsInvalid() is emitted once the list is complete. A reload only emits it when
+	 * instance objects were removed or replaced.
 	 */
 	InstListError loadList();
 
+	/// Measure the instance folders again in the background. The disk usage roles change as results come in.
+	void updateDiskUsage();
+
 private slots:
 	void propertiesChanged(BaseInstance *inst);
 	void instanceNuked(BaseInstance *inst);
 	void groupChanged();
+	void instanceIndexRead();
+	void instanceFoldersFound();
+	void instanceConfigsRead(int begin, int end);
+	void instanceConfigsDone();
+	void instanceRunningChanged(bool running);
+	void diskUsageScanned(const QString &id, qint64 total, const QVariantMap &parts);
 
 private:
 	int getInstIndex(BaseInstance *inst) const;
+	InstLoadError initInstance(InstancePtr &inst, SettingsObjectPtr instanceSettings, const QString &instDir);
+	InstancePtr instanceFromConfig(const InstanceIndex::Entry &entry);
+	void appendInstances(const QList<InstancePtr> &instances);
+	void removeInstance(const QString &id);
+	void removeAt(int row);
+	void replaceAt(int row, InstancePtr inst);
+	bool refreshAt(int row, const QString &type, const INIFile &config);
+	void instanceSettingsSaved(const QString &id);
+	void connectInstance(InstancePtr inst);
+	void trackGroup(const QString &id, const QString &group);
+	void untrackGroup(const QString &id);
+	void syncGroups();
+	void scanDiskUsage(InstancePtr inst, bool full);
+	void resetDiskUsage();
+	static QVector<InstanceIndex::Entry> readInstanceIndex(const QString &instDir);
+	static QVector<InstanceIndex::Entry> findInstanceFolders(const QString &instDir);
+	static InstanceIndex::Entry readInstanceConfig(const InstanceIndex::Entry &entry);
 
 public:
 	static bool continueProcessInstance(InstancePtr instPtr, const int error, const QDir &dir, QMap<QString, QString> &groupMap);
@@ -180,8 +231,35 @@ public:
 protected:
 	QString m_instDir;
 	QList<InstancePtr> m_instances;
+	// row of every instance in m_instances, by id
+	QHash<QString, int> m_instanceRows;
 	QSet<QString> m_groups;
+	// ids of the instances in every group, and the group of every instance
+	QHash<QString, QSet<QString>> m_groupMembers;
+	QHash<QString, QString> m_instanceGroups;
+	// instances that came from the FTB plugin during the last load
+	QSet<QString> m_ftbIds;
 	SettingsObjectPtr m_globalSettings;
 	bool suspendedGroupSave = false;
 	bool queuedGroupSave = false;
+
+	// state of loadList()
+	bool m_loading = false;
+	QMap<QString, QString> m_loadingGroupMap;
+	QFutureWatcher<QVector<InstanceIndex::Entry>> m_indexWatcher;
+	QFutureWatcher<QVector<InstanceIndex::Entry>> m_folderWatcher;
+	QFutureWatcher<InstanceIndex::Entry> m_configWatcher;
+	// index of the next configuration to turn into an instance, the ones after it may be read already
+	int m_nextConfig = 0;
+	// what instances.idx will be written from, by instance id
+	QMap<QString, InstanceIndex::Entry> m_index;
+	bool m_indexChanged = false;
+	// the list already had instances when loading started
+	bool m_reloading = false;
+	// instance objects went away since loading started, whoever holds one should look again
+	bool m_instancesDropped = false;
+
+	// sizes of the instance folders, by instance id
+	std::unique_ptr<DiskUsageScanner> m_diskUsageScanner;
+	QHash<QString, QPair<qint64, QVariantMap>> m_diskUsage;
 };
@@ -0,0 +1,304 @@
+#include "LogFileModel.h"
+#include "GZipIndex.h"
+
+#include <QFile>
+#include <QtConcurrentRun>
+#include <atomic>
+#include <cstring>
+
+namespace
+{
+// lines per block, and distance between the line offsets that are kept
+const int blockLines = 64;
+// decoded blocks kept around
+const int cachedBlocks = 256;
+}
+
+struct LogFileModel::Content
+{
+	QFile file;
+	const char *data = nullptr;
+	qint64 size = 0;
+	bool gzipped = false;
+	GZipIndex gzip;
+	qint64 textSize = 0;
+	// offset of every blockLines-th line
+	QVector<qint64> blockOffsets;
+	int lineCount = 0;
+	QString error;
+	std::atomic<bool> cancelled;
+
+	Content() : cancelled(false)
+	{
+	}
+
+	// count lines in the next piece of text, which starts at textSize
+	bool indexText(const char *text, int length)
+	{
+		const char *end = text + length;
+		const char *pos = text;
+		while (pos < end)
+		{
+			auto newline = (const char *)memchr(pos, '\n', end - pos);
+			if (!newline)
+			{
+				break;
+			}
+			lineCount++;
+			if (lineCount % blockLines == 0)
+			{
+				blockOffsets.append(textSize + (newline - text) + 1);
+			}
+			pos = newline + 1;
+		}
+		textSize += length;
+		return !cancelled;
+	}
+
+	bool read(qint64 offset, qint64 length, QByteArray &out) const
+	{
+		if (gzipped)
+		{
+			return gzip.read(offset, length, out);
+		}
+		out = QByteArray(data + offset, length);
+		return true;
+	}
+};
+
+LogFileModel::LogFileModel(QObject *parent) : QAbstractListModel(parent), m_blocks(cachedBlocks)
+{
+	connect(&m_watcher, &QFutureWatcher<std::shared_ptr<Content>>::finished, this, &LogFileModel::indexReady);
+}
+
+LogFileModel::~LogFileModel()
+{
+	if (m_loading)
+	{
+		m_loading->cancelled = true;
+	}
+	m_watcher.waitForFinished();
+}
+
+void LogFileModel::open(const QString &path)
+{
+	close();
+	auto content = std::make_shared<Content>();
+	content->file.setFileName(path);
+	content->gzipped = path.endsWith(".gz");
+	m_loading = content;
+	m_watcher.setFuture(QtConcurrent::run(&LogFileModel::load, content));
+}
+
+std::shared_ptr<LogFileModel::Content> LogFileModel::load(std::shared_ptr<Content> content)
+{
+	auto &file = content->file;
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		content->error = file.errorString();
+		return content;
+	}
+	content->size = file.size();
+	content->blockOffsets.append(0);
+	if (content->size == 0)
+	{
+		return content;
+	}
+	content->data = (const char *)file.map(0, content->size);
+	if (!content->data)
+	{
+		content->error = file.errorString();
+		return content;
+	}
+	if (content->gzipped)
+	{
+		using namespace std::placeholders;
+		if (!content->gzip.build(content->data, content->size, std::bind(&Content::indexText, content.get(), _1, _2)))
+		{
+			content->error = QObject::tr("The file is not a valid gzip file.");
+			return content;
+		}
+	}
+	else
+	{
+		// in pieces, so it can be cancelled
+		const qint64 piece = 16 * 1024 * 1024;
+		for (qint64 offset = 0; offset < content->size; offset += piece)
+		{
+			if (!content->indexText(content->data + offset, qMin(piece, content->size - offset)))
+			{
+				break;
+			}
+		}
+	}
+	// the last line may not end with a newline
+	if (content->textSize && !content->cancelled)
+	{
+		QByteArray last;
+		if (content->read(content->textSize - 1, 1, last) && last != "\n")
+		{
+			content->lineCount++;
+		}
+	}
+	return content;
+}
+
+void LogFileModel::indexReady()
+{
+	auto content = m_watcher.result();
+	if (content != m_loading)
+	{
+		// closed or replaced in the meantime
+		return;
+	}
+	m_loading.reset();
+	beginResetModel();
+	m_blocks.clear();
+	if (content->error.isEmpty())
+	{
+		m_content = content;
+		m_error.clear();
+	}
+	else
+	{
+		m_content.reset();
+		m_error = content->error;
+	}
+	endResetModel();
+	emit loaded(m_content != nullptr);
+}
+
+void LogFileModel::close()
+{
+	if (m_loading)
+	{
+		m_loading->cancelled = true;
+		m_loading.reset();
+	}
+	beginResetModel();
+	m_content.reset();
+	m_blocks.clear();
+	m_error.clear();
+	endResetModel();
+}
+
+bool LogFileModel::isLoading() const
+{
+	return m_loading != nullptr;
+}
+
+QString LogFileModel::errorString() const
+{
+	return m_error;
+}
+
+qint64 LogFileModel::textSize() const
+{
+	return m_content ? m_content->textSize : 0;
+}
+
+bool LogFileModel::toPlainText(QString &out, qint64 maxSize) const
+{
+	out.clear();
+	if (!m_content)
+	{
+		return true;
+	}
+	if (m_content->textSize > maxSize)
+	{
+		return false;
+	}
+	QByteArray text;
+	if (!m_content->read(0, m_content->textSize, text))
+	{
+		return false;
+	}
+	out = QString::fromUtf8(text);
+	return true;
+}
+
+int LogFileModel::rowCount(const QModelIndex &parent) const
+{
+	if (parent.isValid() || !m_content)
+	{
+		return 0;
+	}
+	return m_content->lineCount;
+}
+
+const QStringList *LogFileModel::block(int index) const
+{
+	if (auto cached = m_blocks.object(index))
+	{
+		return cached;
+	}
+	auto &offsets = m_content->blockOffsets;
+	auto blockEnd = [&](int block)
+	{
+		return block + 1 < offsets.size() ? offsets[block + 1] : m_content->textSize;
+	};
+	int first = index;
+	int last = index;
+	if (m_content->gzipped)
+	{
+		// everything in the span costs the same to inflate, decode the blocks around this one while at it
+		qint64 spanStart, spanEnd;
+		m_content->gzip.span(offsets[index], spanStart, spanEnd);
+		while (first > 0 && index - first < cachedBlocks / 4 && offsets[first - 1] >= spanStart)
+		{
+			first--;
+		}
+		while (last + 1 < offsets.size() && last - first + 1 < cachedBlocks / 2 && blockEnd(last + 1) <= spanEnd)
+		{
+			last++;
+		}
+	}
+	QByteArray raw;
+	bool ok = m_content->read(offsets[first], blockEnd(last) - offsets[first], raw);
+	QStringList *found = nullptr;
+	for (int block = first; block <= last; block++)
+	{
+		auto lines = new QStringList();
+		if (ok)
+		{
+			const char *pos = raw.constData() + (offsets[block] - offsets[first]);
+			const char *rawEnd = raw.constData() + (blockEnd(block) - offsets[first]);
+			while (pos < rawEnd && lines->size() < blockLines)
+			{
+				auto newline = (const char *)memchr(pos, '\n', rawEnd - pos);
+				auto lineEnd = newline ? newline : rawEnd;
+				auto line = QString::fromUtf8(pos, lineEnd - pos);
+				if (line.endsWith('\r'))
+				{
+					line.chop(1);
+				}
+				lines->append(line);
+				pos = lineEnd + 1;
+			}
+		}
+		if (block == index)
+		{
+			found = lines;
+			continue;
+		}
+		m_blocks.insert(block, lines);
+	}
+	// last, so filling the cache can never push out the block asked for
+	m_blocks.insert(index, found);
+	return found;
+}
+
+QVariant LogFileModel::data(const QModelIndex &index, int role) const
+{
+	if (!m_content || index.row() < 0 || index.row() >= m_content->lineCount)
+	{
+		return QVariant();
+	}
+	if (role != Qt::DisplayRole && role != Qt::EditRole)
+	{
+		return QVariant();
+	}
+	auto lines = block(index.row() / blockLines);
+	int line = index.row() % blockLines;
+	return line < lines->size() ? lines->at(line) : QString();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QCache>
+#include <QFutureWatcher>
+#include <QStringList>
+#include <memory>
+
+#include "multimc_logic_export.h"
+
+/**
+ * Read-only list model over the lines of a log file on disk, plain or gzipped.
+ *
+ * Plain files are memory mapped, gzipped ones get a GZipIndex. Opening a file only builds
+ * a sparse index of line offsets, on a worker thread. Lines are read and decoded in small
+ * blocks when a view asks for them, so even very large files don't take up much memory.
+ */
+class MULTIMC_LOGIC_EXPORT LogFileModel : public QAbstractListModel
+{
+	Q_OBJECT
+public:
+	explicit LogFileModel(QObject *parent = nullptr);
+	virtual ~LogFileModel();
+
+	/// start loading the file, loaded() is emitted when it is ready
+	void open(const QString &path);
+	/// stop using the file, so it can be deleted
+	void close();
+
+	bool isLoading() const;
+	QString errorString() const;
+	/// size of the text, after decompression
+	qint64 textSize() const;
+
+	/// the whole text of the file, if it is not larger than maxSize
+	bool toPlainText(QString &out, qint64 maxSize) const;
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role) const override;
+
+signals:
+	void loaded(bool success);
+
+private slots:
+	void indexReady();
+
+private:
+	struct Content;
+	static std::shared_ptr<Content> load(std::shared_ptr<Content> content);
+	const QStringList *block(int index) const;
+
+private:
+	std::shared_ptr<Content> m_content;
+	std::shared_ptr<Content> m_loading;
+	QFutureWatcher<std::shared_ptr<Content>> m_watcher;
+	QString m_error;
+	// decoded blocks of lines, by block number
+	mutable QCache<int, QStringList> m_blocks;
+};
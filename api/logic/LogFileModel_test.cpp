@@ -0,0 +1,125 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "LogFileModel.h"
+#include "GZip.h"
+#include "FileSystem.h"
+
+class LogFileModelTest : public QObject
+{
+	Q_OBJECT
+
+	static QByteArray makeLog(int lines, bool trailingNewline)
+	{
+		QByteArray out;
+		for(int i = 0; i < lines; i++)
+		{
+			out += QString("[12:00:00] [main/INFO]: line %1\r\n").arg(i).toUtf8();
+		}
+		if(!trailingNewline)
+		{
+			out.chop(2);
+		}
+		return out;
+	}
+
+	static bool load(LogFileModel &model, const QString &path)
+	{
+		QSignalSpy loaded(&model, SIGNAL(loaded(bool)));
+		model.open(path);
+		if(!loaded.wait(10000))
+		{
+			return false;
+		}
+		return loaded.first().first().toBool();
+	}
+
+	static QString line(LogFileModel &model, int row)
+	{
+		return model.data(model.index(row), Qt::DisplayRole).toString();
+	}
+
+private
+slots:
+	void test_plain()
+	{
+		QTemporaryDir dir;
+		auto path = FS::PathCombine(dir.path(), "latest.log");
+		FS::write(path, makeLog(1000, true));
+
+		LogFileModel model;
+		QVERIFY(load(model, path));
+		QCOMPARE(model.rowCount(), 1000);
+		QCOMPARE(line(model, 0), QString("[12:00:00] [main/INFO]: line 0"));
+		QCOMPARE(line(model, 64), QString("[12:00:00] [main/INFO]: line 64"));
+		QCOMPARE(line(model, 999), QString("[12:00:00] [main/INFO]: line 999"));
+	}
+
+	void test_noTrailingNewline()
+	{
+		QTemporaryDir dir;
+		auto path = FS::PathCombine(dir.path(), "latest.log");
+		FS::write(path, makeLog(128, false));
+
+		LogFileModel model;
+		QVERIFY(load(model, path));
+		QCOMPARE(model.rowCount(), 128);
+		QCOMPARE(line(model, 127), QString("[12:00:00] [main/INFO]: line 127"));
+	}
+
+	void test_gzip()
+	{
+		QTemporaryDir dir;
+		auto path = FS::PathCombine(dir.path(), "2016-01-01-1.log.gz");
+		auto text = makeLog(200000, true);
+		QByteArray compressed;
+		QVERIFY(GZip::zip(text, compressed));
+		FS::write(path, compressed);
+
+		LogFileModel model;
+		QVERIFY(load(model, path));
+		QCOMPARE(model.rowCount(), 200000);
+		QCOMPARE(model.textSize(), qint64(text.size()));
+		QCOMPARE(line(model, 150001), QString("[12:00:00] [main/INFO]: line 150001"));
+		QCOMPARE(line(model, 3), QString("[12:00:00] [main/INFO]: line 3"));
+		// blocks decoded alongside the requested one, across checkpoint spans
+		for(int row = 0; row < model.rowCount(); row += 997)
+		{
+			QCOMPARE(line(model, row), QString("[12:00:00] [main/INFO]: line %1").arg(row));
+		}
+		QCOMPARE(line(model, 199999), QString("[12:00:00] [main/INFO]: line 199999"));
+
+		QString all;
+		QVERIFY(!model.toPlainText(all, 1024));
+		QVERIFY(model.toPlainText(all, text.size()));
+		QCOMPARE(all, QString::fromUtf8(text));
+	}
+
+	void test_notGzip()
+	{
+		QTemporaryDir dir;
+		auto path = FS::PathCombine(dir.path(), "broken.log.gz");
+		FS::write(path, "this is not gzip");
+
+		LogFileModel model;
+		QVERIFY(!load(model, path));
+		QVERIFY(!model.errorString().isEmpty());
+		QCOMPARE(model.rowCount(), 0);
+	}
+
+	void test_empty()
+	{
+		QTemporaryDir dir;
+		auto path = FS::PathCombine(dir.path(), "empty.log");
+		FS::write(path, QByteArray());
+
+		LogFileModel model;
+		QVERIFY(load(model, path));
+		QCOMPARE(model.rowCount(), 0);
+	}
+};
+
+QTEST_GUILESS_MAIN(LogFileModelTest)
+
+#include "LogFileModel_test.moc"
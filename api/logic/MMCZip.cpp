@@ -29,6 +29,9 @@ see quazip/(un)MMCZip.h files for details. Basically it's the zlib license.
 #include "MMCZip.h"
 #include "FileSystem.h"
 
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDirIterator>
 #include <QDebug>
 
 bool copyData(QIODevice &inFile, QIODevice &outFile)
@@ -190,15 +193,28 @@ bool MMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &containe
 		}
 		contained.insert(filename);
 
-		if (!fileInsideMod.open(QIODevice::ReadOnly))
+		QuaZipFileInfo64 info;
+		if (!modZip.getCurrentFileInfo(&info))
+		{
+			qCritical() << "Failed to read info of " << filename << " from " << from.fileName();
+			return false;
+		}
+
+		// copy the compressed data as-is, no need to inflate and deflate it again
+		int method = 0;
+		int level = 0;
+		if (!fileInsideMod.open(QIODevice::ReadOnly, &method, &level, true))
 		{
 			qCritical() << "Failed to open " << filename << " from " << from.fileName();
 			return false;
 		}
 
-		QuaZipNewInfo info_out(fileInsideMod.getActualFileName());
+		QuaZipNewInfo info_out(info.name);
+		info_out.dateTime = info.dateTime;
+		info_out.uncompressedSize = info.uncompressedSize;
+		info_out.externalAttr = info.externalAttr;
 
-		if (!zipOutFile.open(QIODevice::WriteOnly, info_out))
+		if (!zipOutFile.open(QIODevice::WriteOnly, info_out, nullptr, info.crc, method, level, true))
 		{
 			qCritical() << "Failed to open " << filename << " in the jar";
 			fileInsideMod.close();
@@ -217,6 +233,48 @@ bool MMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &containe
 	return true;
 }
 
+static void hashFile(QCryptographicHash &hash, const QString &path)
+{
+	QFile file(path);
+	if (file.open(QIODevice::ReadOnly))
+	{
+		hash.addData(&file);
+	}
+}
+
+QString MMCZip::moddedJarKey(QString sourceJarPath, const QList<Mod>& mods)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hashFile(hash, sourceJarPath);
+	for (auto & mod: mods)
+	{
+		if (!mod.enabled())
+			continue;
+		hash.addData(QString("%1 %2\n").arg(mod.type()).arg(mod.filename().fileName()).toUtf8());
+		if (mod.type() == Mod::MOD_FOLDER)
+		{
+			// folders are hashed by their file names, sizes and modification times
+			QDir root(mod.filename().absoluteFilePath());
+			QDirIterator iter(root.absolutePath(), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+			QStringList entries;
+			while (iter.hasNext())
+			{
+				iter.next();
+				auto info = iter.fileInfo();
+				entries.append(QString("%1 %2 %3").arg(root.relativeFilePath(info.absoluteFilePath()))
+					.arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch()));
+			}
+			entries.sort();
+			hash.addData(entries.join('\n').toUtf8());
+		}
+		else
+		{
+			hashFile(hash, mod.filename().absoluteFilePath());
+		}
+	}
+	return hash.result().toHex();
+}
+
 bool MMCZip::createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<Mod>& mods)
 {
 	QuaZip zipOut(targetJarPath);
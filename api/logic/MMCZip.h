@@ -41,6 +41,7 @@ namespace MMCZip
 
 	/**
 	 * Merge two zip files, using a filter function
+	 * Entries are copied without recompressing them.
 	 */
 	bool MULTIMC_LOGIC_EXPORT mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &contained, std::function<bool(QString)> filter);
 
@@ -49,6 +50,11 @@ namespace MMCZip
 	 */
 	bool MULTIMC_LOGIC_EXPORT createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<Mod>& mods);
 
+	/**
+	 * get a key that changes whenever the result of createModdedJar for the same inputs would change
+	 */
+	QString MULTIMC_LOGIC_EXPORT moddedJarKey(QString sourceJarPath, const QList<Mod>& mods);
+
 	/**
 	 * Extract a whole archive.
 	 *
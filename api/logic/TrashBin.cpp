@@ -0,0 +1,243 @@
+#include "TrashBin.h"
+#include "FileSystem.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QUuid>
+#include <QDebug>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+#include <algorithm>
+
+namespace {
+const char *stagingName = ".trash";
+}
+
+TrashBin::TrashBin(QObject *parent) : QObject(parent), m_pendingMutex(QMutex::Recursive), m_stopping(false), m_pending(0), m_deleted(0), m_total(0)
+{
+	// emptying one folder already keeps several threads busy, don't pile up more
+	m_pool.setMaxThreadCount(1);
+}
+
+TrashBin::~TrashBin()
+{
+	shutdown();
+}
+
+void TrashBin::setRegistry(const QString &path)
+{
+	QStringList roots;
+	{
+		QMutexLocker locker(&m_mutex);
+		m_registryPath = path;
+		if(QFileInfo(path).exists())
+		{
+			try
+			{
+				for(auto & line: QString::fromUtf8(FS::read(path)).split('\n', QString::SkipEmptyParts))
+				{
+					roots.append(line);
+				}
+			}
+			catch(FS::FileSystemException & e)
+			{
+				qWarning() << "Couldn't read the trash registry:" << e.cause();
+			}
+		}
+		m_roots.clear();
+	}
+
+	// left over from before
+	for(auto & root: roots)
+	{
+		QDir staging(FS::PathCombine(root, stagingName));
+		if(!staging.exists())
+		{
+			continue;
+		}
+		remember(root);
+		for(auto & entry: staging.entryList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System))
+		{
+			qDebug() << "Deleting leftover trash" << staging.absoluteFilePath(entry);
+			schedule(staging.absoluteFilePath(entry));
+		}
+	}
+	QMutexLocker locker(&m_mutex);
+	writeRegistry();
+}
+
+bool TrashBin::moveToTrash(const QString &path)
+{
+	QFileInfo info(path);
+	if(!info.exists() && !info.isSymLink())
+	{
+		return true;
+	}
+	// links are gone with a single unlink, and a file is no slower to remove than to move
+	if(info.isSymLink() || !info.isDir())
+	{
+		return QFile::remove(path);
+	}
+
+	auto root = info.absolutePath();
+	auto staging = FS::PathCombine(root, stagingName);
+	auto staged = FS::PathCombine(staging, QUuid::createUuid().toString().mid(1, 36));
+	if(!m_stopping && FS::ensureFolderPathExists(staging) && QDir().rename(info.absoluteFilePath(), staged))
+	{
+		remember(root);
+		schedule(staged);
+		return true;
+	}
+	qDebug() << "Couldn't move" << path << "to the trash, deleting it right away";
+	return FS::deletePath(path);
+}
+
+void TrashBin::remember(const QString &root)
+{
+	QMutexLocker locker(&m_mutex);
+	if(m_roots.contains(root))
+	{
+		return;
+	}
+	m_roots.insert(root);
+	writeRegistry();
+}
+
+void TrashBin::writeRegistry()
+{
+	if(m_registryPath.isEmpty())
+	{
+		return;
+	}
+	auto roots = m_roots.toList();
+	std::sort(roots.begin(), roots.end());
+	try
+	{
+		FS::write(m_registryPath, roots.join('\n').toUtf8());
+	}
+	catch(FS::FileSystemException & e)
+	{
+		qWarning() << "Couldn't write the trash registry:" << e.cause();
+	}
+}
+
+void TrashBin::schedule(const QString &staged)
+{
+	{
+		QMutexLocker locker(&m_pendingMutex);
+		m_pending++;
+	}
+	QtConcurrent::run(&m_pool, [this, staged]()
+	{
+		empty(staged);
+		// the staging folder goes too once it's empty
+		QDir().rmdir(QFileInfo(staged).absolutePath());
+		// nothing can be queued between seeing the last one finish and saying so
+		QMutexLocker locker(&m_pendingMutex);
+		if(--m_pending == 0)
+		{
+			m_deleted = 0;
+			m_total = 0;
+			emit emptied();
+		}
+	});
+}
+
+void TrashBin::deleted(qint64 count)
+{
+	auto now = m_deleted += count;
+	emit progress(now, m_total);
+}
+
+void TrashBin::empty(const QString &staged)
+{
+	if(m_stopping)
+	{
+		return;
+	}
+#if defined Q_OS_WIN32
+	// junctions and other reparse points need the care FS::deletePath takes, so no shortcuts here
+	m_total++;
+	FS::deletePath(staged);
+	deleted(1);
+#else
+	// everything but real folders is removed with one unlink, symlinks are never followed
+	QStringList files;
+	QStringList folders;
+	QDirIterator iter(staged, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System, QDirIterator::Subdirectories);
+	while(iter.hasNext() && !m_stopping)
+	{
+		iter.next();
+		auto info = iter.fileInfo();
+		if(info.isDir() && !info.isSymLink())
+		{
+			folders.append(info.absoluteFilePath());
+		}
+		else
+		{
+			files.append(info.absoluteFilePath());
+		}
+	}
+	if(m_stopping)
+	{
+		return;
+	}
+	m_total += files.size() + folders.size() + 1;
+	emit progress(m_deleted, m_total);
+
+	std::atomic<int> sinceReport(0);
+	QtConcurrent::blockingMap(files, [&](const QString &file)
+	{
+		if(m_stopping)
+		{
+			return;
+		}
+		if(!QFile::remove(file))
+		{
+			// read only files can't be removed everywhere
+			QFile::setPermissions(file, QFile::permissions(file) | QFile::WriteOwner | QFile::WriteUser);
+			if(!QFile::remove(file))
+			{
+				qWarning() << "Couldn't delete" << file;
+			}
+		}
+		if(++sinceReport % 256 == 0)
+		{
+			deleted(256);
+		}
+	});
+	deleted(sinceReport % 256);
+	if(m_stopping)
+	{
+		return;
+	}
+
+	// deepest first, they have to be empty
+	std::sort(folders.begin(), folders.end(), [](const QString &a, const QString &b)
+	{
+		return a.size() > b.size();
+	});
+	QDir dir;
+	for(auto & folder: folders)
+	{
+		dir.rmdir(folder);
+	}
+	if(!dir.rmdir(staged))
+	{
+		qWarning() << "Couldn't delete everything in" << staged;
+	}
+	deleted(folders.size() + 1);
+#endif
+}
+
+void TrashBin::shutdown()
+{
+	m_stopping = true;
+	m_pool.waitForDone();
+}
+
+bool TrashBin::isBusy() const
+{
+	return m_pending > 0;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QObject>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+
+#include "multimc_logic_export.h"
+
+/**
+ * Deletes folders in the background.
+ *
+ * A folder that is thrown away is renamed into a staging folder (.trash) next to it right away,
+ * which is cheap because it stays on the same file system. The contents are then deleted by worker threads.
+ *
+ * The folders that hold staging folders are remembered in a registry file, so anything left behind
+ * by a crash or by quitting early is deleted on the next start.
+ */
+class MULTIMC_LOGIC_EXPORT TrashBin : public QObject
+{
+	Q_OBJECT
+public:
+	explicit TrashBin(QObject *parent = nullptr);
+	virtual ~TrashBin();
+
+	/// Keep the registry in this file, and empty the staging folders that are listed in it already
+	void setRegistry(const QString &path);
+
+	/**
+	 * Get path out of the way now and delete it in the background.
+	 * When it can't be moved (something in it is open on Windows, no permission to make the staging folder),
+	 * it is deleted right here instead. Returns false if that fails.
+	 * Can be called from any thread.
+	 */
+	bool moveToTrash(const QString &path);
+
+	/// Stop deleting and wait for the workers. Whatever is left gets deleted on the next start.
+	void shutdown();
+
+	bool isBusy() const;
+
+signals:
+	/// files deleted so far, out of the files found so far, since the trash was last empty. Emitted from worker threads.
+	void progress(qint64 deleted, qint64 total);
+	/// everything thrown away is gone
+	void emptied();
+
+private:
+	void schedule(const QString &staged);
+	void empty(const QString &staged);
+	void remember(const QString &root);
+	void writeRegistry();
+	void deleted(qint64 count);
+
+private:
+	QThreadPool m_pool;
+	mutable QMutex m_mutex;
+	QString m_registryPath;
+	QSet<QString> m_roots;
+	// guards m_pending going to 0 against new work being queued
+	QMutex m_pendingMutex;
+	std::atomic<bool> m_stopping;
+	std::atomic<int> m_pending;
+	std::atomic<qint64> m_deleted;
+	std::atomic<qint64> m_total;
+};
@@ -0,0 +1,95 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "TrashBin.h"
+#include "FileSystem.h"
+
+class TrashBinTest : public QObject
+{
+	Q_OBJECT
+
+	static void makeTree(const QString &root, int folders, int files)
+	{
+		for(int i = 0; i < folders; i++)
+		{
+			auto folder = FS::PathCombine(root, QString("folder%1").arg(i), "nested");
+			QVERIFY(FS::ensureFolderPathExists(folder));
+			for(int j = 0; j < files; j++)
+			{
+				FS::write(FS::PathCombine(folder, QString("file%1").arg(j)), "contents");
+			}
+		}
+	}
+
+private
+slots:
+	void test_moveToTrash()
+	{
+		QTemporaryDir dir;
+		auto path = FS::PathCombine(dir.path(), "instance");
+		makeTree(path, 10, 100);
+
+		TrashBin trash;
+		QSignalSpy emptied(&trash, SIGNAL(emptied()));
+		QSignalSpy progress(&trash, SIGNAL(progress(qint64, qint64)));
+		QVERIFY(trash.moveToTrash(path));
+		// gone right away
+		QVERIFY(!QFileInfo::exists(path));
+
+		QVERIFY(emptied.count() || emptied.wait(10000));
+		QVERIFY(!trash.isBusy());
+		QVERIFY(!QFileInfo::exists(FS::PathCombine(dir.path(), ".trash")));
+		QVERIFY(progress.count());
+		auto last = progress.last();
+		QCOMPARE(last[0].toLongLong(), last[1].toLongLong());
+	}
+
+	void test_missing()
+	{
+		QTemporaryDir dir;
+		TrashBin trash;
+		QVERIFY(trash.moveToTrash(FS::PathCombine(dir.path(), "nothing")));
+		QVERIFY(!trash.isBusy());
+	}
+
+	void test_symlinksAreNotFollowed()
+	{
+#if defined Q_OS_UNIX
+		QTemporaryDir dir;
+		auto kept = FS::PathCombine(dir.path(), "kept");
+		makeTree(kept, 1, 5);
+		auto path = FS::PathCombine(dir.path(), "instance");
+		QVERIFY(FS::ensureFolderPathExists(path));
+		QVERIFY(QFile::link(kept, FS::PathCombine(path, "link")));
+
+		TrashBin trash;
+		QSignalSpy emptied(&trash, SIGNAL(emptied()));
+		QVERIFY(trash.moveToTrash(path));
+		QVERIFY(emptied.count() || emptied.wait(10000));
+		QVERIFY(!QFileInfo::exists(path));
+		QVERIFY(QFileInfo::exists(FS::PathCombine(kept, "folder0", "nested", "file4")));
+#endif
+	}
+
+	void test_leftovers()
+	{
+		QTemporaryDir dir;
+		auto registry = FS::PathCombine(dir.path(), "trash.lst");
+		auto root = FS::PathCombine(dir.path(), "instances");
+		auto leftover = FS::PathCombine(root, ".trash", "leftover");
+		makeTree(leftover, 2, 10);
+		FS::write(registry, root.toUtf8() + "\n");
+
+		TrashBin trash;
+		QSignalSpy emptied(&trash, SIGNAL(emptied()));
+		trash.setRegistry(registry);
+		QVERIFY(emptied.count() || emptied.wait(10000));
+		QVERIFY(!QFileInfo::exists(FS::PathCombine(root, ".trash")));
+		QVERIFY(QFileInfo::exists(root));
+	}
+};
+
+QTEST_GUILESS_MAIN(TrashBinTest)
+
+#include "TrashBin_test.moc"
@@ -0,0 +1,393 @@
+#include "ZipCompressTask.h"
+#include "FileSystem.h"
+
+#include <quazip.h>
+#include <zlib.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QTextCodec>
+#include <QThreadPool>
+#include <QQueue>
+#include <QSet>
+#include <QDebug>
+#include <QtConcurrentRun>
+
+namespace {
+
+// big enough to keep zlib busy, small enough to spread one large jar over all the workers
+const qint64 chunkSize = 1024 * 1024;
+
+struct Entry
+{
+	QString name;
+	QString path;
+	bool isDir = false;
+	bool store = false;
+	qint64 size = 0;
+	QDateTime modified;
+	QFile::Permissions permissions;
+};
+
+struct Chunk
+{
+	int entry = 0;
+	qint64 offset = 0;
+	qint64 length = 0;
+	bool last = false;
+};
+
+struct PackedChunk
+{
+	QByteArray data;
+	quint32 crc = 0;
+	qint64 length = 0;
+	QString error;
+};
+
+/**
+ * Read a piece of a file and deflate it on its own.
+ * All but the last piece end with a sync flush, so the pieces can simply be written one after another.
+ */
+PackedChunk packChunk(const Entry &entry, const Chunk &chunk, int level)
+{
+	PackedChunk packed;
+	packed.length = chunk.length;
+
+	QFile file(entry.path);
+	if(!file.open(QIODevice::ReadOnly) || !file.seek(chunk.offset))
+	{
+		packed.error = QObject::tr("Couldn't read '%1'").arg(entry.path);
+		return packed;
+	}
+	QByteArray raw = file.read(chunk.length);
+	if(raw.size() != chunk.length)
+	{
+		packed.error = QObject::tr("'%1' changed while it was being exported").arg(entry.path);
+		return packed;
+	}
+	packed.crc = crc32(0, reinterpret_cast<const Bytef *>(raw.constData()), raw.size());
+
+	if(entry.store)
+	{
+		packed.data = raw;
+		return packed;
+	}
+
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	if(deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		packed.error = QObject::tr("Couldn't start compressing '%1'").arg(entry.path);
+		return packed;
+	}
+	// deflateBound is for Z_FINISH, a sync flush can need a few bytes more
+	packed.data.resize(deflateBound(&zs, raw.size()) + 16);
+	zs.next_in = reinterpret_cast<Bytef *>(raw.data());
+	zs.avail_in = raw.size();
+	const int flush = chunk.last ? Z_FINISH : Z_SYNC_FLUSH;
+	qint64 written = 0;
+	for(;;)
+	{
+		zs.next_out = reinterpret_cast<Bytef *>(packed.data.data() + written);
+		zs.avail_out = packed.data.size() - written;
+		int ret = deflate(&zs, flush);
+		written = packed.data.size() - zs.avail_out;
+		if(ret == Z_STREAM_ERROR)
+		{
+			packed.error = QObject::tr("Couldn't compress '%1'").arg(entry.path);
+			break;
+		}
+		if(chunk.last ? ret == Z_STREAM_END : (zs.avail_in == 0 && zs.avail_out != 0))
+		{
+			break;
+		}
+		if(zs.avail_out == 0)
+		{
+			packed.data.resize(packed.data.size() * 2);
+		}
+	}
+	deflateEnd(&zs);
+	packed.data.resize(written);
+	return packed;
+}
+
+/// same order and filtering as MMCZip::compressSubDir
+void collectEntries(const QString &dir, const QDir &origDir, const QString &prefix, const QString &zipFile,
+					const SeparatorPrefixTree<'/'> &blacklist, QList<Entry> &entries)
+{
+	QDir directory(dir);
+	if(directory != origDir)
+	{
+		QString internalDirName = origDir.relativeFilePath(dir);
+		if(!blacklist.covers(internalDirName))
+		{
+			Entry entry;
+			entry.name = FS::PathCombine(prefix, internalDirName) + "/";
+			entry.path = dir;
+			entry.isDir = true;
+			QFileInfo info(dir);
+			entry.modified = info.lastModified();
+			entry.permissions = info.permissions();
+			entries.append(entry);
+		}
+	}
+
+	// links are left out, natives linked to a shared cache and the like don't belong to the instance
+	for(auto &file : directory.entryInfoList(QDir::AllDirs | QDir::NoDotAndDotDot | QDir::Hidden))
+	{
+		if(file.isDir() && !file.isSymLink())
+		{
+			collectEntries(file.absoluteFilePath(), origDir, prefix, zipFile, blacklist, entries);
+		}
+	}
+
+	for(auto &file : directory.entryInfoList(QDir::Files))
+	{
+		if(!file.isFile() || file.isSymLink() || file.absoluteFilePath() == zipFile)
+		{
+			continue;
+		}
+		QString filename = origDir.relativeFilePath(file.absoluteFilePath());
+		if(blacklist.covers(filename))
+		{
+			continue;
+		}
+		Entry entry;
+		entry.name = prefix.size() ? FS::PathCombine(prefix, filename) : filename;
+		entry.path = file.absoluteFilePath();
+		entry.size = file.size();
+		entry.store = ZipCompressTask::isCompressed(file.fileName());
+		entry.modified = file.lastModified();
+		entry.permissions = file.permissions();
+		entries.append(entry);
+	}
+}
+
+/// the header fields QuaZipNewInfo would fill in
+zip_fileinfo fileInfo(const Entry &entry)
+{
+	zip_fileinfo info;
+	memset(&info, 0, sizeof(info));
+	auto date = entry.modified.date();
+	auto time = entry.modified.time();
+	info.tmz_date.tm_year = date.year();
+	info.tmz_date.tm_mon = date.month() - 1;
+	info.tmz_date.tm_mday = date.day();
+	info.tmz_date.tm_hour = time.hour();
+	info.tmz_date.tm_min = time.minute();
+	info.tmz_date.tm_sec = time.second();
+
+	quint32 mode = entry.isDir ? 0040000 : 0100000;
+	auto perm = entry.permissions;
+	mode |= (perm & QFile::ReadOwner) ? 0400 : 0;
+	mode |= (perm & QFile::WriteOwner) ? 0200 : 0;
+	mode |= (perm & QFile::ExeOwner) ? 0100 : 0;
+	mode |= (perm & QFile::ReadGroup) ? 0040 : 0;
+	mode |= (perm & QFile::WriteGroup) ? 0020 : 0;
+	mode |= (perm & QFile::ExeGroup) ? 0010 : 0;
+	mode |= (perm & QFile::ReadOther) ? 0004 : 0;
+	mode |= (perm & QFile::WriteOther) ? 0002 : 0;
+	mode |= (perm & QFile::ExeOther) ? 0001 : 0;
+	info.external_fa = mode << 16;
+	return info;
+}
+
+}
+
+ZipCompressTask::ZipCompressTask(const QString &zipFile, const QString &dir, const QString &prefix,
+								 const SeparatorPrefixTree<'/'> &blacklist, QObject *parent)
+	: Task(parent), m_zipFile(zipFile), m_dir(dir), m_prefix(prefix), m_blacklist(blacklist), m_aborted(false)
+{
+	connect(&m_watcher, &QFutureWatcher<QString>::finished, this, &ZipCompressTask::compressFinished);
+}
+
+ZipCompressTask::~ZipCompressTask()
+{
+	m_aborted = true;
+	m_watcher.waitForFinished();
+}
+
+void ZipCompressTask::setCompressionLevel(int level)
+{
+	m_level = qBound(0, level, 9);
+}
+
+bool ZipCompressTask::isCompressed(const QString &fileName)
+{
+	static const QSet<QString> compressedSuffixes = {
+		"jar", "zip", "litemod", "mcpack", "gz", "tgz", "xz", "lzma", "bz2", "7z", "rar",
+		"png", "jpg", "jpeg", "gif", "webp", "ogg", "mp3", "mp4", "webm"
+	};
+	return compressedSuffixes.contains(QFileInfo(fileName).suffix().toLower());
+}
+
+bool ZipCompressTask::abort()
+{
+	m_aborted = true;
+	return true;
+}
+
+void ZipCompressTask::executeTask()
+{
+	setStatus(tr("Compressing files..."));
+	m_watcher.setFuture(QtConcurrent::run(this, &ZipCompressTask::compress));
+}
+
+void ZipCompressTask::compressFinished()
+{
+	auto error = m_watcher.result();
+	if(!error.isEmpty())
+	{
+		emitFailed(error);
+		return;
+	}
+	emitSucceeded();
+}
+
+QString ZipCompressTask::compress()
+{
+	QDir origDir(m_dir);
+	if(!origDir.exists())
+	{
+		return tr("The folder '%1' doesn't exist").arg(m_dir);
+	}
+	QList<Entry> entries;
+	collectEntries(m_dir, origDir, m_prefix, QFileInfo(m_zipFile).absoluteFilePath(), m_blacklist, entries);
+
+	QList<Chunk> chunks;
+	qint64 total = 0;
+	for(int i = 0; i < entries.size(); i++)
+	{
+		auto &entry = entries[i];
+		if(m_level == 0)
+		{
+			entry.store = true;
+		}
+		if(entry.isDir)
+		{
+			continue;
+		}
+		total += entry.size;
+		qint64 offset = 0;
+		do
+		{
+			Chunk chunk;
+			chunk.entry = i;
+			chunk.offset = offset;
+			chunk.length = qMin(chunkSize, entry.size - offset);
+			offset += chunk.length;
+			chunk.last = offset >= entry.size;
+			chunks.append(chunk);
+		} while(offset < entry.size);
+	}
+
+	FS::ensureFolderPathExists(QFileInfo(m_zipFile).absolutePath());
+	QuaZip zip(m_zipFile);
+	if(!zip.open(QuaZip::mdCreate))
+	{
+		QFile::remove(m_zipFile);
+		return tr("Couldn't create '%1'").arg(m_zipFile);
+	}
+	auto zf = zip.getZipFile();
+	auto codec = zip.getFileNameCodec();
+
+	// a private pool, the writer may be sitting in the global one
+	QThreadPool pool;
+	const int window = qMax(2, pool.maxThreadCount() * 4);
+	QQueue<QFuture<PackedChunk>> inFlight;
+	int nextChunk = 0;
+	auto fill = [&]()
+	{
+		while(inFlight.size() < window && nextChunk < chunks.size())
+		{
+			const auto &chunk = chunks[nextChunk++];
+			inFlight.enqueue(QtConcurrent::run(&pool, packChunk, entries[chunk.entry], chunk, m_level));
+		}
+	};
+
+	QString error;
+	qint64 done = 0;
+	int currentEntry = -1;
+	quint32 crc = 0;
+	auto openEntry = [&](const Entry &entry, int method, int raw)
+	{
+		auto info = fileInfo(entry);
+		auto name = codec->fromUnicode(entry.name);
+		return zipOpenNewFileInZip3_64(zf, name.constData(), &info, nullptr, 0, nullptr, 0, nullptr, method,
+									   method ? m_level : 0, raw, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY, nullptr, 0,
+									   entry.size >= 0xffffffffLL) == ZIP_OK;
+	};
+
+	fill();
+	for(int i = 0; i < entries.size() && error.isEmpty(); i++)
+	{
+		if(m_aborted)
+		{
+			error = tr("Export was aborted.");
+			break;
+		}
+		const auto &entry = entries[i];
+		if(entry.isDir)
+		{
+			if(!openEntry(entry, 0, 0) || zipCloseFileInZip(zf) != ZIP_OK)
+			{
+				error = tr("Couldn't add '%1' to the zip file").arg(entry.name);
+			}
+			continue;
+		}
+		if(!openEntry(entry, entry.store ? 0 : Z_DEFLATED, 1))
+		{
+			error = tr("Couldn't add '%1' to the zip file").arg(entry.name);
+			break;
+		}
+		currentEntry = i;
+		crc = crc32(0, nullptr, 0);
+		while(!inFlight.isEmpty() && chunks[nextChunk - inFlight.size()].entry == currentEntry)
+		{
+			if(m_aborted)
+			{
+				error = tr("Export was aborted.");
+				break;
+			}
+			auto future = inFlight.dequeue();
+			fill();
+			auto packed = future.result();
+			if(!packed.error.isEmpty())
+			{
+				error = packed.error;
+				break;
+			}
+			if(zipWriteInFileInZip(zf, packed.data.constData(), packed.data.size()) != ZIP_OK)
+			{
+				error = tr("Couldn't write to '%1'").arg(m_zipFile);
+				break;
+			}
+			crc = crc32_combine(crc, packed.crc, packed.length);
+			done += packed.length;
+			QMetaObject::invokeMethod(this, "setProgress", Qt::QueuedConnection, Q_ARG(qint64, done), Q_ARG(qint64, total));
+		}
+		if(zipCloseFileInZipRaw64(zf, entry.size, crc) != ZIP_OK && error.isEmpty())
+		{
+			error = tr("Couldn't write to '%1'").arg(m_zipFile);
+		}
+	}
+
+	// let the workers run dry before the entries they point at go away
+	for(auto &future : inFlight)
+	{
+		future.waitForFinished();
+	}
+	zip.close();
+	if(error.isEmpty() && zip.getZipError() != 0)
+	{
+		error = tr("Couldn't write to '%1'").arg(m_zipFile);
+	}
+	if(!error.isEmpty())
+	{
+		QFile::remove(m_zipFile);
+	}
+	return error;
+}
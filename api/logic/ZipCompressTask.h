@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QString>
+#include <QFutureWatcher>
+#include <atomic>
+
+#include "tasks/Task.h"
+#include "SeparatorPrefixTree.h"
+
+#include "multimc_logic_export.h"
+
+/**
+ * Packs a folder into a zip file, like MMCZip::compressDir, without tying up the GUI thread.
+ *
+ * Files are cut into chunks that are read and deflated by a pool of worker threads.
+ * One writer puts the chunks into the zip in order, so the output is the same no matter how the work was split.
+ * Files that are compressed already (jars, images, sounds, archives) are stored as they are.
+ */
+class MULTIMC_LOGIC_EXPORT ZipCompressTask : public Task
+{
+	Q_OBJECT
+public:
+	/// same arguments as MMCZip::compressDir
+	ZipCompressTask(const QString &zipFile, const QString &dir, const QString &prefix = QString(),
+					const SeparatorPrefixTree<'/'> &blacklist = SeparatorPrefixTree<'/'>(), QObject *parent = nullptr);
+	virtual ~ZipCompressTask();
+
+	/// zlib compression level, 0 stores everything. Defaults to 6.
+	void setCompressionLevel(int level);
+
+	/// Would this file be stored rather than deflated?
+	static bool isCompressed(const QString &fileName);
+
+	virtual bool canAbort() const override
+	{
+		return true;
+	}
+
+public slots:
+	virtual bool abort() override;
+
+protected:
+	virtual void executeTask() override;
+
+private slots:
+	void compressFinished();
+
+private:
+	QString compress();
+
+private:
+	QString m_zipFile;
+	QString m_dir;
+	QString m_prefix;
+	SeparatorPrefixTree<'/'> m_blacklist;
+	int m_level = 6;
+	std::atomic<bool> m_aborted;
+	QFutureWatcher<QString> m_watcher;
+};
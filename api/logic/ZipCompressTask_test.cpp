@@ -0,0 +1,169 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <quazip.h>
+#include <quazipfile.h>
+
+#include "ZipCompressTask.h"
+#include "FileSystem.h"
+
+class ZipCompressTaskTest : public QObject
+{
+	Q_OBJECT
+
+	static QByteArray text(int size)
+	{
+		QByteArray data;
+		int i = 0;
+		while(data.size() < size)
+		{
+			data += QByteArray::number(i++) + " lines of a log file\n";
+		}
+		data.resize(size);
+		return data;
+	}
+
+	static bool run(ZipCompressTask &task)
+	{
+		QSignalSpy finished(&task, SIGNAL(finished()));
+		task.start();
+		if(!finished.count() && !finished.wait(30000))
+		{
+			return false;
+		}
+		return task.successful();
+	}
+
+	/// name -> (method, contents) of everything in the zip, checking every CRC on the way
+	static QMap<QString, QPair<int, QByteArray>> readZip(const QString &path)
+	{
+		QMap<QString, QPair<int, QByteArray>> result;
+		QuaZip zip(path);
+		if(!zip.open(QuaZip::mdUnzip))
+		{
+			return result;
+		}
+		for(bool more = zip.goToFirstFile(); more; more = zip.goToNextFile())
+		{
+			QuaZipFile file(&zip);
+			int method = -1;
+			int level = 0;
+			if(!file.open(QIODevice::ReadOnly, &method, &level, false))
+			{
+				continue;
+			}
+			auto data = file.readAll();
+			file.close();
+			if(file.getZipError() != UNZ_OK)
+			{
+				continue;
+			}
+			result[zip.getCurrentFileName()] = qMakePair(method, data);
+		}
+		return result;
+	}
+
+	QTemporaryDir m_dir;
+	QString m_source;
+
+private
+slots:
+	void initTestCase()
+	{
+		m_source = FS::PathCombine(m_dir.path(), "instance");
+		QVERIFY(FS::ensureFolderPathExists(FS::PathCombine(m_source, "minecraft", "mods")));
+		QVERIFY(FS::ensureFolderPathExists(FS::PathCombine(m_source, "minecraft", "saves", "world")));
+		FS::write(FS::PathCombine(m_source, "instance.cfg"), "name=Test\n");
+		FS::write(FS::PathCombine(m_source, "empty.txt"), QByteArray());
+		// spans several chunks
+		FS::write(FS::PathCombine(m_source, "minecraft", "latest.log"), text(5 * 1024 * 1024 + 17));
+		FS::write(FS::PathCombine(m_source, "minecraft", "mods", "mod.jar"), text(3000));
+		FS::write(FS::PathCombine(m_source, "minecraft", "saves", "world", "level.dat"), text(100));
+	}
+
+	void test_compress()
+	{
+		auto output = FS::PathCombine(m_dir.path(), "out", "export.zip");
+		ZipCompressTask task(output, m_source, "Test", SeparatorPrefixTree<'/'>(QStringList{"minecraft/saves"}));
+		QSignalSpy progress(&task, SIGNAL(progress(qint64, qint64)));
+		QVERIFY(run(task));
+
+		auto contents = readZip(output);
+		QCOMPARE(contents.size(), 6);
+		QVERIFY(contents.contains("Test/minecraft/"));
+		QVERIFY(contents.contains("Test/minecraft/mods/"));
+		QVERIFY(!contents.contains("Test/minecraft/saves/"));
+		QVERIFY(!contents.contains("Test/minecraft/saves/world/level.dat"));
+
+		QCOMPARE(contents["Test/instance.cfg"].second, QByteArray("name=Test\n"));
+		QCOMPARE(contents["Test/empty.txt"].second, QByteArray());
+		auto log = contents["Test/minecraft/latest.log"];
+		QCOMPARE(log.first, Z_DEFLATED);
+		QCOMPARE(log.second, text(5 * 1024 * 1024 + 17));
+		// already compressed files are stored
+		auto jar = contents["Test/minecraft/mods/mod.jar"];
+		QCOMPARE(jar.first, 0);
+		QCOMPARE(jar.second, text(3000));
+
+		QVERIFY(QFileInfo(output).size() < 1024 * 1024);
+		QVERIFY(progress.count());
+		QCOMPARE(progress.last()[0].toLongLong(), progress.last()[1].toLongLong());
+	}
+
+	void test_store()
+	{
+		auto output = FS::PathCombine(m_dir.path(), "stored.zip");
+		ZipCompressTask task(output, m_source);
+		task.setCompressionLevel(0);
+		QVERIFY(run(task));
+		auto contents = readZip(output);
+		QCOMPARE(contents["minecraft/latest.log"].first, 0);
+		QCOMPARE(contents["minecraft/latest.log"].second, text(5 * 1024 * 1024 + 17));
+		QCOMPARE(contents["minecraft/saves/world/level.dat"].second, text(100));
+	}
+
+	void test_symlinks()
+	{
+#if defined Q_OS_WIN32
+		QSKIP("Symbolic links need extra privileges on Windows");
+#else
+		auto source = FS::PathCombine(m_dir.path(), "linked");
+		auto shared = FS::PathCombine(m_dir.path(), "shared");
+		QVERIFY(FS::ensureFolderPathExists(source));
+		QVERIFY(FS::ensureFolderPathExists(shared));
+		FS::write(FS::PathCombine(shared, "lib.so"), text(100));
+		FS::write(FS::PathCombine(source, "instance.cfg"), "name=Test\n");
+		QVERIFY(QFile::link(shared, FS::PathCombine(source, "natives")));
+		QVERIFY(QFile::link(FS::PathCombine(shared, "lib.so"), FS::PathCombine(source, "lib.so")));
+
+		auto output = FS::PathCombine(m_dir.path(), "linked.zip");
+		ZipCompressTask task(output, source);
+		QVERIFY(run(task));
+		auto contents = readZip(output);
+		QCOMPARE(contents.keys(), QStringList({"instance.cfg"}));
+#endif
+	}
+
+	void test_abort()
+	{
+		auto output = FS::PathCombine(m_dir.path(), "aborted.zip");
+		ZipCompressTask task(output, m_source);
+		task.abort();
+		QVERIFY(!run(task));
+		QVERIFY(!QFile::exists(output));
+	}
+
+	void test_isCompressed()
+	{
+		QVERIFY(ZipCompressTask::isCompressed("forge.jar"));
+		QVERIFY(ZipCompressTask::isCompressed("icon.PNG"));
+		QVERIFY(ZipCompressTask::isCompressed("library.jar.pack.xz"));
+		QVERIFY(!ZipCompressTask::isCompressed("options.txt"));
+		QVERIFY(!ZipCompressTask::isCompressed("level.dat"));
+	}
+};
+
+QTEST_GUILESS_MAIN(ZipCompressTaskTest)
+
+#include "ZipCompressTask_test.moc"
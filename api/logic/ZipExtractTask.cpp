@@ -0,0 +1,315 @@
+#include "ZipExtractTask.h"
+#include "FileSystem.h"
+
+#include <quazip.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QCryptographicHash>
+#include <QTextCodec>
+#include <QThreadPool>
+#include <QMutex>
+#include <QSet>
+#include <QDebug>
+#include <QtConcurrentRun>
+#include <algorithm>
+
+namespace {
+
+struct Entry
+{
+	QString name;
+	QString path;
+	unz64_file_pos pos;
+	qint64 size = 0;
+	QFile::Permissions permissions;
+};
+
+/// what QuaZipFileInfo64::getPermissions makes of the unix mode bits
+QFile::Permissions permissionsOf(quint32 externalAttr)
+{
+	quint32 mode = externalAttr >> 16;
+	QFile::Permissions perm;
+	perm |= (mode & 0400) ? (QFile::ReadOwner | QFile::ReadUser) : QFile::Permissions();
+	perm |= (mode & 0200) ? (QFile::WriteOwner | QFile::WriteUser) : QFile::Permissions();
+	perm |= (mode & 0100) ? (QFile::ExeOwner | QFile::ExeUser) : QFile::Permissions();
+	perm |= (mode & 0040) ? QFile::ReadGroup : QFile::Permissions();
+	perm |= (mode & 0020) ? QFile::WriteGroup : QFile::Permissions();
+	perm |= (mode & 0010) ? QFile::ExeGroup : QFile::Permissions();
+	perm |= (mode & 0004) ? QFile::ReadOther : QFile::Permissions();
+	perm |= (mode & 0002) ? QFile::WriteOther : QFile::Permissions();
+	perm |= (mode & 0001) ? QFile::ExeOther : QFile::Permissions();
+	return perm;
+}
+
+}
+
+ZipExtractTask::ZipExtractTask(const QString &zipFile, const QString &target, const QString &subdir, QObject *parent)
+	: Task(parent), m_zipFile(zipFile), m_target(target), m_subdir(subdir), m_aborted(false)
+{
+	connect(&m_watcher, &QFutureWatcher<QString>::finished, this, &ZipExtractTask::extractFinished);
+}
+
+ZipExtractTask::~ZipExtractTask()
+{
+	m_aborted = true;
+	m_watcher.waitForFinished();
+}
+
+void ZipExtractTask::setExpectedHashes(const QHash<QString, QByteArray> &hashes)
+{
+	m_hashes = hashes;
+}
+
+bool ZipExtractTask::abort()
+{
+	m_aborted = true;
+	return true;
+}
+
+bool ZipExtractTask::extract()
+{
+	m_failReason = run();
+	return m_failReason.isEmpty();
+}
+
+void ZipExtractTask::executeTask()
+{
+	setStatus(tr("Extracting files..."));
+	m_watcher.setFuture(QtConcurrent::run(this, &ZipExtractTask::run));
+}
+
+void ZipExtractTask::extractFinished()
+{
+	auto error = m_watcher.result();
+	if(!error.isEmpty())
+	{
+		emitFailed(error);
+		return;
+	}
+	emitSucceeded();
+}
+
+QString ZipExtractTask::run()
+{
+	m_extracted.clear();
+
+	// one pass over the central directory
+	QuaZip zip(m_zipFile);
+	if(!zip.open(QuaZip::mdUnzip))
+	{
+		return tr("Couldn't open '%1'").arg(m_zipFile);
+	}
+	auto uf = zip.getUnzFile();
+	auto codec = zip.getFileNameCodec();
+
+	const QString root = QDir::cleanPath(QDir(m_target).absolutePath());
+	QList<Entry> entries;
+	QHash<QString, int> byPath;
+	QSet<QString> folders;
+	bool matched = false;
+	for(int ret = unzGoToFirstFile(uf); ret == UNZ_OK; ret = unzGoToNextFile(uf))
+	{
+		unz_file_info64 info;
+		char nameBuffer[4096];
+		if(unzGetCurrentFileInfo64(uf, &info, nameBuffer, sizeof(nameBuffer), nullptr, 0, nullptr, 0) != UNZ_OK)
+		{
+			return tr("'%1' is damaged").arg(m_zipFile);
+		}
+		QByteArray rawName(nameBuffer, qMin<int>(info.size_filename, sizeof(nameBuffer) - 1));
+		// bit 11 says the name is UTF-8, whatever the codec thinks
+		QString name = (info.flag & 0x800) ? QString::fromUtf8(rawName) : codec->toUnicode(rawName);
+		if(!name.startsWith(m_subdir))
+		{
+			continue;
+		}
+		matched = true;
+		name.remove(0, m_subdir.size());
+
+		QString path = QDir::cleanPath(root + "/" + name);
+		if(path != root && !path.startsWith(root + "/"))
+		{
+			return tr("'%1' tries to write outside of the folder it is extracted into").arg(name);
+		}
+		if(name.isEmpty() || name.endsWith('/'))
+		{
+			folders.insert(path);
+			continue;
+		}
+		folders.insert(QFileInfo(path).absolutePath());
+
+		Entry entry;
+		entry.name = name;
+		entry.path = path;
+		entry.size = info.uncompressed_size;
+		entry.permissions = permissionsOf(info.external_fa);
+		unzGetFilePos64(uf, &entry.pos);
+		// the last one with the same name wins, like extracting them one by one would
+		if(byPath.contains(path))
+		{
+			entries[byPath[path]] = entry;
+		}
+		else
+		{
+			byPath[path] = entries.size();
+			entries.append(entry);
+		}
+	}
+	zip.close();
+	if(!matched)
+	{
+		return tr("There is nothing to extract in '%1'").arg(m_zipFile);
+	}
+	for(auto iter = m_hashes.begin(); iter != m_hashes.end(); iter++)
+	{
+		if(!byPath.contains(QDir::cleanPath(root + "/" + iter.key())))
+		{
+			return tr("'%1' is missing from the archive").arg(iter.key());
+		}
+	}
+
+	// make all the folders first, shortest path first so each mkpath has little to do
+	auto sortedFolders = folders.toList();
+	std::sort(sortedFolders.begin(), sortedFolders.end(), [](const QString &a, const QString &b)
+	{
+		return a.size() < b.size();
+	});
+	for(auto &folder : sortedFolders)
+	{
+		if(!FS::ensureFolderPathExists(folder))
+		{
+			return tr("Couldn't create the folder '%1'").arg(folder);
+		}
+	}
+
+	// the big ones first, so one large jar doesn't get started last
+	std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b)
+	{
+		return a.size > b.size;
+	});
+	qint64 total = 0;
+	for(auto &entry : entries)
+	{
+		total += entry.size;
+	}
+
+	QMutex mutex;
+	QString error;
+	QStringList extracted;
+	std::atomic<int> next(0);
+	std::atomic<qint64> done(0);
+	auto fail = [&](const QString &reason)
+	{
+		QMutexLocker locker(&mutex);
+		if(error.isEmpty())
+		{
+			error = reason;
+		}
+		m_aborted = true;
+	};
+	auto report = [&](qint64 bytes)
+	{
+		const qint64 step = 4 * 1024 * 1024;
+		auto before = done.fetch_add(bytes);
+		if(before / step != (before + bytes) / step || before + bytes == total)
+		{
+			QMetaObject::invokeMethod(this, "setProgress", Qt::QueuedConnection, Q_ARG(qint64, before + bytes), Q_ARG(qint64, total));
+		}
+	};
+
+	// each worker has its own handle on the zip and takes the next entry until there are none left
+	auto worker = [&]()
+	{
+		QuaZip workerZip(m_zipFile);
+		if(!workerZip.open(QuaZip::mdUnzip))
+		{
+			fail(tr("Couldn't open '%1'").arg(m_zipFile));
+			return;
+		}
+		auto wf = workerZip.getUnzFile();
+		QByteArray buffer(256 * 1024, Qt::Uninitialized);
+		for(int i = next++; i < entries.size() && !m_aborted; i = next++)
+		{
+			auto &entry = entries[i];
+			auto expected = m_hashes.value(entry.name);
+			QCryptographicHash hash(QCryptographicHash::Sha1);
+			if(unzGoToFilePos64(wf, &entry.pos) != UNZ_OK || unzOpenCurrentFile(wf) != UNZ_OK)
+			{
+				fail(tr("Couldn't read '%1' from the archive").arg(entry.name));
+				return;
+			}
+			QFile out(entry.path);
+			if(!out.open(QIODevice::WriteOnly))
+			{
+				unzCloseCurrentFile(wf);
+				fail(tr("Couldn't write '%1'").arg(entry.path));
+				return;
+			}
+			{
+				QMutexLocker locker(&mutex);
+				extracted.append(entry.path);
+			}
+			int read;
+			while((read = unzReadCurrentFile(wf, buffer.data(), buffer.size())) > 0 && !m_aborted)
+			{
+				if(out.write(buffer.constData(), read) != read)
+				{
+					read = -1;
+					break;
+				}
+				if(!expected.isEmpty())
+				{
+					hash.addData(buffer.constData(), read);
+				}
+				report(read);
+			}
+			out.close();
+			// this is also where a bad CRC shows up
+			if(unzCloseCurrentFile(wf) != UNZ_OK || read < 0)
+			{
+				fail(tr("Couldn't extract '%1', the archive may be damaged").arg(entry.name));
+				return;
+			}
+			if(m_aborted)
+			{
+				return;
+			}
+			if(!expected.isEmpty() && hash.result().toHex() != expected.toLower())
+			{
+				fail(tr("'%1' doesn't match its expected hash").arg(entry.name));
+				return;
+			}
+			if(entry.permissions)
+			{
+				out.setPermissions(entry.permissions);
+			}
+		}
+	};
+
+	if(!m_aborted)
+	{
+		QThreadPool pool;
+		const int workers = qMin(pool.maxThreadCount(), entries.size());
+		for(int i = 0; i < workers; i++)
+		{
+			QtConcurrent::run(&pool, worker);
+		}
+		pool.waitForDone();
+	}
+
+	if(m_aborted && error.isEmpty())
+	{
+		error = tr("Extraction was aborted.");
+	}
+	if(!error.isEmpty())
+	{
+		for(auto &file : extracted)
+		{
+			QFile::remove(file);
+		}
+		return error;
+	}
+	m_extracted = extracted;
+	return QString();
+}
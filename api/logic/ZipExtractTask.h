@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QString>
+#include <QHash>
+#include <QFutureWatcher>
+#include <atomic>
+
+#include "tasks/Task.h"
+
+#include "multimc_logic_export.h"
+
+/**
+ * Extracts a zip file, or one folder inside it, like MMCZip::extractSubDir.
+ *
+ * The central directory is read once, entries that would land outside of the target are refused,
+ * and all the folders are made up front. A few workers then inflate the entries in parallel,
+ * each with its own handle on the zip, largest entries first.
+ */
+class MULTIMC_LOGIC_EXPORT ZipExtractTask : public Task
+{
+	Q_OBJECT
+public:
+	/// extract the entries of zipFile that start with subdir into target, with subdir cut off their names
+	ZipExtractTask(const QString &zipFile, const QString &target, const QString &subdir = QString(), QObject *parent = nullptr);
+	virtual ~ZipExtractTask();
+
+	/// hex SHA-1 of files that have to be in the archive, by their name relative to subdir
+	void setExpectedHashes(const QHash<QString, QByteArray> &hashes);
+
+	/**
+	 * Extract right here, without an event loop. The entries are still inflated in parallel.
+	 * On failure, everything written so far is removed and the reason is in failReason().
+	 */
+	bool extract();
+
+	/// full paths of the extracted files
+	QStringList extractedFiles() const
+	{
+		return m_extracted;
+	}
+
+	virtual bool canAbort() const override
+	{
+		return true;
+	}
+
+public slots:
+	virtual bool abort() override;
+
+protected:
+	virtual void executeTask() override;
+
+private slots:
+	void extractFinished();
+
+private:
+	QString run();
+
+private:
+	QString m_zipFile;
+	QString m_target;
+	QString m_subdir;
+	QHash<QString, QByteArray> m_hashes;
+	QStringList m_extracted;
+	std::atomic<bool> m_aborted;
+	QFutureWatcher<QString> m_watcher;
+};
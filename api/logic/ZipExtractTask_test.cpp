@@ -0,0 +1,143 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QCryptographicHash>
+
+#include <quazip.h>
+#include <quazipfile.h>
+
+#include "ZipExtractTask.h"
+#include "FileSystem.h"
+
+class ZipExtractTaskTest : public QObject
+{
+	Q_OBJECT
+
+	static QByteArray text(int size)
+	{
+		QByteArray data;
+		int i = 0;
+		while(data.size() < size)
+		{
+			data += QByteArray::number(i++) + " lines of a log file\n";
+		}
+		data.resize(size);
+		return data;
+	}
+
+	static bool makeZip(const QString &path, const QList<QPair<QString, QByteArray>> &files)
+	{
+		QuaZip zip(path);
+		if(!zip.open(QuaZip::mdCreate))
+		{
+			return false;
+		}
+		for(auto &file : files)
+		{
+			QuaZipFile out(&zip);
+			if(!out.open(QIODevice::WriteOnly, QuaZipNewInfo(file.first)))
+			{
+				return false;
+			}
+			out.write(file.second);
+			out.close();
+		}
+		zip.close();
+		return zip.getZipError() == 0;
+	}
+
+	QTemporaryDir m_dir;
+	QString m_zip;
+
+private
+slots:
+	void initTestCase()
+	{
+		m_zip = FS::PathCombine(m_dir.path(), "pack.zip");
+		QList<QPair<QString, QByteArray>> files = {
+			{"pack/", QByteArray()},
+			{"pack/instance.cfg", "name=Pack\n"},
+			{"pack/minecraft/mods/", QByteArray()},
+			{"pack/minecraft/latest.log", text(3 * 1024 * 1024)},
+			{"pack/minecraft/config/deep/nested/file.cfg", "a=b\n"},
+			{"other/readme.txt", "not in the pack\n"}
+		};
+		for(int i = 0; i < 100; i++)
+		{
+			files.append({QString("pack/minecraft/config/file%1.cfg").arg(i), text(i * 37)});
+		}
+		QVERIFY(makeZip(m_zip, files));
+	}
+
+	void test_extractAll()
+	{
+		QTemporaryDir target;
+		ZipExtractTask task(m_zip, target.path());
+		QSignalSpy finished(&task, SIGNAL(finished()));
+		task.start();
+		QVERIFY(finished.count() || finished.wait(30000));
+		QVERIFY(task.successful());
+		QCOMPARE(task.extractedFiles().size(), 104);
+		QCOMPARE(FS::read(FS::PathCombine(target.path(), "pack", "minecraft", "latest.log")), text(3 * 1024 * 1024));
+		QCOMPARE(FS::read(FS::PathCombine(target.path(), "other", "readme.txt")), QByteArray("not in the pack\n"));
+		QVERIFY(QFileInfo(FS::PathCombine(target.path(), "pack", "minecraft", "mods")).isDir());
+	}
+
+	void test_extractSubDir()
+	{
+		QTemporaryDir target;
+		ZipExtractTask task(m_zip, target.path(), "pack/");
+		QVERIFY(task.extract());
+		QCOMPARE(FS::read(FS::PathCombine(target.path(), "instance.cfg")), QByteArray("name=Pack\n"));
+		QCOMPARE(FS::read(FS::PathCombine(target.path(), "minecraft", "config", "deep", "nested", "file.cfg")), QByteArray("a=b\n"));
+		QCOMPARE(FS::read(FS::PathCombine(target.path(), "minecraft", "config", "file99.cfg")), text(99 * 37));
+		QVERIFY(!QFileInfo::exists(FS::PathCombine(target.path(), "other")));
+	}
+
+	void test_hashes()
+	{
+		QTemporaryDir target;
+		ZipExtractTask good(m_zip, target.path(), "pack/");
+		good.setExpectedHashes({{"instance.cfg", QCryptographicHash::hash("name=Pack\n", QCryptographicHash::Sha1).toHex()}});
+		QVERIFY(good.extract());
+
+		QTemporaryDir badTarget;
+		ZipExtractTask bad(m_zip, badTarget.path(), "pack/");
+		bad.setExpectedHashes({{"instance.cfg", QCryptographicHash::hash("name=Other\n", QCryptographicHash::Sha1).toHex()}});
+		QVERIFY(!bad.extract());
+		QVERIFY(!QFileInfo::exists(FS::PathCombine(badTarget.path(), "instance.cfg")));
+
+		ZipExtractTask missing(m_zip, badTarget.path(), "pack/");
+		missing.setExpectedHashes({{"icon.png", "00"}});
+		QVERIFY(!missing.extract());
+	}
+
+	void test_outsideTarget()
+	{
+		auto path = FS::PathCombine(m_dir.path(), "evil.zip");
+		QVERIFY(makeZip(path, {{"fine.txt", "fine"}, {"../../escaped.txt", "gotcha"}}));
+		QTemporaryDir target;
+		ZipExtractTask task(path, FS::PathCombine(target.path(), "a", "b"));
+		QVERIFY(!task.extract());
+		QVERIFY(!QFileInfo::exists(FS::PathCombine(target.path(), "escaped.txt")));
+		QVERIFY(!QFileInfo::exists(FS::PathCombine(target.path(), "a", "b", "fine.txt")));
+	}
+
+	void test_damaged()
+	{
+		auto path = FS::PathCombine(m_dir.path(), "damaged.zip");
+		QVERIFY(makeZip(path, {{"log.txt", text(100000)}}));
+		// flip a byte in the middle of the compressed data
+		auto data = FS::read(path);
+		data[data.size() / 2] = data[data.size() / 2] ^ 0x55;
+		FS::write(path, data);
+		QTemporaryDir target;
+		ZipExtractTask task(path, target.path());
+		QVERIFY(!task.extract());
+		QVERIFY(!QFileInfo::exists(FS::PathCombine(target.path(), "log.txt")));
+	}
+};
+
+QTEST_GUILESS_MAIN(ZipExtractTaskTest)
+
+#include "ZipExtractTask_test.moc"
@@ -0,0 +1,153 @@
+#include "CensorFilter.h"
+
+#include <QQueue>
+#include <algorithm>
+
+namespace
+{
+inline quint64 edgeKey(int state, ushort c)
+{
+	return (quint64(state) << 16) | c;
+}
+
+struct Match
+{
+	int start;
+	int length;
+	int pattern;
+};
+}
+
+CensorFilter::CensorFilter(const QMap<QString, QString> &filter)
+{
+	m_nodes.append(Node());
+	for(auto iter = filter.begin(); iter != filter.end(); iter++)
+	{
+		const auto & key = iter.key();
+		if(key.isEmpty())
+		{
+			continue;
+		}
+		int state = 0;
+		for(auto c: key)
+		{
+			auto edge = edgeKey(state, c.unicode());
+			auto found = m_edges.find(edge);
+			if(found == m_edges.end())
+			{
+				m_nodes.append(Node());
+				found = m_edges.insert(edge, m_nodes.size() - 1);
+			}
+			state = *found;
+		}
+		m_nodes[state].match = m_replacements.size();
+		m_nodes[state].matchLength = key.size();
+		m_replacements.append(iter.value());
+		m_firstChars.set(key[0].unicode());
+	}
+
+	// breadth first, so the fail target of a node is always done before the node itself
+	QQueue<int> queue;
+	QVector<QVector<QPair<ushort, int>>> children(m_nodes.size());
+	for(auto iter = m_edges.begin(); iter != m_edges.end(); iter++)
+	{
+		children[int(iter.key() >> 16)].append(qMakePair(ushort(iter.key() & 0xFFFF), iter.value()));
+	}
+	for(auto & child: children[0])
+	{
+		queue.enqueue(child.second);
+	}
+	while(!queue.isEmpty())
+	{
+		int state = queue.dequeue();
+		for(auto & child: children[state])
+		{
+			auto & node = m_nodes[child.second];
+			node.fail = next(m_nodes[state].fail, child.first);
+			auto & failNode = m_nodes[node.fail];
+			node.output = failNode.match != -1 ? node.fail : failNode.output;
+			queue.enqueue(child.second);
+		}
+	}
+}
+
+bool CensorFilter::isEmpty() const
+{
+	return m_replacements.isEmpty();
+}
+
+int CensorFilter::next(int state, ushort c) const
+{
+	while(true)
+	{
+		auto found = m_edges.constFind(edgeKey(state, c));
+		if(found != m_edges.constEnd())
+		{
+			return *found;
+		}
+		if(state == 0)
+		{
+			return 0;
+		}
+		state = m_nodes[state].fail;
+	}
+}
+
+QString CensorFilter::apply(const QString &in) const
+{
+	if(m_replacements.isEmpty())
+	{
+		return in;
+	}
+	QVector<Match> matches;
+	const QChar * data = in.constData();
+	const int size = in.size();
+	int state = 0;
+	for(int i = 0; i < size; i++)
+	{
+		ushort c = data[i].unicode();
+		if(state == 0 && !m_firstChars.test(c))
+		{
+			continue;
+		}
+		state = next(state, c);
+		// all of them, a shorter one may still be needed when a longer one overlaps an earlier match
+		int found = m_nodes[state].match != -1 ? state : m_nodes[state].output;
+		while(found != -1)
+		{
+			const auto & node = m_nodes[found];
+			matches.append({i - node.matchLength + 1, node.matchLength, node.match});
+			found = node.output;
+		}
+	}
+	if(matches.isEmpty())
+	{
+		return in;
+	}
+
+	// leftmost first, then longest
+	std::sort(matches.begin(), matches.end(), [](const Match & a, const Match & b)
+	{
+		if(a.start != b.start)
+		{
+			return a.start < b.start;
+		}
+		return a.length > b.length;
+	});
+	QString out;
+	out.reserve(size);
+	int pos = 0;
+	for(auto & match: matches)
+	{
+		if(match.start < pos)
+		{
+			// overlaps with something already replaced
+			continue;
+		}
+		out.append(data + pos, match.start - pos);
+		out.append(m_replacements[match.pattern]);
+		pos = match.start + match.length;
+	}
+	out.append(data + pos, size - pos);
+	return out;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QString>
+#include <QMap>
+#include <QHash>
+#include <QVector>
+#include <bitset>
+
+#include "multimc_logic_export.h"
+
+/**
+ * Replaces private strings (tokens, ids, names) in text with placeholders.
+ *
+ * All the strings are compiled into one Aho-Corasick automaton, so a line is scanned once
+ * no matter how many strings there are. Where matches overlap, the leftmost and then the longest one wins.
+ * Lines without anything to censor are returned as they are, without any allocation.
+ */
+class MULTIMC_LOGIC_EXPORT CensorFilter
+{
+public:
+	CensorFilter() = default;
+	explicit CensorFilter(const QMap<QString, QString> &filter);
+
+	QString apply(const QString &in) const;
+	bool isEmpty() const;
+
+private:
+	struct Node
+	{
+		int fail = 0;
+		// length and index of the string that ends in this node, if any
+		int matchLength = 0;
+		int match = -1;
+		// the closest node down the fail links that ends a string, so every string ending here is found
+		int output = -1;
+	};
+	int next(int state, ushort c) const;
+
+private:
+	QVector<Node> m_nodes;
+	QHash<quint64, int> m_edges;
+	QVector<QString> m_replacements;
+	std::bitset<65536> m_firstChars;
+};
@@ -0,0 +1,77 @@
+#include <QTest>
+
+#include "launch/CensorFilter.h"
+
+class CensorFilterTest : public QObject
+{
+	Q_OBJECT
+
+	static QMap<QString, QString> sessionFilter()
+	{
+		QMap<QString, QString> filter;
+		filter["0123abcd"] = "<ACCESS TOKEN>";
+		filter["ffee99"] = "<PROFILE ID>";
+		filter["token:0123abcd:ffee99"] = "<SESSION ID>";
+		filter["Steve"] = "<PROFILE NAME>";
+		filter["he"] = "<SHORT>";
+		filter["hers"] = "<LONG>";
+		return filter;
+	}
+
+private
+slots:
+	void test_apply_data()
+	{
+		QTest::addColumn<QString>("input");
+		QTest::addColumn<QString>("expected");
+
+		QTest::newRow("nothing") << "Loading tweak class" << "Loading tweak class";
+		QTest::newRow("empty") << "" << "";
+		QTest::newRow("token") << "--accessToken 0123abcd --uuid ffee99" << "--accessToken <ACCESS TOKEN> --uuid <PROFILE ID>";
+		QTest::newRow("longest wins") << "--session token:0123abcd:ffee99" << "--session <SESSION ID>";
+		QTest::newRow("repeated") << "Steve Steve Steve" << "<PROFILE NAME> <PROFILE NAME> <PROFILE NAME>";
+		QTest::newRow("adjacent") << "SteveSteve" << "<PROFILE NAME><PROFILE NAME>";
+		QTest::newRow("inner match") << "ushers" << "us<LONG>";
+		QTest::newRow("partial") << "0123abc Stev" << "0123abc Stev";
+		QTest::newRow("fail link") << "token:0123abcd!" << "token:<ACCESS TOKEN>!";
+	}
+	void test_apply()
+	{
+		QFETCH(QString, input);
+		QFETCH(QString, expected);
+
+		CensorFilter filter(sessionFilter());
+		QCOMPARE(filter.apply(input), expected);
+	}
+
+	void test_overlap()
+	{
+		// bcd overlaps ab, but cd inside of it still has to go
+		QMap<QString, QString> map;
+		map["ab"] = "<AB>";
+		map["bcd"] = "<BCD>";
+		map["cd"] = "<CD>";
+		CensorFilter filter(map);
+		QCOMPARE(filter.apply("abcd"), QString("<AB><CD>"));
+		QCOMPARE(filter.apply("xbcd"), QString("x<BCD>"));
+	}
+
+	void test_emptyFilter()
+	{
+		CensorFilter filter;
+		QVERIFY(filter.isEmpty());
+		QCOMPARE(filter.apply("Steve"), QString("Steve"));
+	}
+
+	void test_noCopy()
+	{
+		CensorFilter filter(sessionFilter());
+		QString line = "[14:02:11] [main/INFO]: Loading tweak class";
+		auto out = filter.apply(line);
+		QCOMPARE(out.constData(), line.constData());
+	}
+};
+
+QTEST_GUILESS_MAIN(CensorFilterTest)
+
+#include "CensorFilter_test.moc"
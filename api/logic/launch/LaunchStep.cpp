@@ -19,9 +19,23 @@
 void LaunchStep::bind(LaunchTask *parent)
 {
 	m_parent = parent;
+	// this has to be connected before onStepFinished, which may already start the next step
+	connect(this, &LaunchStep::finished, this, &LaunchStep::recordEndTime);
 	connect(this, &LaunchStep::readyForLaunch, parent, &LaunchTask::onReadyForLaunch);
 	connect(this, &LaunchStep::logLine, parent, &LaunchTask::onLogLine);
 	connect(this, &LaunchStep::logLines, parent, &LaunchTask::onLogLines);
 	connect(this, &LaunchStep::finished, parent, &LaunchTask::onStepFinished);
 	connect(this, &LaunchStep::progressReportingRequest, parent, &LaunchTask::onProgressReportingRequested);
 }
+
+void LaunchStep::start()
+{
+	m_startTime = m_parent->elapsed();
+	m_endTime = -1;
+	Task::start();
+}
+
+void LaunchStep::recordEndTime()
+{
+	m_endTime = m_parent->elapsed();
+}
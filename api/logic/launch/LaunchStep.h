@@ -31,6 +31,18 @@ public: /* methods */
 	};
 	virtual ~LaunchStep() {};
 
+	/// When this step started, in ms since the launch started. -1 if it never ran.
+	qint64 startTime() const
+	{
+		return m_startTime;
+	}
+
+	/// When this step finished, in ms since the launch started. -1 if it didn't finish.
+	qint64 endTime() const
+	{
+		return m_endTime;
+	}
+
 protected: /* methods */
 	virtual void bind(LaunchTask *parent);
 
@@ -42,7 +54,15 @@ signals:
 
 public slots:
 	virtual void proceed() {};
+	virtual void start() override;
+
+private slots:
+	void recordEndTime();
 
 protected: /* data */
 	LaunchTask *m_parent;
+
+private: /* data */
+	qint64 m_startTime = -1;
+	qint64 m_endTime = -1;
 };
\ No newline at end of file
@@ -20,12 +20,19 @@
 #include "MMCStrings.h"
 #include "java/JavaChecker.h"
 #include "tasks/Task.h"
+#include "FileSystem.h"
 #include <QDebug>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QDir>
 #include <QEventLoop>
 #include <QRegularExpression>
 #include <QCoreApplication>
 #include <QStandardPaths>
+#include <QtConcurrentRun>
 #include <assert.h>
 
 void LaunchTask::init()
@@ -42,6 +49,16 @@ std::shared_ptr<LaunchTask> LaunchTask::create(InstancePtr inst)
 
 LaunchTask::LaunchTask(InstancePtr instance): m_instance(instance)
 {
+	m_rateLimiter.setLinesPerSecond(m_instance->settings()->get("ConsoleMaxLinesPerSecond").toInt());
+	m_summaryTimer.setInterval(1000);
+	connect(&m_summaryTimer, &QTimer::timeout, this, &LaunchTask::onSummaryTimer);
+	// one writer keeps the lines in order
+	m_heldLogPool.setMaxThreadCount(1);
+}
+
+LaunchTask::~LaunchTask()
+{
+	m_heldLogPool.waitForDone();
 }
 
 void LaunchTask::appendStep(std::shared_ptr<LaunchStep> step)
@@ -56,6 +73,11 @@ void LaunchTask::prependStep(std::shared_ptr<LaunchStep> step)
 
 void LaunchTask::executeTask()
 {
+	m_launchTimer.start();
+	if(m_rateLimiter.linesPerSecond())
+	{
+		m_summaryTimer.start();
+	}
 	if(!m_steps.size())
 	{
 		state = LaunchTask::Finished;
@@ -110,18 +132,26 @@ void LaunchTask::onProgressReportingRequested()
 
 void LaunchTask::setCensorFilter(QMap<QString, QString> filter)
 {
-	m_censorFilter = filter;
+	m_censorFilter = CensorFilter(filter);
 }
 
-QString LaunchTask::censorPrivateInfo(QString in)
+void LaunchTask::setWindowReadyMarker(const QString &marker)
 {
-	auto iter = m_censorFilter.begin();
-	while (iter != m_censorFilter.end())
+	m_windowReadyMarker = marker;
+}
+
+qint64 LaunchTask::elapsed() const
+{
+	if(!m_launchTimer.isValid())
 	{
-		in.replace(iter.key(), iter.value());
-		iter++;
+		return -1;
 	}
-	return in;
+	return m_launchTimer.elapsed();
+}
+
+QString LaunchTask::censorPrivateInfo(QString in)
+{
+	return m_censorFilter.apply(in);
 }
 
 void LaunchTask::proceed()
@@ -178,13 +208,135 @@ shared_qobject_ptr<LogModel> LaunchTask::getLogModel()
 
 void LaunchTask::onLogLines(const QStringList &lines, MessageLevel::Enum defaultLevel)
 {
-	for (auto & line: lines)
+	QStringList processed = lines;
+	QVector<MessageLevel::Enum> levels;
+	levels.reserve(processed.size());
+	for (auto & line: processed)
+	{
+		levels.append(processLine(line, defaultLevel));
+	}
+
+	// look for the marker before the rate limit, it may well be in a flood or a repeat
+	bool windowReady = false;
+	if(m_windowReadyTime == -1 && !m_windowReadyMarker.isEmpty())
+	{
+		for (auto & line: processed)
+		{
+			if(line.contains(m_windowReadyMarker))
+			{
+				m_windowReadyTime = elapsed();
+				windowReady = true;
+				break;
+			}
+		}
+	}
+
+	// keep floods of game output out of the model, they still go to the disk
+	if(defaultLevel != MessageLevel::MultiMC)
+	{
+		QVector<MessageLevel::Enum> heldLevels;
+		QStringList heldLines;
+		m_rateLimiter.filter(elapsed(), levels, processed, heldLevels, heldLines);
+		writeHeldLines(heldLines);
+	}
+
+	// the whole chunk goes into the model as one update
+	auto &model = *getLogModel();
+	model.appendBatch(levels, processed);
+
+	if(windowReady)
+	{
+		model.append(MessageLevel::MultiMC, tr("Game window ready %1 ms after launch start.").arg(m_windowReadyTime));
+	}
+}
+
+void LaunchTask::onSummaryTimer()
+{
+	QVector<MessageLevel::Enum> levels;
+	QStringList lines;
+	m_rateLimiter.tick(elapsed(), levels, lines);
+	if(!lines.isEmpty())
+	{
+		getLogModel()->appendBatch(levels, lines);
+	}
+}
+
+QString LaunchTask::heldLogPath() const
+{
+	return FS::PathCombine(m_instance->getLogFileRoot(), "launcher-held.log");
+}
+
+void LaunchTask::writeHeldLines(const QStringList &lines)
+{
+	if(lines.isEmpty())
+	{
+		return;
+	}
+	bool first = !m_heldLog;
+	if(first)
+	{
+		m_heldLog = std::make_shared<QFile>(heldLogPath());
+	}
+	auto file = m_heldLog;
+	QtConcurrent::run(&m_heldLogPool, [file, lines, first]()
+	{
+		if(first)
+		{
+			// one file per launch, the ones of the last few launches are kept like the other logs
+			auto path = file->fileName();
+			auto base = path.left(path.size() - 4) + "-%1.log";
+			QFile::remove(base.arg(3));
+			QFile::rename(base.arg(2), base.arg(3));
+			QFile::rename(base.arg(1), base.arg(2));
+			QFile::rename(path, base.arg(1));
+			if(!FS::ensureFilePathExists(path) || !file->open(QIODevice::WriteOnly | QIODevice::Truncate))
+			{
+				qWarning() << "Can't write held back log lines to" << path << file->errorString();
+			}
+		}
+		if(!file->isOpen())
+		{
+			return;
+		}
+		QByteArray data;
+		for(auto & line: lines)
+		{
+			data += line.toUtf8();
+			data += '\n';
+		}
+		file->write(data);
+	});
+}
+
+void LaunchTask::flushRateLimiter()
+{
+	m_summaryTimer.stop();
+	QVector<MessageLevel::Enum> levels;
+	QStringList lines;
+	m_rateLimiter.flush(levels, lines);
+	auto &model = *getLogModel();
+	model.appendBatch(levels, lines);
+	if(m_rateLimiter.droppedLines() || m_rateLimiter.collapsedLines())
 	{
-		onLogLine(line, defaultLevel);
+		model.append(MessageLevel::MultiMC, tr("%1 lines were suppressed and %2 repeated lines collapsed, all of them are in %3")
+			.arg(m_rateLimiter.droppedLines()).arg(m_rateLimiter.collapsedLines()).arg(heldLogPath()));
+	}
+	if(m_heldLog)
+	{
+		auto file = m_heldLog;
+		QtConcurrent::run(&m_heldLogPool, [file]()
+		{
+			file->close();
+		});
 	}
 }
 
 void LaunchTask::onLogLine(QString line, MessageLevel::Enum level)
+{
+	onLogLines(QStringList(line), level);
+}
+
+MessageLevel::Enum LaunchTask::processLine(QString &line, MessageLevel::Enum level)
 {
 	// if the launcher part set a log level, use it
 	auto innerLevel = MessageLevel::fromLine(line);
@@ -201,13 +353,95 @@ void LaunchTask::onLogLine(QString line, MessageLevel::Enum level)
 
 	// censor private user info
 	line = censorPrivateInfo(line);
+	return level;
+}
 
+void LaunchTask::finalizeTimings(const QString &result)
+{
+	// never started -> nothing to report
+	if(!m_launchTimer.isValid())
+	{
+		return;
+	}
+	flushRateLimiter();
 	auto &model = *getLogModel();
-	model.append(level, line);
+	model.append(MessageLevel::MultiMC, tr("Launch timing summary:"));
+	for(auto step: m_steps)
+	{
+		if(step->startTime() == -1)
+		{
+			continue;
+		}
+		QString name = step->metaObject()->className();
+		if(step->endTime() == -1)
+		{
+			model.append(MessageLevel::MultiMC, tr("  %1: started at %2 ms, didn't finish").arg(name).arg(step->startTime()));
+			continue;
+		}
+		model.append(MessageLevel::MultiMC, tr("  %1: %2 ms (started at %3 ms)")
+			.arg(name).arg(step->endTime() - step->startTime()).arg(step->startTime()));
+	}
+	if(m_windowReadyTime != -1)
+	{
+		model.append(MessageLevel::MultiMC, tr("  Game window ready: %1 ms").arg(m_windowReadyTime));
+	}
+	model.append(MessageLevel::MultiMC, tr("  Total: %1 ms").arg(elapsed()));
+	writeLaunchHistory(result);
+}
+
+void LaunchTask::writeLaunchHistory(const QString &result)
+{
+	QJsonArray steps;
+	for(auto step: m_steps)
+	{
+		if(step->startTime() == -1)
+		{
+			continue;
+		}
+		QJsonObject stepObj;
+		stepObj.insert("name", QString(step->metaObject()->className()));
+		stepObj.insert("start", step->startTime());
+		stepObj.insert("end", step->endTime());
+		steps.append(stepObj);
+	}
+	QJsonObject entry;
+	entry.insert("time", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+	entry.insert("result", result);
+	entry.insert("steps", steps);
+	entry.insert("windowReady", m_windowReadyTime);
+	entry.insert("total", elapsed());
+	entry.insert("droppedLines", m_rateLimiter.droppedLines());
+	entry.insert("collapsedLines", m_rateLimiter.collapsedLines());
+
+	// one JSON object per line, only the last launches are kept
+	const int maxEntries = 100;
+	auto path = FS::PathCombine(m_instance->instanceRoot(), "launch_history.log");
+	QList<QByteArray> lines;
+	QFile history(path);
+	if(history.open(QIODevice::ReadOnly))
+	{
+		lines = history.readAll().split('\n');
+		history.close();
+	}
+	lines.removeAll(QByteArray());
+	lines.append(QJsonDocument(entry).toJson(QJsonDocument::Compact));
+	if(lines.size() > maxEntries)
+	{
+		lines = lines.mid(lines.size() - maxEntries);
+	}
+	try
+	{
+		FS::write(path, lines.join('\n') + "\n");
+	}
+	catch(FS::FileSystemException & e)
+	{
+		qWarning() << "Couldn't write launch history file" << path << ":" << e.cause();
+	}
 }
 
 void LaunchTask::emitSucceeded()
 {
+	finalizeTimings("succeeded");
 	m_instance->cleanupAfterRun();
 	m_instance->setRunning(false);
 	Task::emitSucceeded();
@@ -215,6 +449,7 @@ void LaunchTask::emitSucceeded()
 
 void LaunchTask::emitFailed(QString reason)
 {
+	finalizeTimings(state == LaunchTask::Aborted ? "aborted" : "failed");
 	m_instance->cleanupAfterRun();
 	m_instance->setRunning(false);
 	Task::emitFailed(reason);
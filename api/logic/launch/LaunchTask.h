@@ -17,12 +17,19 @@
 
 #pragma once
 #include <QProcess>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTimer>
+#include <QThreadPool>
+#include <memory>
 #include <QObjectPtr.h>
 #include "LogModel.h"
 #include "BaseInstance.h"
 #include "MessageLevel.h"
 #include "LoggedProcess.h"
 #include "LaunchStep.h"
+#include "CensorFilter.h"
+#include "LogRateLimiter.h"
 
 #include "multimc_logic_export.h"
 
@@ -46,12 +53,27 @@ public:
 
 public: /* methods */
 	static std::shared_ptr<LaunchTask> create(InstancePtr inst);
-	virtual ~LaunchTask() {};
+	virtual ~LaunchTask();
 
 	void appendStep(std::shared_ptr<LaunchStep> step);
 	void prependStep(std::shared_ptr<LaunchStep> step);
 	void setCensorFilter(QMap<QString, QString> filter);
 
+	/**
+	 * Set a string that marks the game window as ready when it shows up in the log.
+	 * The time it took to get there is reported in the timing summary and launch history.
+	 */
+	void setWindowReadyMarker(const QString &marker);
+
+	/// Time since the launch started, in ms
+	qint64 elapsed() const;
+
+	/// Time from the start of the launch until the window ready marker was seen, in ms. -1 if it wasn't seen.
+	qint64 windowReadyTime() const
+	{
+		return m_windowReadyTime;
+	}
+
 	InstancePtr instance()
 	{
 		return m_instance;
@@ -84,6 +106,19 @@ public: /* methods */
 
 	shared_qobject_ptr<LogModel> getLogModel();
 
+	/// lines the rate limit kept out of the log
+	qint64 droppedLogLines() const
+	{
+		return m_rateLimiter.droppedLines();
+	}
+	/// repeated lines that were collapsed into a note
+	qint64 collapsedLogLines() const
+	{
+		return m_rateLimiter.collapsedLines();
+	}
+	/// where the lines that were kept out of the log are written
+	QString heldLogPath() const;
+
 public:
 	QString substituteVariables(const QString &cmd) const;
 	QString censorPrivateInfo(QString in);
@@ -91,6 +126,11 @@ public:
 protected: /* methods */
 	virtual void emitFailed(QString reason) override;
 	virtual void emitSucceeded() override;
+	void finalizeTimings(const QString &result);
+	MessageLevel::Enum processLine(QString &line, MessageLevel::Enum level);
+	void writeLaunchHistory(const QString &result);
+	void writeHeldLines(const QStringList &lines);
+	void flushRateLimiter();
 
 signals:
 	/**
@@ -109,12 +149,24 @@ public slots:
 	void onStepFinished();
 	void onProgressReportingRequested();
 
+private slots:
+	void onSummaryTimer();
+
 protected: /* data */
 	InstancePtr m_instance;
 	shared_qobject_ptr<LogModel> m_logModel;
 	QList <std::shared_ptr<LaunchStep>> m_steps;
-	QMap<QString, QString> m_censorFilter;
+	CensorFilter m_censorFilter;
+	LogRateLimiter m_rateLimiter;
+	// only used from m_heldLogPool, so the disk doesn't slow down the flood it is there for
+	std::shared_ptr<QFile> m_heldLog;
+	QThreadPool m_heldLogPool;
+	// shows the rate limit summaries when the game goes quiet after a flood
+	QTimer m_summaryTimer;
 	int currentStep = -1;
 	State state = NotStarted;
 	qint64 m_pid = -1;
+	QElapsedTimer m_launchTimer;
+	QString m_windowReadyMarker;
+	qint64 m_windowReadyTime = -1;
 };
@@ -1,10 +1,15 @@
 #include "LogModel.h"
+#include "LogSpillStore.h"
 
 LogModel::LogModel(QObject *parent):QAbstractListModel(parent)
 {
 	m_content.resize(m_maxLines);
 }
 
+LogModel::~LogModel()
+{
+}
+
 int LogModel::rowCount(const QModelIndex &parent) const
 {
 	if (parent.isValid())
@@ -34,51 +39,190 @@ QVariant LogModel::data(const QModelIndex &index, int role) const
 
 void LogModel::append(MessageLevel::Enum level, QString line)
 {
-	int lineNum = (m_firstLine + m_numLines) % m_maxLines;
-	// overflow
-	if(m_numLines == m_maxLines)
+	appendBatch({level}, QStringList(line));
+}
+
+void LogModel::appendBatch(const QVector<MessageLevel::Enum> &levels, const QStringList &lines)
+{
+	int count = qMin(levels.size(), lines.size());
+	if(count == 0)
+	{
+		return;
+	}
+	if(m_stopOnOverflow)
 	{
-		if(m_stopOnOverflow)
+		int space = m_maxLines - m_numLines;
+		if(space <= 0)
 		{
 			// nothing more to do, the buffer is full
 			return;
 		}
-		beginRemoveRows(QModelIndex(), 0, 0);
-		m_firstLine = (m_firstLine + 1) % m_maxLines;
-		m_numLines --;
+		count = qMin(count, space);
+		beginInsertRows(QModelIndex(), m_numLines, m_numLines + count - 1);
+		for(int i = 0; i < count; i++)
+		{
+			auto & entry = m_content[(m_firstLine + m_numLines) % m_maxLines];
+			// the last line in the buffer is the overflow message
+			if (m_numLines == m_maxLines - 1)
+			{
+				entry.level = MessageLevel::Fatal;
+				entry.line = m_overflowMessage;
+			}
+			else
+			{
+				entry.level = levels[i];
+				entry.line = lines[i];
+			}
+			m_numLines ++;
+		}
+		endInsertRows();
+		return;
+	}
+
+	// lines that would be pushed out by later lines of the same batch are never added
+	int skip = qMax(0, count - m_maxLines);
+	int toAdd = count - skip;
+	int overflow = qMax(0, m_numLines + toAdd - m_maxLines);
+	if(m_spill)
+	{
+		spill(0, overflow);
+		for(int i = 0; i < skip; i++)
+		{
+			m_spill->append(levels[i], lines[i]);
+		}
+	}
+	m_droppedLines += overflow + skip;
+	if(overflow)
+	{
+		beginRemoveRows(QModelIndex(), 0, overflow - 1);
+		m_firstLine = (m_firstLine + overflow) % m_maxLines;
+		m_numLines -= overflow;
 		endRemoveRows();
 	}
-	else if (m_numLines == m_maxLines - 1 && m_stopOnOverflow)
+	beginInsertRows(QModelIndex(), m_numLines, m_numLines + toAdd - 1);
+	for(int i = skip; i < count; i++)
 	{
-		level = MessageLevel::Fatal;
-		line = m_overflowMessage;
+		// this reuses the entries of the ring buffer, no reallocation
+		auto & entry = m_content[(m_firstLine + m_numLines) % m_maxLines];
+		entry.level = levels[i];
+		entry.line = lines[i];
+		m_numLines ++;
 	}
-	beginInsertRows(QModelIndex(), m_numLines, m_numLines);
-	m_numLines ++;
-	m_content[lineNum].level = level;
-	m_content[lineNum].line = line;
 	endInsertRows();
 }
 
+void LogModel::spill(int first, int count)
+{
+	for(int i = first; i < first + count; i++)
+	{
+		auto & entry = m_content[(m_firstLine + i) % m_maxLines];
+		m_spill->append(entry.level, entry.line);
+	}
+}
+
 void LogModel::clear()
 {
 	beginResetModel();
 	m_firstLine = 0;
 	m_numLines = 0;
+	m_droppedLines = 0;
+	if(m_spill)
+	{
+		m_spill->clear();
+	}
 	endResetModel();
 }
 
-QString LogModel::toPlainText()
+bool LogModel::toPlainText(QString &out, qint64 maxSize)
 {
-	QString out;
-	out.reserve(m_numLines * 80);
-	for(int i = 0; i < m_numLines; i++)
+	out.clear();
+	bool fits = true;
+	// spilled lines come in a chunk at a time, so a session too big to copy is never all in memory
+	forEachLine([&](MessageLevel::Enum, const QString & line)
+	{
+		if(out.size() + line.size() + 1 > maxSize)
+		{
+			fits = false;
+			return false;
+		}
+		out.append(line);
+		out.append('\n');
+		return true;
+	});
+	if(!fits)
 	{
-		QString & line = m_content[(m_firstLine + i) % m_maxLines].line;
-		out.append(line + '\n');
+		out = QString();
+		return false;
 	}
 	out.squeeze();
-	return out;
+	return true;
+}
+
+void LogModel::forEachLine(std::function<bool(MessageLevel::Enum, const QString &)> visitor)
+{
+	bool keepGoing = true;
+	if(m_spill)
+	{
+		m_spill->forEachLine([&](MessageLevel::Enum level, const QString & line)
+		{
+			keepGoing = visitor(level, line);
+			return keepGoing;
+		});
+	}
+	for(int i = 0; keepGoing && i < m_numLines; i++)
+	{
+		auto & entry = m_content[(m_firstLine + i) % m_maxLines];
+		keepGoing = visitor(entry.level, entry.line);
+	}
+}
+
+void LogModel::copyRows(int first, int count, QVector<MessageLevel::Enum> &levels, QStringList &lines) const
+{
+	levels.clear();
+	lines.clear();
+	int end = qMin(first + count, m_numLines);
+	first = qMax(first, 0);
+	levels.reserve(end - first);
+	lines.reserve(end - first);
+	for(int i = first; i < end; i++)
+	{
+		auto & entry = m_content[(m_firstLine + i) % m_maxLines];
+		levels.append(entry.level);
+		lines.append(entry.line);
+	}
+}
+
+void LogModel::setSpillToDisk(bool spill)
+{
+	if(!spill)
+	{
+		m_spill.reset();
+		return;
+	}
+	if(m_spill)
+	{
+		return;
+	}
+	auto store = std::make_shared<LogSpillStore>();
+	if(store->open())
+	{
+		m_spill = store;
+	}
+}
+
+std::shared_ptr<LogSpillStore> LogModel::spillStore() const
+{
+	return m_spill;
+}
+
+qint64 LogModel::firstLineNumber() const
+{
+	return m_droppedLines;
+}
+
+int LogModel::spilledLineCount() const
+{
+	return m_spill ? m_spill->lineCount() : 0;
 }
 
 void LogModel::setMaxLines(int maxLines)
@@ -111,14 +255,23 @@ void LogModel::setMaxLines(int maxLines)
 	{
 		// if it doesn't fit, part of the data needs to be thrown away (the oldest log messages)
 		int lead = m_numLines - maxLines;
+		if(m_spill)
+		{
+			spill(0, lead);
+		}
+		m_droppedLines += lead;
 		beginRemoveRows(QModelIndex(), 0, lead - 1);
 		for(int i = 0; i < maxLines; i++)
 		{
 			newContent[i] = m_content[(m_firstLine + lead + i) % m_maxLines];
 		}
-		m_numLines = m_maxLines;
+		// everything data() looks at is consistent again before the views hear about it
+		m_numLines = maxLines;
 		m_content.swap(newContent);
+		m_firstLine = 0;
+		m_maxLines = maxLines;
 		endRemoveRows();
+		return;
 	}
 	m_firstLine = 0;
 	m_maxLines = maxLines;
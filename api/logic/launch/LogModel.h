@@ -2,8 +2,14 @@
 
 #include <QAbstractListModel>
 #include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+#include <memory>
 #include "MessageLevel.h"
 
+class LogSpillStore;
+
 #include <multimc_logic_export.h>
 
 class MULTIMC_LOGIC_EXPORT LogModel : public QAbstractListModel
@@ -11,14 +17,48 @@ class MULTIMC_LOGIC_EXPORT LogModel : public QAbstractListModel
 	Q_OBJECT
 public:
 	explicit LogModel(QObject *parent = 0);
+	virtual ~LogModel();
 
 	int rowCount(const QModelIndex &parent = QModelIndex()) const;
 	QVariant data(const QModelIndex &index, int role) const;
 
 	void append(MessageLevel::Enum, QString line);
+	/**
+	 * Append many lines at once. levels and lines are matched by index.
+	 * Emits at most one row removal and one row insertion, no matter how many lines there are.
+	 */
+	void appendBatch(const QVector<MessageLevel::Enum> &levels, const QStringList &lines);
 	void clear();
 
-	QString toPlainText();
+	/**
+	 * All the lines of the session, including the ones that were spilled to disk.
+	 * Returns false, with out empty, as soon as the text gets bigger than maxSize characters.
+	 */
+	bool toPlainText(QString &out, qint64 maxSize);
+
+	/**
+	 * Call visitor for every line of the session, oldest first. Spilled lines are read back
+	 * from disk a chunk at a time. Stops early when the visitor returns false.
+	 */
+	void forEachLine(std::function<bool(MessageLevel::Enum, const QString &)> visitor);
+
+	/// copy count rows starting with first, without touching the lines spilled to disk
+	void copyRows(int first, int count, QVector<MessageLevel::Enum> &levels, QStringList &lines) const;
+
+	/**
+	 * Keep lines pushed out of the buffer in a compressed file on disk instead of dropping them.
+	 * Has no effect while the model stops on overflow.
+	 */
+	void setSpillToDisk(bool spill);
+	/// the spill store, or nullptr when lines are not spilled
+	std::shared_ptr<LogSpillStore> spillStore() const;
+	int spilledLineCount() const;
+
+	/**
+	 * Line number of the first row within the whole session.
+	 * This is the number of lines that were pushed out of the buffer, spilled or not.
+	 */
+	qint64 firstLineNumber() const;
 
 	void setMaxLines(int maxLines);
 	void setStopOnOverflow(bool stop);
@@ -29,6 +69,9 @@ public:
 		LevelRole = Qt::UserRole
 	};
 
+private:
+	void spill(int first, int count);
+
 private /* types */:
 	struct entry
 	{
@@ -45,6 +88,8 @@ private: /* data */
 	int m_numLines = 0;
 	bool m_stopOnOverflow = false;
 	QString m_overflowMessage = "OVERFLOW";
+	std::shared_ptr<LogSpillStore> m_spill;
+	qint64 m_droppedLines = 0;
 
 private:
 	Q_DISABLE_COPY(LogModel)
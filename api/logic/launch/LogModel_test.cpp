@@ -0,0 +1,192 @@
+#include <QTest>
+#include <QSignalSpy>
+
+#include "launch/LogModel.h"
+#include "launch/LogSpillModel.h"
+#include "launch/LogSpillStore.h"
+
+class LogModelTest : public QObject
+{
+	Q_OBJECT
+
+	static QStringList makeLines(int from, int count)
+	{
+		QStringList lines;
+		for(int i = from; i < from + count; i++)
+		{
+			lines.append(QString::number(i));
+		}
+		return lines;
+	}
+	static QVector<MessageLevel::Enum> makeLevels(int count)
+	{
+		return QVector<MessageLevel::Enum>(count, MessageLevel::Message);
+	}
+	static QString lineAt(LogModel &model, int row)
+	{
+		return model.data(model.index(row), Qt::DisplayRole).toString();
+	}
+	static QString text(LogModel &model)
+	{
+		QString out;
+		model.toPlainText(out, 1024 * 1024);
+		return out;
+	}
+
+private
+slots:
+	void test_batchSingleInsert()
+	{
+		LogModel model;
+		model.setMaxLines(10);
+		QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+		QSignalSpy removed(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+		model.appendBatch(makeLevels(5), makeLines(0, 5));
+		QCOMPARE(model.rowCount(), 5);
+		QCOMPARE(inserted.count(), 1);
+		QCOMPARE(removed.count(), 0);
+		QCOMPARE(lineAt(model, 0), QString("0"));
+		QCOMPARE(lineAt(model, 4), QString("4"));
+	}
+
+	void test_batchOverflow()
+	{
+		LogModel model;
+		model.setMaxLines(10);
+		model.appendBatch(makeLevels(8), makeLines(0, 8));
+		QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+		QSignalSpy removed(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+		model.appendBatch(makeLevels(5), makeLines(8, 5));
+		QCOMPARE(model.rowCount(), 10);
+		QCOMPARE(inserted.count(), 1);
+		QCOMPARE(removed.count(), 1);
+		QCOMPARE(removed[0][2].toInt(), 2);
+		QCOMPARE(lineAt(model, 0), QString("3"));
+		QCOMPARE(lineAt(model, 9), QString("12"));
+	}
+
+	void test_shrinkWhileWrapped()
+	{
+		LogModel model;
+		model.setMaxLines(10);
+		model.appendBatch(makeLevels(13), makeLines(0, 13));
+		// views read the model as soon as they hear about the removal
+		QStringList seen;
+		connect(&model, &LogModel::rowsRemoved, [&]()
+		{
+			for(int i = 0; i < model.rowCount(); i++)
+			{
+				seen.append(lineAt(model, i));
+			}
+		});
+		model.setMaxLines(4);
+		QCOMPARE(seen, makeLines(9, 4));
+		QCOMPARE(model.rowCount(), 4);
+		QCOMPARE(lineAt(model, 3), QString("12"));
+	}
+
+	void test_batchLargerThanBuffer()
+	{
+		LogModel model;
+		model.setMaxLines(10);
+		model.appendBatch(makeLevels(3), makeLines(0, 3));
+		model.appendBatch(makeLevels(25), makeLines(3, 25));
+		QCOMPARE(model.rowCount(), 10);
+		QCOMPARE(lineAt(model, 0), QString("18"));
+		QCOMPARE(lineAt(model, 9), QString("27"));
+	}
+
+	void test_batchMatchesAppend()
+	{
+		LogModel batched, single;
+		batched.setMaxLines(7);
+		single.setMaxLines(7);
+		auto lines = makeLines(0, 23);
+		for(auto & line: lines)
+		{
+			single.append(MessageLevel::Message, line);
+		}
+		batched.appendBatch(makeLevels(4), lines.mid(0, 4));
+		batched.appendBatch(makeLevels(19), lines.mid(4));
+		QCOMPARE(text(batched), text(single));
+	}
+
+	void test_batchStopOnOverflow()
+	{
+		LogModel model;
+		model.setMaxLines(5);
+		model.setStopOnOverflow(true);
+		model.setOverflowMessage("overflow");
+		model.appendBatch(makeLevels(3), makeLines(0, 3));
+		model.appendBatch(makeLevels(10), makeLines(3, 10));
+		QCOMPARE(model.rowCount(), 5);
+		QCOMPARE(lineAt(model, 3), QString("3"));
+		QCOMPARE(lineAt(model, 4), QString("overflow"));
+		model.appendBatch(makeLevels(2), makeLines(13, 2));
+		QCOMPARE(model.rowCount(), 5);
+	}
+
+	void test_spillToDisk()
+	{
+		LogModel model;
+		model.setMaxLines(100);
+		model.setSpillToDisk(true);
+		QVERIFY(model.spillStore() != nullptr);
+		auto lines = makeLines(0, 5000);
+		for(int i = 0; i < lines.size(); i += 300)
+		{
+			auto chunk = lines.mid(i, 300);
+			model.appendBatch(makeLevels(chunk.size()), chunk);
+		}
+		QCOMPARE(model.rowCount(), 100);
+		QCOMPARE(model.spilledLineCount(), 4900);
+		QCOMPARE(model.firstLineNumber(), qint64(4900));
+		QCOMPARE(text(model), lines.join('\n') + '\n');
+		QString tooBig;
+		QVERIFY(!model.toPlainText(tooBig, 1000));
+		QVERIFY(tooBig.isEmpty());
+
+		QVector<MessageLevel::Enum> levels;
+		QStringList read;
+		QVERIFY(model.spillStore()->readLines(1020, 10, levels, read));
+		QCOMPARE(read, makeLines(1020, 10));
+		QVERIFY(model.spillStore()->readLines(4890, 20, levels, read));
+		QCOMPARE(read, makeLines(4890, 10));
+		QCOMPARE(levels.size(), 10);
+
+		model.clear();
+		QCOMPARE(model.spilledLineCount(), 0);
+		QCOMPARE(text(model), QString());
+	}
+
+	void test_spillModel()
+	{
+		LogModel model;
+		model.setMaxLines(100);
+		model.setSpillToDisk(true);
+		LogSpillModel spilled;
+		spilled.setSourceModel(&model);
+		QCOMPARE(spilled.rowCount(), 0);
+
+		auto lines = makeLines(0, 5000);
+		QSignalSpy inserted(&spilled, SIGNAL(rowsInserted(QModelIndex, int, int)));
+		model.appendBatch(makeLevels(2000), lines.mid(0, 2000));
+		model.appendBatch(makeLevels(3000), lines.mid(2000));
+		QCOMPARE(inserted.size(), 2);
+		QCOMPARE(spilled.rowCount(), 4900);
+		QCOMPARE(spilled.firstLineNumber(), qint64(0));
+		QCOMPARE(spilled.data(spilled.index(0), Qt::DisplayRole).toString(), QString("0"));
+		QCOMPARE(spilled.data(spilled.index(1234), Qt::DisplayRole).toString(), QString("1234"));
+		QCOMPARE(spilled.data(spilled.index(4899), Qt::DisplayRole).toString(), QString("4899"));
+		QCOMPARE(spilled.data(spilled.index(4899), LogModel::LevelRole).toInt(), int(MessageLevel::Message));
+
+		QSignalSpy reset(&spilled, SIGNAL(modelReset()));
+		model.clear();
+		QCOMPARE(reset.size(), 1);
+		QCOMPARE(spilled.rowCount(), 0);
+	}
+};
+
+QTEST_GUILESS_MAIN(LogModelTest)
+
+#include "LogModel_test.moc"
@@ -0,0 +1,159 @@
+#include "LogRateLimiter.h"
+
+void LogRateLimiter::setLinesPerSecond(int linesPerSecond)
+{
+	m_linesPerSecond = qMax(0, linesPerSecond);
+	// start with a full bucket
+	m_lastRefill = -1;
+}
+
+int LogRateLimiter::linesPerSecond() const
+{
+	return m_linesPerSecond;
+}
+
+void LogRateLimiter::filter(qint64 now, QVector<MessageLevel::Enum> &levels, QStringList &lines,
+							QVector<MessageLevel::Enum> &heldLevels, QStringList &heldLines)
+{
+	if(!m_linesPerSecond)
+	{
+		return;
+	}
+	if(m_lastRefill == -1)
+	{
+		m_tokens = m_linesPerSecond;
+	}
+	else if(now > m_lastRefill)
+	{
+		m_tokens = qMin<double>(m_linesPerSecond, m_tokens + (now - m_lastRefill) * m_linesPerSecond / 1000.0);
+	}
+	m_lastRefill = now;
+	if(m_lastSummary == -1)
+	{
+		m_lastSummary = now;
+	}
+
+	QVector<MessageLevel::Enum> outLevels;
+	QStringList outLines;
+	outLevels.reserve(levels.size());
+	outLines.reserve(lines.size());
+
+	auto summarizeAt = [&]()
+	{
+		summarize(outLevels, outLines);
+		m_lastSummary = now;
+	};
+
+	for(int i = 0; i < lines.size(); i++)
+	{
+		auto level = levels[i];
+		const auto &line = lines[i];
+
+		// while a flood goes on, say something about it once in a while
+		if((m_repeats || m_suppressed) && now - m_lastSummary >= 1000)
+		{
+			summarizeAt();
+		}
+
+		if(alwaysShown(level))
+		{
+			// neither collapsed nor limited, and it doesn't use up the room other lines have
+			if(m_repeats || m_suppressed)
+			{
+				summarizeAt();
+			}
+			m_haveLast = true;
+			m_lastLevel = level;
+			m_lastLine = line;
+			m_lastSuppressed = false;
+			outLevels.append(level);
+			outLines.append(line);
+			continue;
+		}
+
+		if(m_haveLast && level == m_lastLevel && line == m_lastLine)
+		{
+			heldLevels.append(level);
+			heldLines.append(line);
+			// repeats of a line that wasn't shown are not shown either
+			if(m_lastSuppressed)
+			{
+				m_suppressed++;
+				m_dropped++;
+			}
+			else
+			{
+				m_repeats++;
+				m_collapsed++;
+			}
+			continue;
+		}
+		m_haveLast = true;
+		m_lastLevel = level;
+		m_lastLine = line;
+
+		if(m_tokens < 1.0)
+		{
+			if(m_repeats)
+			{
+				summarizeAt();
+			}
+			heldLevels.append(level);
+			heldLines.append(line);
+			m_suppressed++;
+			m_dropped++;
+			m_lastSuppressed = true;
+			continue;
+		}
+		m_tokens -= 1.0;
+		if(m_repeats || m_suppressed)
+		{
+			summarizeAt();
+		}
+		m_lastSuppressed = false;
+		outLevels.append(level);
+		outLines.append(line);
+	}
+
+	levels.swap(outLevels);
+	lines.swap(outLines);
+}
+
+bool LogRateLimiter::alwaysShown(MessageLevel::Enum level)
+{
+	return level == MessageLevel::Warning || level == MessageLevel::Error || level == MessageLevel::Fatal;
+}
+
+void LogRateLimiter::tick(qint64 now, QVector<MessageLevel::Enum> &levels, QStringList &lines)
+{
+	if(m_lastSummary == -1 || now - m_lastSummary < 1000)
+	{
+		return;
+	}
+	if(m_repeats || m_suppressed)
+	{
+		summarize(levels, lines);
+		m_lastSummary = now;
+	}
+}
+
+void LogRateLimiter::flush(QVector<MessageLevel::Enum> &levels, QStringList &lines)
+{
+	summarize(levels, lines);
+}
+
+void LogRateLimiter::summarize(QVector<MessageLevel::Enum> &levels, QStringList &lines)
+{
+	if(m_repeats)
+	{
+		levels.append(MessageLevel::MultiMC);
+		lines.append(tr("Last message repeated %n more time(s).", "", m_repeats));
+		m_repeats = 0;
+	}
+	if(m_suppressed)
+	{
+		levels.append(MessageLevel::MultiMC);
+		lines.append(tr("%n line(s) suppressed, the game logged more than %1 lines per second.", "", m_suppressed).arg(m_linesPerSecond));
+		m_suppressed = 0;
+	}
+}
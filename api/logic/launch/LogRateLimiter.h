@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QCoreApplication>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "MessageLevel.h"
+
+#include "multimc_logic_export.h"
+
+/**
+ * Keeps a flood of log lines from reaching the log model.
+ *
+ * Runs of the same line are collapsed into one line and a short note about the repeats.
+ * Lines beyond the rate limit (a token bucket that holds one second worth of lines) are suppressed,
+ * with a summary line at most once a second while the flood goes on.
+ * With the rate limit off, nothing is held back at all, repeated lines included.
+ * Warnings, errors and fatal errors are never held back, a stack trace in a flood is what matters most.
+ *
+ * Everything that is held back is handed to the caller, so it can still be written somewhere.
+ */
+class MULTIMC_LOGIC_EXPORT LogRateLimiter
+{
+	Q_DECLARE_TR_FUNCTIONS(LogRateLimiter)
+public:
+	/// lines per second, 0 turns the rate limit and the collapsing of repeated lines off
+	void setLinesPerSecond(int linesPerSecond);
+	int linesPerSecond() const;
+
+	/**
+	 * Filter lines that arrived at time now (ms, monotonic).
+	 * The lines to show stay in levels and lines, with summary lines added where needed.
+	 * The held back lines are appended to heldLevels and heldLines.
+	 */
+	void filter(qint64 now, QVector<MessageLevel::Enum> &levels, QStringList &lines,
+				QVector<MessageLevel::Enum> &heldLevels, QStringList &heldLines);
+
+	/**
+	 * Summaries that are due at time now (ms, monotonic), for when no new lines come along to carry them.
+	 * Meant to be called about once a second while the log is open.
+	 */
+	void tick(qint64 now, QVector<MessageLevel::Enum> &levels, QStringList &lines);
+
+	/// summaries for anything still held back, to be shown at the end of the log
+	void flush(QVector<MessageLevel::Enum> &levels, QStringList &lines);
+
+	/// lines held back by the rate limit
+	qint64 droppedLines() const
+	{
+		return m_dropped;
+	}
+	/// lines held back because they repeated the line before them
+	qint64 collapsedLines() const
+	{
+		return m_collapsed;
+	}
+
+private:
+	static bool alwaysShown(MessageLevel::Enum level);
+	void summarize(QVector<MessageLevel::Enum> &levels, QStringList &lines);
+
+private:
+	int m_linesPerSecond = 0;
+	double m_tokens = 0;
+	qint64 m_lastRefill = -1;
+	qint64 m_lastSummary = -1;
+
+	MessageLevel::Enum m_lastLevel = MessageLevel::Unknown;
+	QString m_lastLine;
+	bool m_haveLast = false;
+	bool m_lastSuppressed = false;
+
+	// not summarized yet
+	int m_repeats = 0;
+	int m_suppressed = 0;
+
+	qint64 m_dropped = 0;
+	qint64 m_collapsed = 0;
+};
@@ -0,0 +1,186 @@
+#include <QTest>
+
+#include "launch/LogRateLimiter.h"
+
+class LogRateLimiterTest : public QObject
+{
+	Q_OBJECT
+
+	static QStringList numbered(const QString &prefix, int count)
+	{
+		QStringList lines;
+		for(int i = 0; i < count; i++)
+		{
+			lines.append(prefix + QString::number(i));
+		}
+		return lines;
+	}
+
+	struct Run
+	{
+		QVector<MessageLevel::Enum> levels;
+		QStringList lines;
+		QVector<MessageLevel::Enum> heldLevels;
+		QStringList heldLines;
+	};
+
+	static Run feed(LogRateLimiter &limiter, qint64 now, const QStringList &lines)
+	{
+		Run run;
+		run.lines = lines;
+		run.levels.fill(MessageLevel::Info, lines.size());
+		limiter.filter(now, run.levels, run.lines, run.heldLevels, run.heldLines);
+		return run;
+	}
+
+private
+slots:
+	void test_passThrough()
+	{
+		LogRateLimiter limiter;
+		auto lines = numbered("line ", 100);
+		lines << "same" << "same" << "same";
+		auto run = feed(limiter, 0, lines);
+		QCOMPARE(run.lines, lines);
+		QCOMPARE(run.levels.size(), lines.size());
+		QVERIFY(run.heldLines.isEmpty());
+		QCOMPARE(limiter.droppedLines(), qint64(0));
+		QCOMPARE(limiter.collapsedLines(), qint64(0));
+	}
+
+	void test_collapse()
+	{
+		LogRateLimiter limiter;
+		limiter.setLinesPerSecond(1000);
+		auto run = feed(limiter, 0, {"a", "a", "a", "b", "b"});
+		QCOMPARE(run.lines.size(), 3);
+		QCOMPARE(run.lines[0], QString("a"));
+		QCOMPARE(run.levels[1], MessageLevel::MultiMC);
+		QVERIFY(run.lines[1].contains("2"));
+		QCOMPARE(run.lines[2], QString("b"));
+		QCOMPARE(run.heldLines, QStringList({"a", "a", "b"}));
+		QCOMPARE(limiter.collapsedLines(), qint64(3));
+
+		// the repeats of the last line only show up once something else comes along
+		run = feed(limiter, 10, {"b", "c"});
+		QCOMPARE(run.lines.size(), 2);
+		QVERIFY(run.lines[0].contains("2"));
+		QCOMPARE(run.lines[1], QString("c"));
+
+		// or when the log ends
+		feed(limiter, 20, {"c"});
+		QVector<MessageLevel::Enum> levels;
+		QStringList lines;
+		limiter.flush(levels, lines);
+		QCOMPARE(lines.size(), 1);
+		limiter.flush(levels, lines);
+		QCOMPARE(lines.size(), 1);
+	}
+
+	void test_differentLevelsDoNotCollapse()
+	{
+		LogRateLimiter limiter;
+		limiter.setLinesPerSecond(1000);
+		QStringList lines = {"a", "a"};
+		QVector<MessageLevel::Enum> levels = {MessageLevel::Info, MessageLevel::Error};
+		QVector<MessageLevel::Enum> heldLevels;
+		QStringList heldLines;
+		limiter.filter(0, levels, lines, heldLevels, heldLines);
+		QCOMPARE(lines.size(), 2);
+		QVERIFY(heldLines.isEmpty());
+	}
+
+	void test_rateLimit()
+	{
+		LogRateLimiter limiter;
+		limiter.setLinesPerSecond(10);
+		auto lines = numbered("flood ", 25);
+		auto run = feed(limiter, 0, lines);
+		QCOMPARE(run.lines, lines.mid(0, 10));
+		QCOMPARE(run.heldLines, lines.mid(10));
+		QCOMPARE(limiter.droppedLines(), qint64(15));
+
+		// still over the limit, nothing is refilled yet
+		run = feed(limiter, 50, {"more"});
+		QVERIFY(run.lines.isEmpty());
+		QCOMPARE(limiter.droppedLines(), qint64(16));
+
+		// half a second later there is room for 5 more lines, the summary comes first
+		run = feed(limiter, 550, numbered("late ", 10));
+		QCOMPARE(run.lines.size(), 6);
+		QCOMPARE(run.levels[0], MessageLevel::MultiMC);
+		QVERIFY(run.lines[0].contains("16"));
+		QCOMPARE(run.lines.mid(1), numbered("late ", 5));
+		QCOMPARE(limiter.droppedLines(), qint64(21));
+	}
+
+	void test_summaryDuringFlood()
+	{
+		LogRateLimiter limiter;
+		limiter.setLinesPerSecond(1);
+		feed(limiter, 0, numbered("a", 5));
+
+		auto run = feed(limiter, 1000, {"x", "y", "z"});
+		QCOMPARE(run.lines.size(), 2);
+		QVERIFY(run.lines[0].contains("4"));
+		QCOMPARE(run.lines[1], QString("x"));
+
+		// the next summary waits for a second to pass
+		run = feed(limiter, 1500, {"w"});
+		QVERIFY(run.lines.isEmpty());
+		run = feed(limiter, 2000, {"v"});
+		QCOMPARE(run.lines.size(), 2);
+		QVERIFY(run.lines[0].contains("3"));
+		QCOMPARE(run.lines[1], QString("v"));
+	}
+
+	void test_tick()
+	{
+		LogRateLimiter limiter;
+		limiter.setLinesPerSecond(1);
+		feed(limiter, 0, numbered("a", 5));
+
+		// the flood stopped, the summary still shows up once a second passed
+		QVector<MessageLevel::Enum> levels;
+		QStringList lines;
+		limiter.tick(500, levels, lines);
+		QVERIFY(lines.isEmpty());
+		limiter.tick(1000, levels, lines);
+		QCOMPARE(lines.size(), 1);
+		QCOMPARE(levels[0], MessageLevel::MultiMC);
+		QVERIFY(lines[0].contains("4"));
+		limiter.tick(3000, levels, lines);
+		QCOMPARE(lines.size(), 1);
+	}
+
+	void test_errorsAlwaysShown()
+	{
+		LogRateLimiter limiter;
+		limiter.setLinesPerSecond(1);
+		QStringList lines = {"a", "b", "Exception", "\tat Foo", "\tat Foo", "c"};
+		QVector<MessageLevel::Enum> levels = {MessageLevel::Info, MessageLevel::Info, MessageLevel::Error,
+			MessageLevel::Error, MessageLevel::Error, MessageLevel::Info};
+		QVector<MessageLevel::Enum> heldLevels;
+		QStringList heldLines;
+		limiter.filter(0, levels, lines, heldLevels, heldLines);
+		QCOMPARE(heldLines, QStringList({"b", "c"}));
+		QCOMPARE(lines.size(), 5);
+		QCOMPARE(lines[0], QString("a"));
+		QCOMPARE(levels[1], MessageLevel::MultiMC);
+		QCOMPARE(lines.mid(2), QStringList({"Exception", "\tat Foo", "\tat Foo"}));
+	}
+
+	void test_repeatsOfSuppressedLines()
+	{
+		LogRateLimiter limiter;
+		limiter.setLinesPerSecond(1);
+		auto run = feed(limiter, 0, {"a", "b", "b", "b"});
+		QCOMPARE(run.lines, QStringList({"a"}));
+		QCOMPARE(limiter.droppedLines(), qint64(3));
+		QCOMPARE(limiter.collapsedLines(), qint64(0));
+	}
+};
+
+QTEST_GUILESS_MAIN(LogRateLimiterTest)
+
+#include "LogRateLimiter_test.moc"
@@ -0,0 +1,402 @@
+#include "LogSearch.h"
+#include "LogModel.h"
+#include "LogSpillStore.h"
+
+#include <QRegularExpression>
+#include <QStringMatcher>
+#include <QtConcurrentRun>
+#include <algorithm>
+
+namespace
+{
+// hand results over to the GUI thread after this many lines
+const int batchLines = 4096;
+
+bool before(const LogSearch::Match &match, qint64 line, int column)
+{
+	return match.line < line || (match.line == line && match.start < column);
+}
+}
+
+bool LogSearch::Query::operator==(const Query &other) const
+{
+	return pattern == other.pattern && regex == other.regex && caseSensitive == other.caseSensitive && levels == other.levels;
+}
+
+bool LogSearch::Query::operator!=(const Query &other) const
+{
+	return !(*this == other);
+}
+
+/*
+ * The compiled query. Immutable, so the worker and the GUI thread can share it.
+ */
+class LogSearch::Matcher
+{
+public:
+	explicit Matcher(const Query &query)
+		: m_levels(query.levels), m_regex(query.regex), m_empty(query.pattern.isEmpty())
+	{
+		if(m_regex)
+		{
+			auto options = QRegularExpression::DontCaptureOption;
+			if(!query.caseSensitive)
+			{
+				options |= QRegularExpression::CaseInsensitiveOption;
+			}
+			m_expression = QRegularExpression(query.pattern, options);
+			m_expression.optimize();
+		}
+		else
+		{
+			m_matcher = QStringMatcher(query.pattern, query.caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive);
+		}
+	}
+
+	QString errorString() const
+	{
+		return m_regex && !m_expression.isValid() ? m_expression.errorString() : QString();
+	}
+
+	void match(qint64 lineNumber, MessageLevel::Enum level, const QString &line, QVector<Match> &out) const
+	{
+		if(!m_levels.isEmpty() && !m_levels.contains(level))
+		{
+			return;
+		}
+		if(m_empty)
+		{
+			// only filtering by level, the whole line matches
+			out.append({lineNumber, 0, line.size()});
+			return;
+		}
+		if(m_regex)
+		{
+			auto iter = m_expression.globalMatch(line);
+			while(iter.hasNext())
+			{
+				auto found = iter.next();
+				if(found.capturedLength() == 0)
+				{
+					continue;
+				}
+				out.append({lineNumber, found.capturedStart(), found.capturedLength()});
+			}
+			return;
+		}
+		int length = m_matcher.pattern().size();
+		int from = 0;
+		while(true)
+		{
+			int index = m_matcher.indexIn(line, from);
+			if(index == -1)
+			{
+				break;
+			}
+			out.append({lineNumber, index, length});
+			from = index + length;
+		}
+	}
+
+private:
+	QSet<MessageLevel::Enum> m_levels;
+	bool m_regex;
+	bool m_empty;
+	QRegularExpression m_expression;
+	QStringMatcher m_matcher;
+};
+
+struct LogSearch::Job
+{
+	int generation;
+	std::shared_ptr<const Matcher> matcher;
+	std::shared_ptr<LogSpillStore> spill;
+	int spilledCount = 0;
+	qint64 spillFirstLine = 0;
+	qint64 firstLine = 0;
+	QVector<MessageLevel::Enum> levels;
+	QStringList lines;
+};
+
+LogSearch::LogSearch(QObject *parent) : QObject(parent), m_generation(0)
+{
+}
+
+LogSearch::~LogSearch()
+{
+	cancel();
+	m_future.waitForFinished();
+}
+
+void LogSearch::setModel(LogModel *model)
+{
+	if(m_model)
+	{
+		disconnect(m_model, nullptr, this, nullptr);
+	}
+	m_model = model;
+	if(m_model)
+	{
+		connect(m_model, &QAbstractItemModel::rowsInserted, this, &LogSearch::rowsInserted);
+		connect(m_model, &QAbstractItemModel::rowsRemoved, this, &LogSearch::rowsRemoved);
+		connect(m_model, &QAbstractItemModel::modelReset, this, &LogSearch::modelReset);
+	}
+	if(m_active)
+	{
+		start(m_query);
+	}
+}
+
+void LogSearch::cancel()
+{
+	QMutexLocker locker(&m_pendingLock);
+	m_generation++;
+	m_pending.clear();
+	m_pendingDone = false;
+	m_running = false;
+}
+
+void LogSearch::start(const Query &query)
+{
+	cancel();
+	m_query = query;
+	m_matches.clear();
+	m_current = -1;
+	auto matcher = std::make_shared<Matcher>(query);
+	m_error = matcher->errorString();
+	if(!m_error.isEmpty() || !m_model)
+	{
+		m_active = false;
+		m_matcher.reset();
+		emit finished();
+		return;
+	}
+	m_matcher = matcher;
+	m_active = true;
+	m_running = true;
+
+	// take a snapshot of the lines in memory, the worker must not touch the model
+	auto job = std::make_shared<Job>();
+	job->generation = m_generation;
+	job->matcher = matcher;
+	job->firstLine = m_model->firstLineNumber();
+	m_model->copyRows(0, m_model->rowCount(), job->levels, job->lines);
+	job->spill = m_model->spillStore();
+	if(job->spill)
+	{
+		job->spilledCount = job->spill->lineCount();
+		job->spillFirstLine = job->firstLine - job->spilledCount;
+	}
+	m_searchedUpTo = job->firstLine + job->lines.size();
+	m_future = QtConcurrent::run(&LogSearch::run, this, job);
+}
+
+void LogSearch::run(LogSearch *self, std::shared_ptr<Job> job)
+{
+	// returns false if the search was cancelled
+	auto handOver = [&](QVector<Match> &found, bool done) -> bool
+	{
+		QMutexLocker locker(&self->m_pendingLock);
+		if(self->m_generation != job->generation)
+		{
+			return false;
+		}
+		if(found.isEmpty() && !done)
+		{
+			return true;
+		}
+		bool notify = self->m_pending.isEmpty() && !self->m_pendingDone;
+		self->m_pending += found;
+		found.clear();
+		self->m_pendingDone = done;
+		if(notify || done)
+		{
+			QMetaObject::invokeMethod(self, "deliver", Qt::QueuedConnection, Q_ARG(int, job->generation));
+		}
+		return true;
+	};
+
+	QVector<Match> found;
+	if(job->spill)
+	{
+		QVector<MessageLevel::Enum> levels;
+		QStringList lines;
+		int step = LogSpillStore::linesPerChunk();
+		for(int first = 0; first < job->spilledCount; first += step)
+		{
+			if(!job->spill->readLines(first, qMin(step, job->spilledCount - first), levels, lines))
+			{
+				break;
+			}
+			for(int i = 0; i < lines.size(); i++)
+			{
+				job->matcher->match(job->spillFirstLine + first + i, levels[i], lines[i], found);
+			}
+			if(!handOver(found, false))
+			{
+				return;
+			}
+		}
+	}
+	for(int i = 0; i < job->lines.size(); i++)
+	{
+		job->matcher->match(job->firstLine + i, job->levels[i], job->lines[i], found);
+		if((i + 1) % batchLines == 0 && !handOver(found, false))
+		{
+			return;
+		}
+	}
+	handOver(found, true);
+}
+
+void LogSearch::deliver(int generation)
+{
+	QVector<Match> found;
+	bool done;
+	{
+		QMutexLocker locker(&m_pendingLock);
+		if(generation != m_generation)
+		{
+			return;
+		}
+		found.swap(m_pending);
+		done = m_pendingDone;
+		m_pendingDone = false;
+	}
+	addMatches(std::move(found));
+	if(done)
+	{
+		m_running = false;
+		// catch up with the lines that came in while the worker was busy
+		if(m_model)
+		{
+			int first = qMax<qint64>(0, m_searchedUpTo - m_model->firstLineNumber());
+			searchRows(first, m_model->rowCount() - 1);
+		}
+		emit finished();
+	}
+}
+
+void LogSearch::addMatches(QVector<Match> &&found)
+{
+	if(found.isEmpty())
+	{
+		return;
+	}
+	int first = m_matches.size();
+	m_matches += found;
+	emit matchesFound(first, found.size());
+}
+
+void LogSearch::searchRows(int first, int last)
+{
+	if(!m_model || !m_matcher || last < first)
+	{
+		return;
+	}
+	QVector<MessageLevel::Enum> levels;
+	QStringList lines;
+	m_model->copyRows(first, last - first + 1, levels, lines);
+	qint64 firstLine = m_model->firstLineNumber() + first;
+	QVector<Match> found;
+	for(int i = 0; i < lines.size(); i++)
+	{
+		m_matcher->match(firstLine + i, levels[i], lines[i], found);
+	}
+	m_searchedUpTo = firstLine + lines.size();
+	addMatches(std::move(found));
+}
+
+void LogSearch::rowsInserted(const QModelIndex &, int first, int last)
+{
+	if(m_active && !m_running)
+	{
+		searchRows(first, last);
+	}
+}
+
+void LogSearch::rowsRemoved(const QModelIndex &, int, int)
+{
+	if(!m_model || m_model->spillStore())
+	{
+		// the lines are still there, on disk
+		return;
+	}
+	// forget about matches in lines that are gone for good
+	auto firstLine = m_model->firstLineNumber();
+	auto gone = std::lower_bound(m_matches.begin(), m_matches.end(), firstLine, [](const Match &match, qint64 line)
+	{
+		return match.line < line;
+	}) - m_matches.begin();
+	if(gone)
+	{
+		m_matches.remove(0, gone);
+		m_current = m_current >= gone ? m_current - gone : -1;
+	}
+}
+
+void LogSearch::modelReset()
+{
+	if(m_active)
+	{
+		start(m_query);
+	}
+}
+
+const LogSearch::Query &LogSearch::query() const
+{
+	return m_query;
+}
+
+bool LogSearch::isActive() const
+{
+	return m_active;
+}
+
+bool LogSearch::isRunning() const
+{
+	return m_running;
+}
+
+QString LogSearch::errorString() const
+{
+	return m_error;
+}
+
+const QVector<LogSearch::Match> &LogSearch::matches() const
+{
+	return m_matches;
+}
+
+int LogSearch::nextMatch(qint64 line, int column)
+{
+	if(m_matches.isEmpty())
+	{
+		return m_current = -1;
+	}
+	auto iter = std::lower_bound(m_matches.begin(), m_matches.end(), 0, [&](const Match &match, int)
+	{
+		return before(match, line, column + 1);
+	});
+	m_current = iter == m_matches.end() ? 0 : iter - m_matches.begin();
+	return m_current;
+}
+
+int LogSearch::previousMatch(qint64 line, int column)
+{
+	if(m_matches.isEmpty())
+	{
+		return m_current = -1;
+	}
+	auto iter = std::lower_bound(m_matches.begin(), m_matches.end(), 0, [&](const Match &match, int)
+	{
+		return before(match, line, column);
+	});
+	m_current = iter == m_matches.begin() ? m_matches.size() - 1 : (iter - m_matches.begin()) - 1;
+	return m_current;
+}
+
+int LogSearch::currentMatch() const
+{
+	return m_current;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QObject>
+#include <QModelIndex>
+#include <QString>
+#include <QSet>
+#include <QVector>
+#include <QMutex>
+#include <QFuture>
+#include <QPointer>
+#include <atomic>
+#include <memory>
+#include "MessageLevel.h"
+
+#include <multimc_logic_export.h>
+
+class LogModel;
+class LogSpillStore;
+
+/**
+ * Searches a LogModel, including the lines it spilled to disk, on a worker thread.
+ *
+ * Matches are reported in batches while the search runs and are kept in session order,
+ * so going to the next or previous match is a lookup, not another scan.
+ * Lines that arrive after the search started are searched as they come in.
+ */
+class MULTIMC_LOGIC_EXPORT LogSearch : public QObject
+{
+	Q_OBJECT
+public:
+	struct Query
+	{
+		QString pattern;
+		bool regex = false;
+		bool caseSensitive = false;
+		/// only search lines with these levels, all lines if empty
+		QSet<MessageLevel::Enum> levels;
+
+		bool operator==(const Query &other) const;
+		bool operator!=(const Query &other) const;
+	};
+	struct Match
+	{
+		/// line number within the session, see LogModel::firstLineNumber
+		qint64 line;
+		int start;
+		int length;
+	};
+
+public:
+	explicit LogSearch(QObject *parent = nullptr);
+	virtual ~LogSearch();
+
+	void setModel(LogModel *model);
+
+	/// start searching, cancels the previous search
+	void start(const Query &query);
+	void cancel();
+
+	const Query &query() const;
+	bool isActive() const;
+	bool isRunning() const;
+	/// the error in the regular expression of the query, if any
+	QString errorString() const;
+
+	const QVector<Match> &matches() const;
+
+	/// index of the first match after the given position, wrapping around. -1 if there is none (yet).
+	int nextMatch(qint64 line, int column);
+	/// index of the last match before the given position, wrapping around. -1 if there is none (yet).
+	int previousMatch(qint64 line, int column);
+	/// the match last returned by nextMatch or previousMatch, -1 if there is none
+	int currentMatch() const;
+
+signals:
+	/// matches with indexes first to first + count - 1 were added
+	void matchesFound(int first, int count);
+	void finished();
+
+private slots:
+	void deliver(int generation);
+	void rowsInserted(const QModelIndex &parent, int first, int last);
+	void rowsRemoved(const QModelIndex &parent, int first, int last);
+	void modelReset();
+
+private:
+	class Matcher;
+	struct Job;
+	static void run(LogSearch *self, std::shared_ptr<Job> job);
+	void searchRows(int first, int last);
+	void addMatches(QVector<Match> && found);
+
+private:
+	QPointer<LogModel> m_model;
+	Query m_query;
+	bool m_active = false;
+	bool m_running = false;
+	QString m_error;
+	std::shared_ptr<const Matcher> m_matcher;
+	QVector<Match> m_matches;
+	int m_current = -1;
+	// rows that arrived while the worker was running, searched when it is done
+	qint64 m_searchedUpTo = 0;
+
+	std::atomic<int> m_generation;
+	QFuture<void> m_future;
+	// results handed over from the worker
+	QMutex m_pendingLock;
+	QVector<Match> m_pending;
+	bool m_pendingDone = false;
+};
@@ -0,0 +1,127 @@
+#include <QTest>
+#include <QSignalSpy>
+
+#include "launch/LogModel.h"
+#include "launch/LogSearch.h"
+
+class LogSearchTest : public QObject
+{
+	Q_OBJECT
+
+	static void fill(LogModel &model, int count)
+	{
+		QVector<MessageLevel::Enum> levels;
+		QStringList lines;
+		for(int i = 0; i < count; i++)
+		{
+			bool error = i % 100 == 0;
+			levels.append(error ? MessageLevel::Error : MessageLevel::Message);
+			lines.append(error ? QString("java.lang.NullPointerException at line %1").arg(i) : QString("line %1").arg(i));
+		}
+		model.appendBatch(levels, lines);
+	}
+
+	static void runSearch(LogSearch &search, const LogSearch::Query &query)
+	{
+		QSignalSpy finished(&search, SIGNAL(finished()));
+		search.start(query);
+		if(search.isRunning())
+		{
+			QVERIFY(finished.wait(5000));
+		}
+	}
+
+private
+slots:
+	void test_plain()
+	{
+		LogModel model;
+		model.setMaxLines(10000);
+		fill(model, 1000);
+		LogSearch search;
+		search.setModel(&model);
+		LogSearch::Query query;
+		query.pattern = "nullpointer";
+		runSearch(search, query);
+		QCOMPARE(search.matches().size(), 10);
+		QCOMPARE(search.matches()[3].line, qint64(300));
+		QCOMPARE(search.matches()[3].start, 10);
+	}
+
+	void test_regexAndLevels()
+	{
+		LogModel model;
+		model.setMaxLines(10000);
+		fill(model, 1000);
+		LogSearch search;
+		search.setModel(&model);
+		LogSearch::Query query;
+		query.pattern = "line \\d+5$";
+		query.regex = true;
+		runSearch(search, query);
+		QCOMPARE(search.matches().size(), 90);
+
+		query.levels.insert(MessageLevel::Error);
+		query.pattern = "line";
+		runSearch(search, query);
+		QCOMPARE(search.matches().size(), 10);
+
+		query.pattern = "(";
+		search.start(query);
+		QVERIFY(!search.errorString().isEmpty());
+		QVERIFY(!search.isActive());
+	}
+
+	void test_cursor()
+	{
+		LogModel model;
+		model.setMaxLines(10000);
+		fill(model, 1000);
+		LogSearch search;
+		search.setModel(&model);
+		LogSearch::Query query;
+		query.pattern = "NullPointer";
+		runSearch(search, query);
+		QCOMPARE(search.nextMatch(0, -1), 0);
+		QCOMPARE(search.nextMatch(0, 10), 1);
+		QCOMPARE(search.nextMatch(950, 0), 0);
+		QCOMPARE(search.previousMatch(300, 10), 2);
+		QCOMPARE(search.previousMatch(0, 0), 9);
+		QCOMPARE(search.currentMatch(), 9);
+	}
+
+	void test_newLines()
+	{
+		LogModel model;
+		model.setMaxLines(10000);
+		fill(model, 1000);
+		LogSearch search;
+		search.setModel(&model);
+		LogSearch::Query query;
+		query.pattern = "NullPointer";
+		runSearch(search, query);
+		fill(model, 200);
+		QCOMPARE(search.matches().size(), 12);
+		QCOMPARE(search.matches().last().line, qint64(1100));
+	}
+
+	void test_spilled()
+	{
+		LogModel model;
+		model.setMaxLines(100);
+		model.setSpillToDisk(true);
+		fill(model, 5000);
+		LogSearch search;
+		search.setModel(&model);
+		LogSearch::Query query;
+		query.pattern = "NullPointer";
+		runSearch(search, query);
+		QCOMPARE(search.matches().size(), 50);
+		QCOMPARE(search.matches().first().line, qint64(0));
+		QCOMPARE(search.matches().last().line, qint64(4900));
+	}
+};
+
+QTEST_GUILESS_MAIN(LogSearchTest)
+
+#include "LogSearch_test.moc"
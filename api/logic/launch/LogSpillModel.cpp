@@ -0,0 +1,108 @@
+#include "LogSpillModel.h"
+#include "LogModel.h"
+#include "LogSpillStore.h"
+
+LogSpillModel::LogSpillModel(QObject *parent) : QAbstractListModel(parent)
+{
+}
+
+LogSpillModel::~LogSpillModel()
+{
+}
+
+void LogSpillModel::setSourceModel(LogModel *model)
+{
+	if(m_source)
+	{
+		disconnect(m_source, nullptr, this, nullptr);
+	}
+	m_source = model;
+	if(m_source)
+	{
+		// lines are spilled while the source adds or removes rows
+		connect(m_source, &LogModel::rowsInserted, this, &LogSpillModel::sync);
+		connect(m_source, &LogModel::rowsRemoved, this, &LogSpillModel::sync);
+		connect(m_source, &LogModel::modelReset, this, &LogSpillModel::reset);
+	}
+	reset();
+}
+
+int LogSpillModel::rowCount(const QModelIndex &parent) const
+{
+	if (parent.isValid())
+		return 0;
+
+	return m_rows;
+}
+
+QVariant LogSpillModel::data(const QModelIndex &index, int role) const
+{
+	if (index.row() < 0 || index.row() >= m_rows)
+		return QVariant();
+
+	if (role != Qt::DisplayRole && role != Qt::EditRole && role != LogModel::LevelRole)
+		return QVariant();
+
+	int row = index.row();
+	int chunkLines = LogSpillStore::linesPerChunk();
+	int first = row - row % chunkLines;
+	if(first != m_cachedFirst)
+	{
+		if(!m_store->readLines(first, qMin(chunkLines, m_rows - first), m_cachedLevels, m_cachedLines))
+		{
+			m_cachedFirst = -1;
+			return QVariant();
+		}
+		m_cachedFirst = first;
+	}
+	int offset = row - first;
+	if(offset >= m_cachedLines.size())
+	{
+		return QVariant();
+	}
+	if(role == LogModel::LevelRole)
+	{
+		return m_cachedLevels[offset];
+	}
+	return m_cachedLines[offset];
+}
+
+qint64 LogSpillModel::firstLineNumber() const
+{
+	if(!m_source)
+	{
+		return 0;
+	}
+	return m_source->firstLineNumber() - m_source->spilledLineCount();
+}
+
+void LogSpillModel::sync()
+{
+	auto store = m_source ? m_source->spillStore() : nullptr;
+	int count = store ? store->lineCount() : 0;
+	if(store != m_store || count < m_rows)
+	{
+		reset();
+		return;
+	}
+	if(count == m_rows)
+	{
+		return;
+	}
+	// the last chunk read may have been cut short by the lines spilled since
+	m_cachedFirst = -1;
+	beginInsertRows(QModelIndex(), m_rows, count - 1);
+	m_rows = count;
+	endInsertRows();
+}
+
+void LogSpillModel::reset()
+{
+	beginResetModel();
+	m_store = m_source ? m_source->spillStore() : nullptr;
+	m_rows = m_store ? m_store->lineCount() : 0;
+	m_cachedFirst = -1;
+	m_cachedLevels.clear();
+	m_cachedLines.clear();
+	endResetModel();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+#include "MessageLevel.h"
+
+class LogModel;
+class LogSpillStore;
+
+#include <multimc_logic_export.h>
+
+/**
+ * The lines a LogModel spilled to disk, as a read-only model.
+ *
+ * Follows the LogModel: rows are added as lines get spilled, and go away when it is cleared.
+ * Lines are read back from the spill store a chunk at a time.
+ */
+class MULTIMC_LOGIC_EXPORT LogSpillModel : public QAbstractListModel
+{
+	Q_OBJECT
+public:
+	explicit LogSpillModel(QObject *parent = 0);
+	virtual ~LogSpillModel();
+
+	void setSourceModel(LogModel *model);
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role) const override;
+
+	/// line number of the first row within the whole session, as in LogModel::firstLineNumber
+	qint64 firstLineNumber() const;
+
+private slots:
+	void sync();
+
+private:
+	void reset();
+
+private:
+	QPointer<LogModel> m_source;
+	std::shared_ptr<LogSpillStore> m_store;
+	int m_rows = 0;
+	// the last chunk that was read back
+	mutable int m_cachedFirst = -1;
+	mutable QVector<MessageLevel::Enum> m_cachedLevels;
+	mutable QStringList m_cachedLines;
+};
@@ -0,0 +1,262 @@
+#include "LogSpillStore.h"
+#include "GZip.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QObject>
+#include <QDebug>
+#include <algorithm>
+
+namespace
+{
+// lines per compressed chunk
+const int chunkLines = 1024;
+}
+
+LogSpillStore::LogSpillStore()
+{
+	m_file.setFileTemplate(QDir::temp().absoluteFilePath("MultiMC-log-XXXXXX"));
+}
+
+LogSpillStore::~LogSpillStore()
+{
+}
+
+bool LogSpillStore::open()
+{
+	QMutexLocker locker(&m_lock);
+	if(m_file.isOpen())
+	{
+		return true;
+	}
+	if(!m_file.open())
+	{
+		qWarning() << "Could not create log spill file:" << m_file.errorString();
+		return false;
+	}
+	return true;
+}
+
+bool LogSpillStore::isOpen() const
+{
+	QMutexLocker locker(&m_lock);
+	return m_file.isOpen();
+}
+
+void LogSpillStore::append(MessageLevel::Enum level, const QString &line)
+{
+	QMutexLocker locker(&m_lock);
+	if(m_pending.isEmpty())
+	{
+		m_pendingTime = QDateTime::currentMSecsSinceEpoch();
+	}
+	m_pending.append(line);
+	m_levels.append(char(level));
+	if(m_pending.size() >= chunkLines)
+	{
+		writePending();
+	}
+}
+
+void LogSpillStore::writePending()
+{
+	Chunk chunk;
+	chunk.offset = m_file.size();
+	chunk.size = 0;
+	chunk.firstLine = pendingFirstLine();
+	chunk.lineCount = m_pending.size();
+	chunk.time = m_pendingTime;
+	// whatever happens, the lines leave memory. The ones that can't be written are lost
+	auto lose = [&]()
+	{
+		chunk.lost = true;
+		m_chunks.append(chunk);
+		m_pending.clear();
+	};
+
+	QByteArray raw;
+	{
+		QDataStream out(&raw, QIODevice::WriteOnly);
+		for(auto & line: m_pending)
+		{
+			out << line.toUtf8();
+		}
+	}
+	QByteArray compressed;
+	if(!GZip::zip(raw, compressed))
+	{
+		qWarning() << "Could not compress spilled log lines";
+		lose();
+		return;
+	}
+	chunk.size = compressed.size();
+	if(!m_file.seek(chunk.offset) || m_file.write(compressed) != compressed.size())
+	{
+		qWarning() << "Could not write spilled log lines:" << m_file.errorString();
+		// don't leave half a chunk behind for the next one to start after
+		m_file.resize(chunk.offset);
+		lose();
+		return;
+	}
+	m_chunks.append(chunk);
+	m_pending.clear();
+}
+
+void LogSpillStore::clear()
+{
+	QMutexLocker locker(&m_lock);
+	m_chunks.clear();
+	m_levels.clear();
+	m_pending.clear();
+	m_cachedChunk = -1;
+	m_cachedLines.clear();
+	if(m_file.isOpen())
+	{
+		m_file.resize(0);
+	}
+}
+
+int LogSpillStore::linesPerChunk()
+{
+	return chunkLines;
+}
+
+int LogSpillStore::lineCount() const
+{
+	QMutexLocker locker(&m_lock);
+	return m_levels.size();
+}
+
+MessageLevel::Enum LogSpillStore::level(int line) const
+{
+	QMutexLocker locker(&m_lock);
+	return (MessageLevel::Enum) m_levels.at(line);
+}
+
+int LogSpillStore::chunkIndex(int line) const
+{
+	// the last chunk whose first line is not after the line, if the line isn't still pending
+	auto found = std::upper_bound(m_chunks.begin(), m_chunks.end(), line, [](int line, const Chunk &chunk)
+	{
+		return line < chunk.firstLine;
+	});
+	if(found == m_chunks.begin())
+	{
+		return -1;
+	}
+	--found;
+	return line < found->firstLine + found->lineCount ? int(found - m_chunks.begin()) : -1;
+}
+
+int LogSpillStore::pendingFirstLine() const
+{
+	return m_chunks.isEmpty() ? 0 : m_chunks.last().firstLine + m_chunks.last().lineCount;
+}
+
+qint64 LogSpillStore::chunkTime(int line) const
+{
+	QMutexLocker locker(&m_lock);
+	int index = chunkIndex(line);
+	return index == -1 ? m_pendingTime : m_chunks[index].time;
+}
+
+bool LogSpillStore::loadChunk(int index, QStringList &lines)
+{
+	if(index == m_cachedChunk)
+	{
+		lines = m_cachedLines;
+		return true;
+	}
+	auto & chunk = m_chunks[index];
+	if(chunk.lost)
+	{
+		lines.clear();
+		for(int i = 0; i < chunk.lineCount; i++)
+		{
+			lines.append(QObject::tr("(this line could not be kept on disk)"));
+		}
+		return true;
+	}
+	if(!m_file.seek(chunk.offset))
+	{
+		return false;
+	}
+	auto compressed = m_file.read(chunk.size);
+	QByteArray raw;
+	if(compressed.size() != chunk.size || !GZip::unzip(compressed, raw))
+	{
+		qWarning() << "Could not read back spilled log lines";
+		return false;
+	}
+	lines.clear();
+	lines.reserve(chunk.lineCount);
+	QDataStream in(raw);
+	for(int i = 0; i < chunk.lineCount; i++)
+	{
+		QByteArray line;
+		in >> line;
+		lines.append(QString::fromUtf8(line));
+	}
+	m_cachedChunk = index;
+	m_cachedLines = lines;
+	return true;
+}
+
+bool LogSpillStore::readLines(int first, int count, QVector<MessageLevel::Enum> &levels, QStringList &lines)
+{
+	QMutexLocker locker(&m_lock);
+	levels.clear();
+	lines.clear();
+	int end = qMin(first + count, m_levels.size());
+	int i = qMax(first, 0);
+	while(i < end)
+	{
+		int index = chunkIndex(i);
+		if(index == -1)
+		{
+			int pendingFirst = pendingFirstLine();
+			for(; i < end; i++)
+			{
+				levels.append((MessageLevel::Enum) m_levels.at(i));
+				lines.append(m_pending[i - pendingFirst]);
+			}
+			break;
+		}
+		QStringList loaded;
+		if(!loadChunk(index, loaded))
+		{
+			return false;
+		}
+		auto & chunk = m_chunks[index];
+		for(; i < end && i < chunk.firstLine + chunk.lineCount; i++)
+		{
+			levels.append((MessageLevel::Enum) m_levels.at(i));
+			lines.append(loaded[i - chunk.firstLine]);
+		}
+	}
+	return true;
+}
+
+bool LogSpillStore::forEachLine(std::function<bool(MessageLevel::Enum, const QString &)> visitor)
+{
+	// the lock is only held while a chunk is read, not while the visitor runs
+	int count = lineCount();
+	QVector<MessageLevel::Enum> levels;
+	QStringList lines;
+	for(int first = 0; first < count; first += chunkLines)
+	{
+		if(!readLines(first, qMin(chunkLines, count - first), levels, lines))
+		{
+			return false;
+		}
+		for(int i = 0; i < lines.size(); i++)
+		{
+			if(!visitor(levels[i], lines[i]))
+			{
+				return true;
+			}
+		}
+	}
+	return true;
+}
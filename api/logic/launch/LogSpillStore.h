@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QTemporaryFile>
+#include <QMutex>
+#include <functional>
+#include "MessageLevel.h"
+
+#include <multimc_logic_export.h>
+
+/**
+ * Keeps log lines that no longer fit into a LogModel in a temporary file.
+ *
+ * Lines are written in compressed chunks. Only a small index stays in memory:
+ * where each chunk is in the file, when it was started, and the level of every line.
+ * The file is removed when the store is destroyed.
+ * Lines can be read back from other threads while new ones are appended.
+ */
+class MULTIMC_LOGIC_EXPORT LogSpillStore
+{
+public:
+	LogSpillStore();
+	~LogSpillStore();
+
+	/// create the backing file, returns false if that is not possible
+	bool open();
+	bool isOpen() const;
+
+	void append(MessageLevel::Enum level, const QString &line);
+	void clear();
+
+	int lineCount() const;
+	MessageLevel::Enum level(int line) const;
+	/// time when the chunk holding the line was started, in milliseconds since the epoch
+	qint64 chunkTime(int line) const;
+
+	/// read count lines starting with first. returns false if they could not be read back.
+	bool readLines(int first, int count, QVector<MessageLevel::Enum> &levels, QStringList &lines);
+
+	/**
+	 * Call visitor for every stored line, oldest first, one chunk in memory at a time.
+	 * Stops early when the visitor returns false. Returns false on read errors.
+	 */
+	bool forEachLine(std::function<bool(MessageLevel::Enum, const QString &)> visitor);
+
+	/// the number of lines that are in each compressed chunk
+	static int linesPerChunk();
+
+private:
+	struct Chunk
+	{
+		qint64 offset;
+		int size;
+		int firstLine;
+		int lineCount;
+		qint64 time;
+		// the lines couldn't be written, only their number is known
+		bool lost = false;
+	};
+	void writePending();
+	bool loadChunk(int index, QStringList &lines);
+	int chunkIndex(int line) const;
+	int pendingFirstLine() const;
+
+private:
+	mutable QMutex m_lock;
+	QTemporaryFile m_file;
+	QVector<Chunk> m_chunks;
+	// one byte per line
+	QByteArray m_levels;
+	// lines that are not written to the file yet
+	QStringList m_pending;
+	qint64 m_pendingTime = 0;
+	// the last chunk that was read back
+	int m_cachedChunk = -1;
+	QStringList m_cachedLines;
+};
@@ -1,6 +1,7 @@
 #include "LoggedProcess.h"
 #include "MessageLevel.h"
 #include <QDebug>
+#include <cstring>
 
 LoggedProcess::LoggedProcess(QObject *parent) : QProcess(parent)
 {
@@ -20,26 +21,85 @@ LoggedProcess::~LoggedProcess()
 	}
 }
 
-QStringList reprocess(const QByteArray & data, QString & leftover)
+namespace {
+QString decodeLine(const char * begin, const char * end)
 {
-	QString str = leftover + QString::fromLocal8Bit(data);
+	auto line = QString::fromLocal8Bit(begin, end - begin);
+	if(memchr(begin, '\r', end - begin))
+	{
+		line.remove('\r');
+	}
+	return line;
+}
 
-	str.remove('\r');
-	QStringList lines = str.split("\n");
-	leftover = lines.takeLast();
+/*
+ * Splits the complete lines off the front of the buffer. Only those are decoded,
+ * the unfinished last line stays in the buffer as raw bytes.
+ */
+QStringList splitLines(QByteArray & buffer)
+{
+	QStringList lines;
+	const char * begin = buffer.constData();
+	const char * end = begin + buffer.size();
+	const char * lineStart = begin;
+	while(lineStart < end)
+	{
+		auto newline = (const char *) memchr(lineStart, '\n', end - lineStart);
+		if(!newline)
+		{
+			break;
+		}
+		lines.append(decodeLine(lineStart, newline));
+		lineStart = newline + 1;
+	}
+	if(lineStart == end)
+	{
+		buffer.clear();
+	}
+	else if(lineStart != begin)
+	{
+		// only the tail moves, the buffer keeps its allocation
+		buffer.remove(0, lineStart - begin);
+	}
 	return lines;
 }
+}
+
+void LoggedProcess::processOutput(QByteArray data, QByteArray &leftover, MessageLevel::Enum level)
+{
+	if(leftover.isEmpty())
+	{
+		leftover = std::move(data);
+	}
+	else
+	{
+		leftover.append(data);
+	}
+	auto lines = splitLines(leftover);
+	if(!lines.isEmpty())
+	{
+		emit log(lines, level);
+	}
+}
+
+void LoggedProcess::flushLeftover(QByteArray &leftover, MessageLevel::Enum level)
+{
+	if (!leftover.isEmpty())
+	{
+		emit log({decodeLine(leftover.constData(), leftover.constData() + leftover.size())}, level);
+		leftover.clear();
+	}
+}
 
 void LoggedProcess::on_stdErr()
 {
-	auto lines = reprocess(readAllStandardError(), m_err_leftover);
-	emit log(lines, MessageLevel::StdErr);
+	// QProcess has already pulled everything the pipe had, take all of it at once
+	processOutput(readAllStandardError(), m_err_leftover, MessageLevel::StdErr);
 }
 
 void LoggedProcess::on_stdOut()
 {
-	auto lines = reprocess(readAllStandardOutput(), m_out_leftover);
-	emit log(lines, MessageLevel::StdOut);
+	processOutput(readAllStandardOutput(), m_out_leftover, MessageLevel::StdOut);
 }
 
 void LoggedProcess::on_exit(int exit_code, QProcess::ExitStatus status)
@@ -48,16 +108,10 @@ void LoggedProcess::on_exit(int exit_code, QProcess::ExitStatus status)
 	m_exit_code = exit_code;
 
 	// Flush console window
-	if (!m_err_leftover.isEmpty())
-	{
-		emit log({m_err_leftover}, MessageLevel::StdErr);
-		m_err_leftover.clear();
-	}
-	if (!m_out_leftover.isEmpty())
-	{
-		emit log({m_err_leftover}, MessageLevel::StdOut);
-		m_out_leftover.clear();
-	}
+	on_stdErr();
+	on_stdOut();
+	flushLeftover(m_err_leftover, MessageLevel::StdErr);
+	flushLeftover(m_out_leftover, MessageLevel::StdOut);
 
 	// based on state, send signals
 	if (!m_is_aborting)
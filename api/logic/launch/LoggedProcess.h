@@ -67,10 +67,13 @@ private slots:
 
 private:
 	void changeState(LoggedProcess::State state);
+	void processOutput(QByteArray data, QByteArray &leftover, MessageLevel::Enum level);
+	void flushLeftover(QByteArray &leftover, MessageLevel::Enum level);
 
 private:
-	QString m_err_leftover;
-	QString m_out_leftover;
+	// raw bytes of the last, unfinished line of each channel
+	QByteArray m_err_leftover;
+	QByteArray m_out_leftover;
 	bool m_killed = false;
 	State m_state = NotRunning;
 	int m_exit_code = 0;
@@ -127,6 +127,12 @@ public: /* methods */
 	/// Returns true if the library should be loaded (or extracted, in case of natives)
 	bool isActive() const;
 
+	/// Returns the list of path prefixes that shouldn't be extracted from the native jars of this library
+	const QStringList & extractExcludes() const
+	{
+		return m_extractExcludes;
+	}
+
 	// Get a list of downloads for this library
 	QList<NetActionPtr> getDownloads(OpSys system, class HttpMetaCache * cache,
 									 QStringList & failedFiles, const QString & overridePath) const;
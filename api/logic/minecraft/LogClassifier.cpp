@@ -0,0 +1,143 @@
+#include "LogClassifier.h"
+
+//NOTE: this diverges from the real regexp. no unicode, the first section is + instead of *
+static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
+
+namespace
+{
+// old style forge tags. if more than one is present, the highest rank wins
+struct LegacyTag
+{
+	const char * tag;
+	int rank;
+	MessageLevel::Enum level;
+};
+const LegacyTag legacyTags[] =
+{
+	{"INFO", 1, MessageLevel::Message},
+	{"CONFIG", 1, MessageLevel::Message},
+	{"FINE", 1, MessageLevel::Message},
+	{"FINER", 1, MessageLevel::Message},
+	{"FINEST", 1, MessageLevel::Message},
+	{"SEVERE", 2, MessageLevel::Error},
+	{"STDERR", 2, MessageLevel::Error},
+	{"WARNING", 3, MessageLevel::Warning},
+	{"DEBUG", 4, MessageLevel::Debug}
+};
+const MessageLevel::Enum rankLevels[] =
+{
+	MessageLevel::Unknown,
+	MessageLevel::Message,
+	MessageLevel::Error,
+	MessageLevel::Warning,
+	MessageLevel::Debug
+};
+}
+
+LogClassifier::LogClassifier()
+	: m_log4j("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]"),
+	  m_exception(
+		"\\s+at " + javaSymbol +
+		"|Caused by: " + javaSymbol +
+		"|([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)" +
+		"|... \\d+ more$"),
+	  m_log4jPrefilter("] ["),
+	  m_overwriting("overwriting existing"),
+	  m_exceptionInThread("Exception in thread")
+{
+	m_log4j.optimize();
+	m_exception.optimize();
+
+	// every alternative of m_exception needs at least one of these
+	for(auto literal: {"at ", "Caused by: ", "Exception", "Error", "Throwable", " more"})
+	{
+		m_exceptionPrefilter.append(QStringMatcher(literal));
+	}
+
+	m_log4jLevels.insert("INFO", MessageLevel::Message);
+	m_log4jLevels.insert("WARN", MessageLevel::Warning);
+	m_log4jLevels.insert("ERROR", MessageLevel::Error);
+	m_log4jLevels.insert("FATAL", MessageLevel::Fatal);
+	m_log4jLevels.insert("TRACE", MessageLevel::Debug);
+	m_log4jLevels.insert("DEBUG", MessageLevel::Debug);
+
+	for(auto & tag: legacyTags)
+	{
+		m_legacyTags.insert(tag.tag, tag.rank);
+	}
+}
+
+bool LogClassifier::log4jLevel(const QString &line, MessageLevel::Enum &level) const
+{
+	if(m_log4jPrefilter.indexIn(line) == -1)
+	{
+		return false;
+	}
+	auto match = m_log4j.match(line);
+	if(!match.hasMatch())
+	{
+		return false;
+	}
+	// New style logs from log4j
+	level = m_log4jLevels.value(match.captured("level"), level);
+	return true;
+}
+
+MessageLevel::Enum LogClassifier::legacyLevel(const QString &line, MessageLevel::Enum level) const
+{
+	// Old style forge logs - one pass over all the [TAG] sections of the line
+	int rank = 0;
+	int open = line.indexOf('[');
+	while(open != -1)
+	{
+		int close = line.indexOf(']', open + 1);
+		if(close == -1)
+		{
+			break;
+		}
+		int next = line.indexOf('[', open + 1);
+		// only look at tags that contain no other '['
+		if(next == -1 || next > close)
+		{
+			rank = qMax(rank, m_legacyTags.value(line.mid(open + 1, close - open - 1), 0));
+			next = line.indexOf('[', close + 1);
+		}
+		open = next;
+	}
+	if(rank == 0)
+	{
+		return level;
+	}
+	return rankLevels[rank];
+}
+
+bool LogClassifier::looksLikeException(const QString &line) const
+{
+	if(m_exceptionInThread.indexIn(line) != -1)
+	{
+		return true;
+	}
+	bool candidate = false;
+	for(auto & matcher: m_exceptionPrefilter)
+	{
+		if(matcher.indexIn(line) != -1)
+		{
+			candidate = true;
+			break;
+		}
+	}
+	return candidate && m_exception.match(line).hasMatch();
+}
+
+MessageLevel::Enum LogClassifier::classify(const QString &line, MessageLevel::Enum level) const
+{
+	if(!log4jLevel(line, level))
+	{
+		level = legacyLevel(line, level);
+	}
+	if (m_overwriting.indexIn(line) != -1)
+		return MessageLevel::Fatal;
+	if (looksLikeException(line))
+		return MessageLevel::Error;
+	return level;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QRegularExpression>
+#include <QStringMatcher>
+#include <QHash>
+#include <QList>
+#include "launch/MessageLevel.h"
+
+#include "multimc_logic_export.h"
+
+/**
+ * Guesses the level of a line of Minecraft log output.
+ *
+ * All the patterns are compiled once, when the classifier is constructed.
+ * A line is only run through the regular expressions if it contains the literals they need.
+ * The classifier is immutable after construction, so it can be shared with worker threads.
+ */
+class MULTIMC_LOGIC_EXPORT LogClassifier
+{
+public:
+	LogClassifier();
+
+	/// guess the level of a line, returns level if nothing better is found
+	MessageLevel::Enum classify(const QString &line, MessageLevel::Enum level) const;
+
+private:
+	bool log4jLevel(const QString &line, MessageLevel::Enum &level) const;
+	MessageLevel::Enum legacyLevel(const QString &line, MessageLevel::Enum level) const;
+	bool looksLikeException(const QString &line) const;
+
+private:
+	QRegularExpression m_log4j;
+	QRegularExpression m_exception;
+	QStringMatcher m_log4jPrefilter;
+	QStringMatcher m_overwriting;
+	QStringMatcher m_exceptionInThread;
+	QList<QStringMatcher> m_exceptionPrefilter;
+	QHash<QString, MessageLevel::Enum> m_log4jLevels;
+	QHash<QString, int> m_legacyTags;
+};
@@ -0,0 +1,70 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "minecraft/LogClassifier.h"
+#include "GZip.h"
+
+Q_DECLARE_METATYPE(MessageLevel::Enum)
+
+class LogClassifierTest : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void test_classify_data()
+	{
+		QTest::addColumn<QString>("line");
+		QTest::addColumn<MessageLevel::Enum>("input");
+		QTest::addColumn<MessageLevel::Enum>("expected");
+
+		QTest::newRow("log4j info") << "[14:02:11] [main/INFO]: Loading tweak class" << MessageLevel::StdOut << MessageLevel::Message;
+		QTest::newRow("log4j warn") << "[14:02:12] [main/WARN] [FML]: something" << MessageLevel::StdOut << MessageLevel::Warning;
+		QTest::newRow("log4j error") << "[14:02:19] [Client thread/ERROR] [FML]: Fatal errors" << MessageLevel::StdOut << MessageLevel::Error;
+		QTest::newRow("log4j fatal") << "[14:02:20] [Client thread/FATAL]: Unreported" << MessageLevel::StdOut << MessageLevel::Fatal;
+		QTest::newRow("log4j debug") << "[14:02:12] [main/DEBUG] [FML]: Injecting" << MessageLevel::StdOut << MessageLevel::Debug;
+		QTest::newRow("log4j unknown level") << "[14:02:12] [main/CHATTY]: [WARNING] not legacy" << MessageLevel::StdErr << MessageLevel::StdErr;
+		QTest::newRow("legacy info") << "2016-01-01 14:02:22 [INFO] [ForgeModLoader] Forge" << MessageLevel::StdOut << MessageLevel::Message;
+		QTest::newRow("legacy severe") << "2016-01-01 14:02:23 [SEVERE] [ForgeModLoader] corrupt" << MessageLevel::StdOut << MessageLevel::Error;
+		QTest::newRow("legacy warning wins over severe") << "[SEVERE] [WARNING] both" << MessageLevel::StdOut << MessageLevel::Warning;
+		QTest::newRow("legacy debug wins") << "[INFO] [DEBUG] [STDERR] all of them" << MessageLevel::StdOut << MessageLevel::Debug;
+		QTest::newRow("legacy nested bracket") << "[[INFO] nested" << MessageLevel::StdOut << MessageLevel::Message;
+		QTest::newRow("overwriting") << "[14:02:21] [Server thread/INFO] [FML]: Registry overwriting existing entry" << MessageLevel::StdOut << MessageLevel::Fatal;
+		QTest::newRow("stack frame") << "\tat net.minecraft.client.Minecraft.run(Minecraft.java:1022)" << MessageLevel::StdErr << MessageLevel::Error;
+		QTest::newRow("caused by") << "Caused by: java.lang.IllegalStateException: bad" << MessageLevel::StdErr << MessageLevel::Error;
+		QTest::newRow("exception name") << "java.lang.NullPointerException" << MessageLevel::StdOut << MessageLevel::Error;
+		QTest::newRow("more") << "\t... 12 more" << MessageLevel::StdErr << MessageLevel::Error;
+		QTest::newRow("exception in thread") << "Exception in thread \"main\" oops" << MessageLevel::StdOut << MessageLevel::Error;
+		QTest::newRow("plain") << "Particle effects are now rendering" << MessageLevel::StdOut << MessageLevel::StdOut;
+		QTest::newRow("plain with at") << "look at that" << MessageLevel::StdOut << MessageLevel::StdOut;
+	}
+	void test_classify()
+	{
+		QFETCH(QString, line);
+		QFETCH(MessageLevel::Enum, input);
+		QFETCH(MessageLevel::Enum, expected);
+
+		LogClassifier classifier;
+		QCOMPARE(classifier.classify(line, input), expected);
+	}
+
+	void test_benchmark()
+	{
+		// the whole startup of a modpack with about a hundred mods
+		QByteArray text;
+		QVERIFY(GZip::unzip(MULTIMC_GET_TEST_FILE("data/modpack-startup.log.gz"), text));
+		auto log = QString::fromUtf8(text).split('\n');
+		QVERIFY(log.size() > 10000);
+		LogClassifier classifier;
+		QBENCHMARK
+		{
+			for(auto & line: log)
+			{
+				classifier.classify(line, MessageLevel::StdOut);
+			}
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN(LogClassifierTest)
+
+#include "LogClassifier_test.moc"
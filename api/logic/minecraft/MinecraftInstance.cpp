@@ -11,6 +11,7 @@
 #include <pathmatcher/MultiMatcher.h>
 #include <FileSystem.h>
 #include <java/JavaVersion.h>
+#include "minecraft/LogClassifier.h"
 
 #include "launch/LaunchTask.h"
 #include "launch/steps/PostLaunchCommand.h"
@@ -19,6 +20,7 @@
 #include "launch/steps/TextPrint.h"
 #include "minecraft/launch/LauncherPartLaunch.h"
 #include "minecraft/launch/ModMinecraftJar.h"
+#include "minecraft/launch/PrewarmLauncherPart.h"
 #include "java/launch/CheckJava.h"
 
 #define IBUS "@im=ibus"
@@ -81,6 +83,14 @@ MinecraftInstance::MinecraftInstance(SettingsObjectPtr globalSettings, SettingsO
 	// Minecraft launch method
 	auto launchMethodOverride = m_settings->registerSetting("OverrideMCLaunchMethod", false);
 	m_settings->registerOverride(globalSettings->getSetting("MCLaunchMethod"), launchMethodOverride);
+
+	// Launch speedups
+	auto launchOverride = m_settings->registerSetting("OverrideLaunch", false);
+	m_settings->registerOverride(globalSettings->getSetting("PrewarmJVM"), launchOverride);
+	m_settings->registerOverride(globalSettings->getSetting("SharedNatives"), launchOverride);
+
+	// Log line that marks the game window as ready, for launch timing
+	m_settings->registerSetting("WindowReadyLogMarker", "LWJGL Version: ");
 }
 
 QString MinecraftInstance::minecraftRoot() const
@@ -285,49 +295,16 @@ QMap<QString, QString> MinecraftInstance::createCensorFilterFromSession(AuthSess
 
 MessageLevel::Enum MinecraftInstance::guessLevel(const QString &line, MessageLevel::Enum level)
 {
-	QRegularExpression re("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]");
-	auto match = re.match(line);
-	if(match.hasMatch())
-	{
-		// New style logs from log4j
-		QString timestamp = match.captured("timestamp");
-		QString levelStr = match.captured("level");
-		if(levelStr == "INFO")
-			level = MessageLevel::Message;
-		if(levelStr == "WARN")
-			level = MessageLevel::Warning;
-		if(levelStr == "ERROR")
-			level = MessageLevel::Error;
-		if(levelStr == "FATAL")
-			level = MessageLevel::Fatal;
-		if(levelStr == "TRACE" || levelStr == "DEBUG")
-			level = MessageLevel::Debug;
-	}
-	else
+	return logClassifier()->classify(line, level);
+}
+
+std::shared_ptr<const LogClassifier> MinecraftInstance::logClassifier() const
+{
+	if(!m_logClassifier)
 	{
-		// Old style forge logs
-		if (line.contains("[INFO]") || line.contains("[CONFIG]") || line.contains("[FINE]") ||
-			line.contains("[FINER]") || line.contains("[FINEST]"))
-			level = MessageLevel::Message;
-		if (line.contains("[SEVERE]") || line.contains("[STDERR]"))
-			level = MessageLevel::Error;
-		if (line.contains("[WARNING]"))
-			level = MessageLevel::Warning;
-		if (line.contains("[DEBUG]"))
-			level = MessageLevel::Debug;
+		m_logClassifier = std::make_shared<LogClassifier>();
 	}
-	if (line.contains("overwriting existing"))
-		return MessageLevel::Fatal;
-	//NOTE: this diverges from the real regexp. no unicode, the first section is + instead of *
-	static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
-	if (line.contains("Exception in thread")
-		|| line.contains(QRegularExpression("\\s+at " + javaSymbol))
-		|| line.contains(QRegularExpression("Caused by: " + javaSymbol))
-		|| line.contains(QRegularExpression("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)"))
-		|| line.contains(QRegularExpression("... \\d+ more$"))
-		)
-		return MessageLevel::Error;
-	return level;
+	return m_logClassifier;
 }
 
 IPathMatcher::Ptr MinecraftInstance::getLogFileMatcher()
@@ -345,6 +322,29 @@ QString MinecraftInstance::getLogFileRoot()
 	return minecraftRoot();
 }
 
+QMap<QString, QStringList> MinecraftInstance::diskUsageParts() const
+{
+	auto mcRoot = minecraftRoot();
+	QMap<QString, QStringList> parts;
+	parts["worlds"] = QStringList{FS::PathCombine(mcRoot, "saves")};
+	parts["mods"] = modFolders() << FS::PathCombine(instanceRoot(), "jarmods");
+	parts["logs"] = QStringList{FS::PathCombine(mcRoot, "logs"), FS::PathCombine(mcRoot, "crash-reports")};
+	parts["screenshots"] = QStringList{FS::PathCombine(mcRoot, "screenshots")};
+	parts["natives"] = QStringList{getNativePath()};
+	return parts;
+}
+
+QStringList MinecraftInstance::modFolders() const
+{
+	auto mcRoot = minecraftRoot();
+	return {FS::PathCombine(mcRoot, "mods"), FS::PathCombine(mcRoot, "coremods")};
+}
+
+QString MinecraftInstance::modListCacheFile(const QString &name) const
+{
+	return FS::PathCombine(instanceRoot(), "modcache", name + ".dat");
+}
+
 QString MinecraftInstance::prettifyTimeDuration(int64_t duration)
 {
 	int seconds = (int) (duration % 60);
@@ -420,6 +420,19 @@ std::shared_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPtr s
 		process->appendStep(step);
 	}
 
+	// create the main launch step early, so it can be pre-started if the user wants that
+	auto mainStep = createMainLaunchStep(pptr, session);
+
+	// start the JVM of the launcher part now, so its startup overlaps with the update steps
+	if(settings()->get("PrewarmJVM").toBool())
+	{
+		auto launcherPartStep = std::dynamic_pointer_cast<LauncherPartLaunch>(mainStep);
+		if(launcherPartStep)
+		{
+			process->appendStep(std::make_shared<PrewarmLauncherPart>(pptr, launcherPartStep));
+		}
+	}
+
 	// if we aren't in offline mode,.
 	if(session->status != AuthSession::PlayableOffline)
 	{
@@ -455,8 +468,7 @@ std::shared_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPtr s
 
 	{
 		// actually launch the game
-		auto step = createMainLaunchStep(pptr, session);
-		process->appendStep(step);
+		process->appendStep(mainStep);
 	}
 
 	// run post-exit command if that's needed
@@ -470,6 +482,7 @@ std::shared_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPtr s
 	{
 		process->setCensorFilter(createCensorFilterFromSession(session));
 	}
+	process->setWindowReadyMarker(settings()->get("WindowReadyLogMarker").toString());
 	m_launchProcess = process;
 	emit launchTaskChanged(m_launchProcess);
 	return m_launchProcess;
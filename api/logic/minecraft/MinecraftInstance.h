@@ -9,6 +9,7 @@
 class ModList;
 class WorldList;
 class LaunchStep;
+class LogClassifier;
 
 class MULTIMC_LOGIC_EXPORT MinecraftInstance: public BaseInstance
 {
@@ -56,14 +57,25 @@ public:
 	/// guess log level from a line of minecraft log
 	virtual MessageLevel::Enum guessLevel(const QString &line, MessageLevel::Enum level) override;
 
+	/// the compiled log level classifier used by guessLevel. Safe to use from other threads.
+	std::shared_ptr<const LogClassifier> logClassifier() const;
+
 	virtual IPathMatcher::Ptr getLogFileMatcher() override;
 
 	virtual QString getLogFileRoot() override;
 
+	virtual QMap<QString, QStringList> diskUsageParts() const override;
+	virtual QStringList modFolders() const override;
+
 	virtual QString getStatusbarDescription() override;
 
 	virtual QStringList getClassPath() const = 0;
 	virtual QStringList getNativeJars() const = 0;
+	/// get the extract exclusions for each native jar
+	virtual QMap<QString, QStringList> getNativeJarExcludes() const
+	{
+		return {};
+	}
 
 	virtual QString getMainClass() const = 0;
 
@@ -80,8 +92,13 @@ protected:
 	virtual QStringList validLaunchMethods() = 0;
 	virtual QString launchMethod();
 	virtual std::shared_ptr<LaunchStep> createMainLaunchStep(LaunchTask *parent, AuthSessionPtr session) = 0;
+	/// where the mod list called name keeps what it read from the mod files
+	QString modListCacheFile(const QString &name) const;
 private:
 	QString prettifyTimeDuration(int64_t duration);
+
+private:
+	mutable std::shared_ptr<LogClassifier> m_logClassifier;
 };
 
 typedef std::shared_ptr<MinecraftInstance> MinecraftInstancePtr;
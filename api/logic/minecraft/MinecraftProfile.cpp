@@ -600,6 +600,28 @@ void MinecraftProfile::getLibraryFiles(const QString& architecture, QStringList&
 	}
 }
 
+QMap<QString, QStringList> MinecraftProfile::getNativeJarExcludes(const QString& architecture, const QString& overridePath) const
+{
+	QMap<QString, QStringList> out;
+	for (auto lib : getLibraries())
+	{
+		QStringList jars, native, native32, native64;
+		lib->getApplicableFiles(currentSystem, jars, native, native32, native64, overridePath);
+		if(architecture == "32")
+		{
+			native.append(native32);
+		}
+		else if(architecture == "64")
+		{
+			native.append(native64);
+		}
+		for(auto & nativeJar: native)
+		{
+			out[nativeJar] = lib->extractExcludes();
+		}
+	}
+	return out;
+}
 
 QString MinecraftProfile::getMainJarUrl() const
 {
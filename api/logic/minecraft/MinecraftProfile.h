@@ -112,6 +112,8 @@ public: /* getters for profile variables */
 	const QList<JarmodPtr> & getJarMods() const;
 	const QList<LibraryPtr> & getLibraries() const;
 	void getLibraryFiles(const QString & architecture, QStringList & jars, QStringList & nativeJars, const QString & overridePath) const;
+	/// map each of the native jars from getLibraryFiles to the extract exclusions of its library
+	QMap<QString, QStringList> getNativeJarExcludes(const QString & architecture, const QString & overridePath) const;
 	QString getMainJarUrl() const;
 	bool hasTrait(const QString & trait) const;
 	ProblemSeverity getProblemSeverity() const;
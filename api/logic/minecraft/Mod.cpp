@@ -32,7 +32,18 @@ Mod::Mod(const QFileInfo &file)
 	repath(file);
 }
 
+Mod::Mod(const QFileInfo &file, NameOnly)
+{
+	setFile(file);
+}
+
 void Mod::repath(const QFileInfo &file)
+{
+	setFile(file);
+	readDetails();
+}
+
+void Mod::setFile(const QFileInfo &file)
 {
 	m_file = file;
 	QString name_base = file.fileName();
@@ -73,7 +84,10 @@ void Mod::repath(const QFileInfo &file)
 		}
 		m_name = name_base;
 	}
+}
 
+void Mod::readDetails()
+{
 	if (m_type == MOD_ZIPFILE)
 	{
 		QuaZip zip(m_file.filePath());
@@ -105,6 +105,13 @@ public:
 	bool strongCompare(const Mod &other) const;
 
 private:
+	friend class ModMetadataCache;
+	struct NameOnly {};
+	/// only looks at the file name, the details are left for readDetails or the cache
+	Mod(const QFileInfo &file, NameOnly);
+	void setFile(const QFileInfo &file);
+	void readDetails();
+
 	void ReadMCModInfo(QByteArray contents);
 	void ReadForgeInfo(QByteArray contents);
 	void ReadLiteModInfo(QByteArray contents);
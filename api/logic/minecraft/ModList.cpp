@@ -22,7 +22,8 @@
 #include <QFileSystemWatcher>
 #include <QDebug>
 
-ModList::ModList(const QString &dir) : QAbstractListModel(), m_dir(dir)
+ModList::ModList(const QString &dir, const QString &cacheFile)
+	: QAbstractListModel(), m_dir(dir), m_cache(cacheFile)
 {
 	FS::ensureFolderPathExists(m_dir.absolutePath());
 	m_dir.setFilter(QDir::Readable | QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs |
@@ -83,7 +84,7 @@ bool ModList::update()
 		// the order surely changed!
 		for (auto entry : folderContents)
 		{
-			newMods.append(Mod(entry));
+			newMods.append(m_cache.get(entry));
 		}
 		orderedMods.append(newMods);
 		orderOrStateChanged = true;
@@ -105,6 +106,7 @@ bool ModList::update()
 				}
 			}
 	}
+	m_cache.save();
 	beginResetModel();
 	mods.swap(orderedMods);
 	endResetModel();
@@ -21,6 +21,7 @@
 #include <QAbstractListModel>
 
 #include "minecraft/Mod.h"
+#include "minecraft/ModMetadataCache.h"
 
 #include "multimc_logic_export.h"
 
@@ -42,7 +43,8 @@ public:
 		NameColumn,
 		VersionColumn
 	};
-	ModList(const QString &dir);
+	/// cacheFile keeps what was read from the mod files between runs, see ModMetadataCache
+	ModList(const QString &dir, const QString &cacheFile = QString());
 
 	virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
 	virtual bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
@@ -115,5 +117,6 @@ protected:
 	QFileSystemWatcher *m_watcher;
 	bool is_watching = false;
 	QDir m_dir;
+	ModMetadataCache m_cache;
 	QList<Mod> mods;
 };
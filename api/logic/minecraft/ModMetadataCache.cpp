@@ -0,0 +1,160 @@
+#include "ModMetadataCache.h"
+#include "FileSystem.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QSaveFile>
+#include <QDebug>
+
+namespace
+{
+const quint32 cacheMagic = 0x4D4D4D43; // MMMC
+const quint32 cacheVersion = 2;
+}
+
+ModMetadataCache::ModMetadataCache(const QString &cacheFile) : m_cacheFile(cacheFile)
+{
+}
+
+Mod ModMetadataCache::get(const QFileInfo &file)
+{
+	Mod mod(file, Mod::NameOnly());
+	// only zips are worth it, the rest is a file name or one small file in a folder
+	if (mod.m_type != Mod::MOD_ZIPFILE && mod.m_type != Mod::MOD_LITEMOD)
+	{
+		mod.readDetails();
+		return mod;
+	}
+	if (!m_loaded)
+	{
+		load();
+	}
+
+	// with .disabled, foo.jar and foo.jar.disabled can both be there and be different mods
+	auto key = file.fileName();
+	m_used.insert(key);
+	qint64 size = file.size();
+	qint64 modified = file.lastModified().toMSecsSinceEpoch();
+	auto iter = m_entries.constFind(key);
+	if (iter != m_entries.constEnd() && iter->size == size && iter->modified == modified)
+	{
+		m_hits++;
+		mod.m_mod_id = iter->modId;
+		mod.m_name = iter->name;
+		mod.m_version = iter->version;
+		mod.m_mcversion = iter->mcversion;
+		mod.m_homeurl = iter->homeurl;
+		mod.m_updateurl = iter->updateurl;
+		mod.m_description = iter->description;
+		mod.m_authors = iter->authors;
+		mod.m_credits = iter->credits;
+		return mod;
+	}
+
+	m_misses++;
+	mod.readDetails();
+	Entry entry;
+	entry.size = size;
+	entry.modified = modified;
+	entry.modId = mod.m_mod_id;
+	entry.name = mod.m_name;
+	entry.version = mod.m_version;
+	entry.mcversion = mod.m_mcversion;
+	entry.homeurl = mod.m_homeurl;
+	entry.updateurl = mod.m_updateurl;
+	entry.description = mod.m_description;
+	entry.authors = mod.m_authors;
+	entry.credits = mod.m_credits;
+	m_entries.insert(key, entry);
+	m_changed = true;
+	return mod;
+}
+
+void ModMetadataCache::save()
+{
+	if (!m_loaded)
+	{
+		return;
+	}
+	// files that weren't asked for are gone
+	for (auto iter = m_entries.begin(); iter != m_entries.end();)
+	{
+		if (m_used.contains(iter.key()))
+		{
+			iter++;
+			continue;
+		}
+		iter = m_entries.erase(iter);
+		m_changed = true;
+	}
+	m_used.clear();
+	if (!m_changed || m_cacheFile.isEmpty())
+	{
+		return;
+	}
+	m_changed = false;
+	if (!FS::ensureFilePathExists(m_cacheFile))
+	{
+		return;
+	}
+	QSaveFile file(m_cacheFile);
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return;
+	}
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_0);
+	out << cacheMagic << cacheVersion << quint32(m_entries.size());
+	for (auto iter = m_entries.begin(); iter != m_entries.end(); iter++)
+	{
+		out << iter.key() << iter->size << iter->modified << iter->modId << iter->name << iter->version
+			<< iter->mcversion << iter->homeurl << iter->updateurl << iter->description << iter->authors
+			<< iter->credits;
+	}
+	if (out.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return;
+	}
+	file.commit();
+}
+
+void ModMetadataCache::load()
+{
+	m_loaded = true;
+	if (m_cacheFile.isEmpty())
+	{
+		return;
+	}
+	QFile file(m_cacheFile);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_0);
+	quint32 magic = 0, version = 0, count = 0;
+	in >> magic >> version >> count;
+	if (in.status() != QDataStream::Ok || magic != cacheMagic || version != cacheVersion)
+	{
+		return;
+	}
+	QHash<QString, Entry> entries;
+	entries.reserve(qMin<quint32>(count, 100000));
+	for (quint32 i = 0; i < count; i++)
+	{
+		QString key;
+		Entry entry;
+		in >> key >> entry.size >> entry.modified >> entry.modId >> entry.name >> entry.version
+			>> entry.mcversion >> entry.homeurl >> entry.updateurl >> entry.description >> entry.authors
+			>> entry.credits;
+		if (in.status() != QDataStream::Ok)
+		{
+			qWarning() << "Mod metadata cache" << m_cacheFile << "is damaged, starting over";
+			return;
+		}
+		entries.insert(key, entry);
+	}
+	m_entries.swap(entries);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <QFileInfo>
+
+#include "minecraft/Mod.h"
+
+#include "multimc_logic_export.h"
+
+/**
+ * What the mod lists read from the mod files, by file name, size and modification time.
+ *
+ * Reading the details of a mod means opening it as a zip and parsing mcmod.info, forgeversion.properties or
+ * litemod.json. With this, that only happens for files that are new or changed since the last time.
+ * Entries go by the whole file name, so a disabled mod and an enabled one of the same name don't mix.
+ *
+ * The cache is kept in a file between runs, if it has one. Entries for files that are gone are dropped on save.
+ */
+class MULTIMC_LOGIC_EXPORT ModMetadataCache
+{
+public:
+	explicit ModMetadataCache(const QString &cacheFile = QString());
+
+	/// a Mod for file, with its details from the cache when the file didn't change
+	Mod get(const QFileInfo &file);
+
+	/// write the cache out if it changed, keeping only the files asked for since the last save
+	void save();
+
+	/// how many files were read from the cache and how many had to be parsed, since it was made
+	int hits() const
+	{
+		return m_hits;
+	}
+	int misses() const
+	{
+		return m_misses;
+	}
+
+private:
+	struct Entry
+	{
+		qint64 size = 0;
+		qint64 modified = 0;
+		QString modId;
+		QString name;
+		QString version;
+		QString mcversion;
+		QString homeurl;
+		QString updateurl;
+		QString description;
+		QString authors;
+		QString credits;
+	};
+	void load();
+
+private:
+	QString m_cacheFile;
+	QHash<QString, Entry> m_entries;
+	QSet<QString> m_used;
+	bool m_loaded = false;
+	bool m_changed = false;
+	int m_hits = 0;
+	int m_misses = 0;
+};
@@ -0,0 +1,129 @@
+#include <QTest>
+#include <QTemporaryDir>
+
+#include <quazip.h>
+#include <quazipfile.h>
+
+#include "FileSystem.h"
+#include "minecraft/ModMetadataCache.h"
+#include "minecraft/ModList.h"
+
+class ModMetadataCacheTest : public QObject
+{
+	Q_OBJECT
+
+	static bool makeMod(const QString &path, const QString &name, const QString &version)
+	{
+		QuaZip zip(path);
+		if (!zip.open(QuaZip::mdCreate))
+		{
+			return false;
+		}
+		QuaZipFile out(&zip);
+		if (!out.open(QIODevice::WriteOnly, QuaZipNewInfo("mcmod.info")))
+		{
+			return false;
+		}
+		out.write(QString("[{\"modid\": \"%1\", \"name\": \"%1\", \"version\": \"%2\", \"authorList\": [\"Someone\"]}]")
+					  .arg(name, version).toUtf8());
+		out.close();
+		zip.close();
+		return zip.getZipError() == 0;
+	}
+
+	QTemporaryDir m_dir;
+	QString m_mods;
+	QString m_cacheFile;
+
+private
+slots:
+	void initTestCase()
+	{
+		m_mods = FS::PathCombine(m_dir.path(), "mods");
+		m_cacheFile = FS::PathCombine(m_dir.path(), "modcache", "mods.dat");
+		QVERIFY(FS::ensureFolderPathExists(m_mods));
+		QVERIFY(makeMod(FS::PathCombine(m_mods, "first.jar"), "First", "1.0"));
+		QVERIFY(makeMod(FS::PathCombine(m_mods, "second.jar"), "Second", "2.0"));
+		FS::write(FS::PathCombine(m_mods, "notes.txt"), "not a mod");
+	}
+
+	void test_parseOnce()
+	{
+		{
+			ModMetadataCache cache(m_cacheFile);
+			auto first = cache.get(QFileInfo(FS::PathCombine(m_mods, "first.jar")));
+			QCOMPARE(first.name(), QString("First"));
+			QCOMPARE(first.version(), QString("1.0"));
+			cache.get(QFileInfo(FS::PathCombine(m_mods, "second.jar")));
+			QCOMPARE(cache.misses(), 2);
+			QCOMPARE(cache.hits(), 0);
+			cache.save();
+		}
+		QVERIFY(QFile::exists(m_cacheFile));
+
+		// a new run reads it back
+		ModMetadataCache cache(m_cacheFile);
+		auto first = cache.get(QFileInfo(FS::PathCombine(m_mods, "first.jar")));
+		QCOMPARE(cache.hits(), 1);
+		QCOMPARE(cache.misses(), 0);
+		QCOMPARE(first.name(), QString("First"));
+		QCOMPARE(first.version(), QString("1.0"));
+		QCOMPARE(first.mod_id(), QString("First"));
+		QCOMPARE(first.authors(), QString("Someone"));
+		QCOMPARE(first.type(), Mod::MOD_ZIPFILE);
+		QVERIFY(first.enabled());
+	}
+
+	void test_disabled()
+	{
+		// an enabled and a disabled mod of the same name are two different files
+		auto path = FS::PathCombine(m_mods, "third.jar");
+		QVERIFY(makeMod(path, "Third", "3.0"));
+		QVERIFY(makeMod(path + ".disabled", "OldThird", "2.9"));
+		{
+			ModMetadataCache cache(m_cacheFile);
+			auto enabled = cache.get(QFileInfo(path));
+			auto disabled = cache.get(QFileInfo(path + ".disabled"));
+			QCOMPARE(cache.misses(), 2);
+			QVERIFY(enabled.enabled());
+			QCOMPARE(enabled.name(), QString("Third"));
+			QVERIFY(!disabled.enabled());
+			QCOMPARE(disabled.name(), QString("OldThird"));
+			cache.save();
+		}
+		ModMetadataCache cache(m_cacheFile);
+		QCOMPARE(cache.get(QFileInfo(path + ".disabled")).version(), QString("2.9"));
+		QCOMPARE(cache.get(QFileInfo(path)).version(), QString("3.0"));
+		QCOMPARE(cache.hits(), 2);
+		QVERIFY(QFile::remove(path));
+		QVERIFY(QFile::remove(path + ".disabled"));
+	}
+
+	void test_changed()
+	{
+		auto path = FS::PathCombine(m_mods, "first.jar");
+		QVERIFY(QFile::remove(path));
+		QVERIFY(makeMod(path, "First", "1.1-longer"));
+		ModMetadataCache cache(m_cacheFile);
+		auto first = cache.get(QFileInfo(path));
+		QCOMPARE(cache.misses(), 1);
+		QCOMPARE(first.version(), QString("1.1-longer"));
+	}
+
+	void test_modList()
+	{
+		ModList list(m_mods, m_cacheFile);
+		QVERIFY(list.update());
+		QCOMPARE(int(list.size()), 3);
+		QCOMPARE(list[0].name(), QString("First"));
+		QCOMPARE(list[2].name(), QString("Second"));
+		// the second update doesn't open anything, and gives the same
+		QVERIFY(list.update());
+		QCOMPARE(list[0].version(), QString("1.1-longer"));
+		QCOMPARE(list[2].version(), QString("2.0"));
+	}
+};
+
+QTEST_GUILESS_MAIN(ModMetadataCacheTest)
+
+#include "ModMetadataCache_test.moc"
@@ -0,0 +1,442 @@
+#include "ModStore.h"
+#include "FileSystem.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <QSet>
+#include <QDebug>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+
+#if defined Q_OS_WIN32
+#include <windows.h>
+#else
+#include <cstdio>
+#endif
+
+namespace
+{
+const quint32 indexMagic = 0x4D4D4353; // MMCS
+const quint32 indexVersion = 1;
+const char *tempSuffix = ".modstore";
+
+/// put src where dst is, in one step
+bool replaceFile(const QString &src, const QString &dst)
+{
+#if defined Q_OS_WIN32
+	return ::MoveFileExW((LPCWSTR)QDir::toNativeSeparators(src).utf16(), (LPCWSTR)QDir::toNativeSeparators(dst).utf16(), MOVEFILE_REPLACE_EXISTING);
+#else
+	return ::rename(QFile::encodeName(src).constData(), QFile::encodeName(dst).constData()) == 0;
+#endif
+}
+
+QByteArray hashFile(const QString &path)
+{
+	QFile file(path);
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		return QByteArray();
+	}
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	if(!hash.addData(&file))
+	{
+		return QByteArray();
+	}
+	return hash.result().toHex();
+}
+}
+
+ModStore::ModStore(const QString &storePath, const QStringList &folders, QObject *parent)
+	: Task(parent), m_storePath(storePath), m_folders(folders), m_aborted(false)
+{
+	connect(&m_watcher, &QFutureWatcher<QString>::finished, this, &ModStore::scanFinished);
+}
+
+ModStore::~ModStore()
+{
+	m_aborted = true;
+	m_watcher.waitForFinished();
+}
+
+void ModStore::setDeduplicate(bool deduplicate)
+{
+	m_deduplicate = deduplicate;
+}
+
+void ModStore::setHardlinks(bool hardlinks)
+{
+	m_hardlinks = hardlinks;
+}
+
+bool ModStore::abort()
+{
+	m_aborted = true;
+	return true;
+}
+
+bool ModStore::scan()
+{
+	m_failReason = run();
+	return m_failReason.isEmpty();
+}
+
+void ModStore::executeTask()
+{
+	setStatus(tr("Looking for duplicate mods..."));
+	m_watcher.setFuture(QtConcurrent::run(this, &ModStore::run));
+}
+
+void ModStore::scanFinished()
+{
+	auto error = m_watcher.result();
+	if(!error.isEmpty())
+	{
+		emitFailed(error);
+		return;
+	}
+	emitSucceeded();
+}
+
+QString ModStore::entryPath(const QByteArray &hash) const
+{
+	auto name = QString::fromLatin1(hash);
+	return FS::PathCombine(m_storePath, name.left(2), name);
+}
+
+QString ModStore::run()
+{
+	m_report = Report();
+	if(!FS::ensureFolderPathExists(m_storePath))
+	{
+		return tr("Couldn't create the mod store in '%1'").arg(m_storePath);
+	}
+	loadIndex();
+
+	// what is in the store already, by hash
+	QHash<QByteArray, qint64> store;
+	QSet<qint64> storeSizes;
+	for(auto &shard : QDir(m_storePath).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+	{
+		for(auto &entry : QDir(shard.absoluteFilePath()).entryInfoList(QDir::Files | QDir::Hidden, QDir::NoSort))
+		{
+			if(entry.fileName().size() != 40)
+			{
+				continue;
+			}
+			store.insert(entry.fileName().toLatin1(), entry.size());
+			storeSizes.insert(entry.size());
+		}
+	}
+
+	// what is in the folders. Only files directly in them, like the mod lists
+	QList<File> files;
+	QSet<QString> seen;
+	QHash<qint64, int> sizes;
+	for(auto &folder : m_folders)
+	{
+		for(auto &entry : QDir(folder).entryInfoList(QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDir::NoSort))
+		{
+			auto path = entry.absoluteFilePath();
+			if(entry.isSymLink() || entry.size() == 0 || path.endsWith(tempSuffix) || seen.contains(path))
+			{
+				continue;
+			}
+			seen.insert(path);
+			File file;
+			file.path = path;
+			file.size = entry.size();
+			file.modified = entry.lastModified().toMSecsSinceEpoch();
+			auto known = m_index.constFind(path);
+			if(known != m_index.constEnd() && known->size == file.size && known->modified == file.modified)
+			{
+				file.hash = known->hash;
+				file.linked = known->linked;
+			}
+			sizes[file.size]++;
+			files.append(file);
+		}
+	}
+
+	// only what has the same size as something else can be a duplicate
+	auto worthHashing = [&](const File &file)
+	{
+		return file.hash.isEmpty() && (sizes.value(file.size) > 1 || storeSizes.contains(file.size));
+	};
+	qint64 total = 0;
+	for(auto &file : files)
+	{
+		if(worthHashing(file))
+		{
+			total += file.size;
+		}
+	}
+	std::atomic<qint64> done(0);
+	QtConcurrent::blockingMap(files, [&](File &file)
+	{
+		if(m_aborted || !worthHashing(file))
+		{
+			return;
+		}
+		file.hash = hashFile(file.path);
+		const qint64 step = 16 * 1024 * 1024;
+		auto before = done.fetch_add(file.size);
+		if(before / step != (before + file.size) / step || before + file.size == total)
+		{
+			QMetaObject::invokeMethod(this, "setProgress", Qt::QueuedConnection, Q_ARG(qint64, before + file.size), Q_ARG(qint64, total));
+		}
+	});
+	if(m_aborted)
+	{
+		return tr("Looking for duplicate mods was aborted.");
+	}
+
+	QHash<QByteArray, QList<int>> groups;
+	for(int i = 0; i < files.size(); i++)
+	{
+		auto &file = files[i];
+		if(file.hash.isEmpty())
+		{
+			continue;
+		}
+		// linked to a store entry that is gone, or was never there
+		if(file.linked && store.value(file.hash, -1) != file.size)
+		{
+			file.linked = false;
+		}
+		groups[file.hash].append(i);
+	}
+
+	if(m_deduplicate)
+	{
+		QMetaObject::invokeMethod(this, "setStatus", Qt::QueuedConnection, Q_ARG(QString, tr("Deduplicating mods...")));
+		int current = 0;
+		for(auto iter = groups.begin(); iter != groups.end() && !m_aborted; iter++)
+		{
+			QMetaObject::invokeMethod(this, "setProgress", Qt::QueuedConnection, Q_ARG(qint64, current++), Q_ARG(qint64, groups.size()));
+			QList<int> unlinked;
+			for(auto i : iter.value())
+			{
+				if(!files[i].linked)
+				{
+					unlinked.append(i);
+				}
+			}
+			auto entry = entryPath(iter.key());
+			if(!store.contains(iter.key()))
+			{
+				// nothing to share with anything else
+				if(unlinked.size() < 2)
+				{
+					continue;
+				}
+				auto &first = files[unlinked.takeFirst()];
+				if(!addToStore(first, entry))
+				{
+					continue;
+				}
+				store.insert(iter.key(), first.size);
+			}
+			for(auto i : unlinked)
+			{
+				replaceWithLink(files[i], entry);
+			}
+		}
+		if(m_aborted)
+		{
+			saveIndex(files);
+			return tr("Deduplicating mods was aborted.");
+		}
+
+		// store entries nothing shares anymore only take up space
+		for(auto iter = store.begin(); iter != store.end();)
+		{
+			bool used = false;
+			for(auto i : groups.value(iter.key()))
+			{
+				used |= files[i].linked;
+			}
+			if(used)
+			{
+				iter++;
+				continue;
+			}
+			auto entry = entryPath(iter.key());
+#if defined Q_OS_WIN32
+			// read only files can't be deleted there
+			QFile::setPermissions(entry, QFile::ReadOwner | QFile::WriteOwner);
+#endif
+			if(!QFile::remove(entry))
+			{
+				qWarning() << "Couldn't remove unused mod store entry" << entry;
+				iter++;
+				continue;
+			}
+			QDir().rmdir(QFileInfo(entry).absolutePath());
+			iter = store.erase(iter);
+		}
+	}
+
+	m_report.files = files.size();
+	for(auto &file : files)
+	{
+		m_report.bytes += file.size;
+	}
+	m_report.storeEntries = store.size();
+	for(auto size : store)
+	{
+		m_report.storeBytes += size;
+	}
+	for(auto iter = groups.begin(); iter != groups.end(); iter++)
+	{
+		int linked = 0;
+		for(auto i : iter.value())
+		{
+			linked += files[i].linked ? 1 : 0;
+		}
+		int unlinked = iter.value().size() - linked;
+		qint64 size = files[iter.value().first()].size;
+		if(linked)
+		{
+			m_report.saved += (linked - 1) * size;
+		}
+		// with a store entry, every file that doesn't share it is one copy too many
+		int extra = store.contains(iter.key()) ? unlinked : unlinked - 1;
+		if(extra > 0)
+		{
+			m_report.duplicates += extra;
+			m_report.reclaimable += extra * size;
+		}
+	}
+	saveIndex(files);
+	return QString();
+}
+
+bool ModStore::shareData(const QString &src, const QString &dst, bool &cloned) const
+{
+	cloned = FS::cloneFile(src, dst);
+	return cloned || (m_hardlinks && FS::hardlinkFile(src, dst));
+}
+
+bool ModStore::addToStore(File &file, const QString &entry)
+{
+	QFileInfo info(file.path);
+	if(info.size() != file.size || info.lastModified().toMSecsSinceEpoch() != file.modified)
+	{
+		// changed since it was hashed
+		return false;
+	}
+	bool cloned;
+	if(!FS::ensureFilePathExists(entry) || !shareData(file.path, entry, cloned))
+	{
+		qWarning() << "Couldn't add" << file.path << "to the mod store";
+		m_report.unshared++;
+		return false;
+	}
+	// nothing writes to the store. With a hard link, that goes for the file too
+	QFile::setPermissions(entry, QFile::ReadOwner | QFile::ReadUser | QFile::ReadGroup | QFile::ReadOther);
+	file.linked = true;
+	file.modified = QFileInfo(file.path).lastModified().toMSecsSinceEpoch();
+	return true;
+}
+
+bool ModStore::replaceWithLink(File &file, const QString &entry)
+{
+	QFileInfo info(file.path);
+	if(info.size() != file.size || info.lastModified().toMSecsSinceEpoch() != file.modified)
+	{
+		return false;
+	}
+	// hidden, so the mod list doesn't pick it up in the meantime
+	auto temp = FS::PathCombine(info.absolutePath(), "." + info.fileName() + tempSuffix);
+	QFile::remove(temp);
+	bool cloned;
+	if(!shareData(entry, temp, cloned))
+	{
+		qWarning() << "Couldn't link" << file.path << "to the mod store";
+		m_report.unshared++;
+		return false;
+	}
+	// a reflink is a file of its own, it keeps what the original allowed
+	if(cloned)
+	{
+		QFile::setPermissions(temp, info.permissions());
+	}
+	if(!replaceFile(temp, file.path))
+	{
+		qWarning() << "Couldn't replace" << file.path << "with a link to the mod store";
+		QFile::remove(temp);
+		return false;
+	}
+	file.linked = true;
+	file.modified = QFileInfo(file.path).lastModified().toMSecsSinceEpoch();
+	return true;
+}
+
+void ModStore::loadIndex()
+{
+	m_index.clear();
+	QFile file(FS::PathCombine(m_storePath, "index.dat"));
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_0);
+	quint32 magic = 0, version = 0, count = 0;
+	in >> magic >> version >> count;
+	if(in.status() != QDataStream::Ok || magic != indexMagic || version != indexVersion)
+	{
+		return;
+	}
+	QHash<QString, IndexEntry> index;
+	index.reserve(qMin<quint32>(count, 1000000));
+	for(quint32 i = 0; i < count; i++)
+	{
+		QString path;
+		IndexEntry entry;
+		in >> path >> entry.size >> entry.modified >> entry.hash >> entry.linked;
+		if(in.status() != QDataStream::Ok)
+		{
+			qWarning() << "Mod store index in" << m_storePath << "is damaged, starting over";
+			return;
+		}
+		index.insert(path, entry);
+	}
+	m_index.swap(index);
+}
+
+void ModStore::saveIndex(const QList<File> &files)
+{
+	QSaveFile file(FS::PathCombine(m_storePath, "index.dat"));
+	if(!file.open(QIODevice::WriteOnly))
+	{
+		return;
+	}
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_0);
+	// only what was hashed, everything else has to be hashed anyway once it matters
+	quint32 count = 0;
+	for(auto &entry : files)
+	{
+		count += entry.hash.isEmpty() ? 0 : 1;
+	}
+	out << indexMagic << indexVersion << count;
+	for(auto &entry : files)
+	{
+		if(!entry.hash.isEmpty())
+		{
+			out << entry.path << entry.size << entry.modified << entry.hash << entry.linked;
+		}
+	}
+	if(out.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return;
+	}
+	file.commit();
+}
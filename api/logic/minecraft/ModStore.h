@@ -0,0 +1,121 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QFutureWatcher>
+#include <atomic>
+
+#include "tasks/Task.h"
+
+#include "multimc_logic_export.h"
+
+/**
+ * A content addressed store for mod files, shared by all instances.
+ *
+ * The files directly in the given folders (mods/, coremods/ of every instance) are compared by size and
+ * hashed when another file or a store entry has the same size. Files with the same SHA-1 are duplicates.
+ * The store keeps one copy of each, as <store>/<first two hex digits>/<sha1>.
+ *
+ * Without deduplication, this only reports how much space could be reclaimed. With it, every duplicate is
+ * replaced by a file that shares its data with the store entry: a reflink where the file system can share
+ * data blocks (each file stays its own and is copied on write), a hard link otherwise (not on Windows).
+ * Hard linked store entries are read only, so writing into one of the files in place fails instead of
+ * changing it for every instance. Replacing, renaming or deleting a mod only touches that instance.
+ *
+ * Hashes are remembered by path, size and modification time in <store>/index.dat.
+ * Store entries that none of the files use anymore are removed when deduplicating.
+ */
+class MULTIMC_LOGIC_EXPORT ModStore : public Task
+{
+	Q_OBJECT
+public:
+	struct Report
+	{
+		/// files looked at and their size
+		int files = 0;
+		qint64 bytes = 0;
+		/// files that could share their data with another and the space that would free
+		int duplicates = 0;
+		qint64 reclaimable = 0;
+		/// space already saved by files sharing their data with the store
+		qint64 saved = 0;
+		/// duplicates that couldn't share their data with the store, like ones on another drive
+		int unshared = 0;
+		/// entries in the store and their size
+		int storeEntries = 0;
+		qint64 storeBytes = 0;
+	};
+
+	ModStore(const QString &storePath, const QStringList &folders, QObject *parent = nullptr);
+	virtual ~ModStore();
+
+	/// replace duplicates with links into the store, instead of only reporting them
+	void setDeduplicate(bool deduplicate);
+
+	/// allow hard links where reflinks aren't possible. On by default, except on Windows.
+	void setHardlinks(bool hardlinks);
+
+	/// do it right here, without an event loop. On failure, the reason is in failReason().
+	bool scan();
+
+	/// what the last scan found. After deduplicating, it describes the folders afterwards.
+	Report report() const
+	{
+		return m_report;
+	}
+
+	virtual bool canAbort() const override
+	{
+		return true;
+	}
+
+public slots:
+	virtual bool abort() override;
+
+protected:
+	virtual void executeTask() override;
+
+private slots:
+	void scanFinished();
+
+private:
+	struct IndexEntry
+	{
+		qint64 size = 0;
+		qint64 modified = 0;
+		QByteArray hash;
+		/// shares its data with the store entry
+		bool linked = false;
+	};
+	struct File
+	{
+		QString path;
+		qint64 size = 0;
+		qint64 modified = 0;
+		QByteArray hash;
+		bool linked = false;
+	};
+
+	QString run();
+	QString entryPath(const QByteArray &hash) const;
+	bool addToStore(File &file, const QString &entry);
+	bool replaceWithLink(File &file, const QString &entry);
+	bool shareData(const QString &src, const QString &dst, bool &cloned) const;
+	void loadIndex();
+	void saveIndex(const QList<File> &files);
+
+private:
+	QString m_storePath;
+	QStringList m_folders;
+	bool m_deduplicate = false;
+#if defined Q_OS_WIN32
+	bool m_hardlinks = false;
+#else
+	bool m_hardlinks = true;
+#endif
+	QHash<QString, IndexEntry> m_index;
+	Report m_report;
+	std::atomic<bool> m_aborted;
+	QFutureWatcher<QString> m_watcher;
+};
@@ -0,0 +1,137 @@
+#include <QTest>
+#include <QTemporaryDir>
+
+#include "FileSystem.h"
+#include "minecraft/ModStore.h"
+
+class ModStoreTest : public QObject
+{
+	Q_OBJECT
+
+	static QByteArray jar(char fill, int size)
+	{
+		return QByteArray(size, fill);
+	}
+
+	QString m_store;
+	QStringList m_folders;
+	QTemporaryDir m_dir;
+
+private
+slots:
+	void initTestCase()
+	{
+		m_store = FS::PathCombine(m_dir.path(), "modstore");
+		for (auto instance : {"a", "b", "c"})
+		{
+			auto mods = FS::PathCombine(m_dir.path(), instance, "mods");
+			auto coremods = FS::PathCombine(m_dir.path(), instance, "coremods");
+			QVERIFY(FS::ensureFolderPathExists(mods));
+			QVERIFY(FS::ensureFolderPathExists(coremods));
+			m_folders << mods << coremods;
+		}
+		// the same mod in all three, once disabled
+		FS::write(FS::PathCombine(m_folders[0], "shared.jar"), jar('s', 10000));
+		FS::write(FS::PathCombine(m_folders[2], "shared.jar"), jar('s', 10000));
+		FS::write(FS::PathCombine(m_folders[4], "shared.jar.disabled"), jar('s', 10000));
+		// same size, different contents
+		FS::write(FS::PathCombine(m_folders[2], "other.jar"), jar('o', 10000));
+		// a core mod in two of them
+		FS::write(FS::PathCombine(m_folders[1], "core.jar"), jar('c', 5000));
+		FS::write(FS::PathCombine(m_folders[3], "core.jar"), jar('c', 5000));
+		FS::write(FS::PathCombine(m_folders[0], "unique.jar"), jar('u', 3000));
+	}
+
+	void test_report()
+	{
+		ModStore store(m_store, m_folders);
+		QVERIFY(store.scan());
+		auto report = store.report();
+		QCOMPARE(report.files, 7);
+		QCOMPARE(report.bytes, qint64(4 * 10000 + 2 * 5000 + 3000));
+		QCOMPARE(report.duplicates, 3);
+		QCOMPARE(report.reclaimable, qint64(2 * 10000 + 5000));
+		QCOMPARE(report.saved, qint64(0));
+		QCOMPARE(report.storeEntries, 0);
+		// nothing changes
+		QVERIFY(QDir(m_store).entryList(QDir::Dirs | QDir::NoDotAndDotDot).isEmpty());
+	}
+
+	void test_unshared()
+	{
+		ModStore store(m_store, m_folders);
+		store.setDeduplicate(true);
+		store.setHardlinks(false);
+		QVERIFY(store.scan());
+		auto report = store.report();
+		if (!report.duplicates)
+		{
+			QSKIP("Reflinks work here");
+		}
+		// one try for each set of duplicates, then they are left as they are
+		QCOMPARE(report.unshared, 2);
+		QCOMPARE(report.saved, qint64(0));
+		QCOMPARE(FS::read(FS::PathCombine(m_folders[2], "shared.jar")), jar('s', 10000));
+	}
+
+	void test_deduplicate()
+	{
+		ModStore store(m_store, m_folders);
+		store.setDeduplicate(true);
+		QVERIFY(store.scan());
+		auto report = store.report();
+		if (report.duplicates)
+		{
+			QSKIP("Neither reflinks nor hard links work here");
+		}
+		QCOMPARE(report.files, 7);
+		QCOMPARE(report.reclaimable, qint64(0));
+		QCOMPARE(report.saved, qint64(2 * 10000 + 5000));
+		QCOMPARE(report.storeEntries, 2);
+		QCOMPARE(report.storeBytes, qint64(10000 + 5000));
+
+		// everything is where it was, with the same contents
+		QCOMPARE(FS::read(FS::PathCombine(m_folders[0], "shared.jar")), jar('s', 10000));
+		QCOMPARE(FS::read(FS::PathCombine(m_folders[2], "shared.jar")), jar('s', 10000));
+		QCOMPARE(FS::read(FS::PathCombine(m_folders[4], "shared.jar.disabled")), jar('s', 10000));
+		QCOMPARE(FS::read(FS::PathCombine(m_folders[2], "other.jar")), jar('o', 10000));
+		QCOMPARE(FS::read(FS::PathCombine(m_folders[3], "core.jar")), jar('c', 5000));
+		QVERIFY(QDir(m_folders[2]).entryList(QDir::Files | QDir::Hidden).size() == 2);
+
+		// a second pass finds nothing left to do
+		ModStore again(m_store, m_folders);
+		QVERIFY(again.scan());
+		QCOMPARE(again.report().duplicates, 0);
+		QCOMPARE(again.report().saved, qint64(2 * 10000 + 5000));
+	}
+
+	void test_replace()
+	{
+		// replacing a mod in one instance leaves the others alone
+		auto replaced = FS::PathCombine(m_folders[2], "shared.jar");
+		QVERIFY(QFile::remove(replaced));
+		FS::write(replaced, jar('n', 10000));
+		QCOMPARE(FS::read(FS::PathCombine(m_folders[0], "shared.jar")), jar('s', 10000));
+		QCOMPARE(FS::read(FS::PathCombine(m_folders[4], "shared.jar.disabled")), jar('s', 10000));
+
+		ModStore store(m_store, m_folders);
+		QVERIFY(store.scan());
+		QCOMPARE(store.report().saved, qint64(10000 + 5000));
+	}
+
+	void test_prune()
+	{
+		// once no instance has the core mod anymore, its store entry goes away
+		QVERIFY(QFile::remove(FS::PathCombine(m_folders[1], "core.jar")));
+		QVERIFY(QFile::remove(FS::PathCombine(m_folders[3], "core.jar")));
+		ModStore store(m_store, m_folders);
+		store.setDeduplicate(true);
+		QVERIFY(store.scan());
+		QCOMPARE(store.report().storeEntries, 1);
+		QCOMPARE(store.report().storeBytes, qint64(10000));
+	}
+};
+
+QTEST_GUILESS_MAIN(ModStoreTest)
+
+#include "ModStore_test.moc"
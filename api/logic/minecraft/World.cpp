@@ -21,7 +21,10 @@
 
 #include "GZip.h"
 #include <MMCZip.h>
+#include <ZipExtractTask.h>
 #include <FileSystem.h>
+#include <Env.h>
+#include <TrashBin.h>
 #include <sstream>
 #include <io/stream_reader.h>
 #include <tag_string.h>
@@ -94,12 +97,9 @@ bool putLevelDatDataToFS(const QFileInfo &file, QByteArray & data)
 	{
 		return false;
 	}
-	QByteArray compressed;
-	if(!GZip::zip(data, compressed))
-	{
-		return false;
-	}
-	if(f.write(compressed) != compressed.size())
+	// compress straight into the file
+	GZipDeflateDevice compressor(&f);
+	if(!compressor.open(QIODevice::WriteOnly) || compressor.write(data) != data.size() || !compressor.finish())
 	{
 		f.cancelWriting();
 		return false;
@@ -187,12 +187,12 @@ bool World::install(const QString &to, const QString &name)
 	bool ok = false;
 	if(m_containerFile.isFile())
 	{
-		QuaZip zip(m_containerFile.absoluteFilePath());
-		if (!zip.open(QuaZip::mdUnzip))
+		ZipExtractTask extractTask(m_containerFile.absoluteFilePath(), finalPath, m_containerOffsetPath);
+		ok = extractTask.extract();
+		if(!ok)
 		{
-			return false;
+			qWarning() << "Couldn't install world:" << extractTask.failReason();
 		}
-		ok = !MMCZip::extractSubDir(&zip, m_containerOffsetPath, finalPath).isEmpty();
 	}
 	else if(m_containerFile.isDir())
 	{
@@ -364,8 +364,7 @@ bool World::destroy()
 	if(!is_valid) return false;
 	if (m_containerFile.isDir())
 	{
-		QDir d(m_containerFile.filePath());
-		return d.removeRecursively();
+		return ENV.trash()->moveToTrash(m_containerFile.filePath());
 	}
 	else if(m_containerFile.isFile())
 	{
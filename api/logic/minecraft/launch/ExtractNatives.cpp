@@ -18,11 +18,44 @@
 #include <launch/LaunchTask.h>
 
 #include <quazip.h>
-#include <JlCompress.h>
-#include <quazipdir.h>
+#include <quazipfile.h>
 #include "MMCZip.h"
 #include "FileSystem.h"
+#include "minecraft/OpSys.h"
+#include "Env.h"
+#include "TrashBin.h"
+#include <QCryptographicHash>
+#include <QDebug>
 #include <QDir>
+#include <QFile>
+#include <QUuid>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+#include <cstdio>
+
+namespace
+{
+struct NativeJar
+{
+	QString source;
+	QStringList excludes;
+	QString hash;
+	// entries to extract and their names in the output folder
+	QStringList entries;
+	QStringList targets;
+	QString error;
+};
+
+struct ExtractionJob
+{
+	QList<NativeJar> jars;
+	QString outputPath;
+	// if not empty, natives are extracted here and outputPath becomes a link to them
+	QString sharedCacheRoot;
+	QString platform;
+	bool applyJnilibHack = false;
+};
+}
 
 static QString replaceSuffix (QString target, const QString &suffix, const QString &replacement)
 {
@@ -34,53 +67,356 @@ static QString replaceSuffix (QString target, const QString &suffix, const QStri
 	return target + replacement;
 }
 
-static bool unzipNatives(QString source, QString targetFolder, bool applyJnilibHack)
+static bool isSharedLibrary(const QString &name)
+{
+	static const QStringList suffixes = {".so", ".dll", ".dylib", ".jnilib"};
+	for(auto & suffix: suffixes)
+	{
+		if(name.endsWith(suffix, Qt::CaseInsensitive))
+		{
+			return true;
+		}
+	}
+	// versioned shared objects, like libopenal.so.1
+	return name.contains(".so.");
+}
+
+static bool isExcluded(const QString &name, const QStringList &excludes)
 {
-	QuaZip zip(source);
+	for(auto & exclude: excludes)
+	{
+		if(name.startsWith(exclude))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static const char * stampFileName = ".natives-stamp";
+
+/// hash the jar and find out which entries we need from it
+static void scanNativeJar(NativeJar &jar, bool applyJnilibHack)
+{
+	QFile file(jar.source);
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		jar.error = QObject::tr("Couldn't read native jar '%1': %2").arg(jar.source, file.errorString());
+		return;
+	}
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	if(!hash.addData(&file))
+	{
+		jar.error = QObject::tr("Couldn't read native jar '%1': %2").arg(jar.source, file.errorString());
+		return;
+	}
+	jar.hash = hash.result().toHex();
+	file.close();
+
+	QuaZip zip(jar.source);
 	if(!zip.open(QuaZip::mdUnzip))
+	{
+		jar.error = QObject::tr("Couldn't open native jar '%1'").arg(jar.source);
+		return;
+	}
+	for(auto & name: zip.getFileNameList())
+	{
+		if(name.endsWith('/') || isExcluded(name, jar.excludes) || !isSharedLibrary(name))
+		{
+			continue;
+		}
+		jar.entries.append(name);
+		jar.targets.append(applyJnilibHack ? replaceSuffix(name, ".jnilib", ".dylib") : name);
+	}
+	zip.close();
+}
+
+static void extractNativeJar(NativeJar &jar, const QString &outputPath)
+{
+	if(jar.entries.isEmpty())
+	{
+		return;
+	}
+	QuaZip zip(jar.source);
+	if(!zip.open(QuaZip::mdUnzip))
+	{
+		jar.error = QObject::tr("Couldn't open native jar '%1'").arg(jar.source);
+		return;
+	}
+	QDir directory(outputPath);
+	for(int i = 0; i < jar.entries.size(); i++)
+	{
+		if (!zip.setCurrentFile(jar.entries[i]) || !MMCZip::extractFile(&zip, "", directory.absoluteFilePath(jar.targets[i])))
+		{
+			jar.error = QObject::tr("Couldn't extract '%1' from native jar '%2' to destination '%3'")
+				.arg(jar.entries[i], jar.source, outputPath);
+			return;
+		}
+	}
+	zip.close();
+}
+
+static QString firstError(const QList<NativeJar> &jars)
+{
+	for(auto & jar: jars)
+	{
+		if(!jar.error.isEmpty())
+		{
+			return jar.error;
+		}
+	}
+	return QString();
+}
+
+static bool isUpToDate(const QString &path, const QString &stamp, const QMap<QString, int> &files)
+{
+	QDir dir(path);
+	QFile stampFile(dir.absoluteFilePath(stampFileName));
+	if(!stampFile.open(QIODevice::ReadOnly))
 	{
 		return false;
 	}
-	QDir directory(targetFolder);
-	if (!zip.goToFirstFile())
+	if(QString::fromUtf8(stampFile.readAll()) != stamp)
 	{
 		return false;
 	}
-	do
+	for(auto iter = files.begin(); iter != files.end(); iter++)
 	{
-		QString name = zip.getCurrentFileName();
-		if(applyJnilibHack)
+		if(!QFileInfo(dir.absoluteFilePath(iter.key())).exists())
 		{
-			name = replaceSuffix(name, ".jnilib", ".dylib");
+			return false;
 		}
-		QString absFilePath = directory.absoluteFilePath(name);
-		if (!MMCZip::extractFile(&zip, "", absFilePath))
+	}
+	return true;
+}
+
+/// extract all the jars into a fresh folder and stamp it
+static QString extractInto(QList<NativeJar> &jars, const QString &outputPath, const QString &stamp)
+{
+	// start from a clean slate, so nothing stale is left behind
+	if(!ENV.trash()->moveToTrash(outputPath))
+	{
+		return QObject::tr("Couldn't remove the old natives in '%1'").arg(outputPath);
+	}
+	if(!FS::ensureFolderPathExists(outputPath))
+	{
+		return QObject::tr("Couldn't create the natives folder '%1'").arg(outputPath);
+	}
+
+	QtConcurrent::blockingMap(jars, [outputPath](NativeJar &jar)
+	{
+		extractNativeJar(jar, outputPath);
+	});
+	auto error = firstError(jars);
+	if(!error.isEmpty())
+	{
+		return error;
+	}
+
+	try
+	{
+		FS::write(QDir(outputPath).absoluteFilePath(stampFileName), stamp.toUtf8());
+	}
+	catch (FileSystemException & e)
+	{
+		// not fatal, we just extract again next time
+		qWarning() << "Couldn't write natives stamp:" << e.cause();
+	}
+	return QString();
+}
+
+/// make linkPath a symlink to target
+static bool linkNatives(const QString &target, const QString &linkPath)
+{
+#if defined Q_OS_WIN32
+	// symlinks need special privileges on Windows and QFile::link makes shortcuts instead
+	Q_UNUSED(target);
+	Q_UNUSED(linkPath);
+	return false;
+#else
+	QFileInfo info(linkPath);
+	if(info.isSymLink())
+	{
+		if(info.symLinkTarget() == QFileInfo(target).absoluteFilePath())
+		{
+			return true;
+		}
+		// swap the link in one step, so it never points at nothing
+		auto tempLink = linkPath + ".tmp-" + QUuid::createUuid().toString().mid(1, 36);
+		if(!QFile::link(QFileInfo(target).absoluteFilePath(), tempLink))
 		{
 			return false;
 		}
-	} while (zip.goToNextFile());
-	zip.close();
-	if(zip.getZipError()!=0)
+		if(::rename(QFile::encodeName(tempLink).constData(), QFile::encodeName(linkPath).constData()) != 0)
+		{
+			QFile::remove(tempLink);
+			return false;
+		}
+		return true;
+	}
+	else if(info.exists() && !FS::deletePath(linkPath))
 	{
 		return false;
 	}
-	return true;
+	if(!FS::ensureFilePathExists(linkPath))
+	{
+		return false;
+	}
+	return QFile::link(QFileInfo(target).absoluteFilePath(), linkPath);
+#endif
+}
+
+static ExtractNatives::Result runExtraction(ExtractionJob job)
+{
+	ExtractNatives::Result result;
+	bool applyJnilibHack = job.applyJnilibHack;
+	QtConcurrent::blockingMap(job.jars, [applyJnilibHack](NativeJar &jar)
+	{
+		scanNativeJar(jar, applyJnilibHack);
+	});
+	result.error = firstError(job.jars);
+	if(!result.error.isEmpty())
+	{
+		return result;
+	}
+
+	// if several jars contain the same file, the last one wins - same as extracting them in order
+	QMap<QString, int> owners;
+	for(int i = 0; i < job.jars.size(); i++)
+	{
+		for(auto & target: job.jars[i].targets)
+		{
+			owners[target] = i;
+		}
+	}
+	for(int i = 0; i < job.jars.size(); i++)
+	{
+		auto & jar = job.jars[i];
+		for(int j = jar.entries.size() - 1; j >= 0; j--)
+		{
+			if(owners[jar.targets[j]] != i)
+			{
+				jar.entries.removeAt(j);
+				jar.targets.removeAt(j);
+			}
+		}
+	}
+
+	// the stamp only depends on content, so it can also serve as a key for the shared cache
+	QString stamp;
+	stamp += "platform " + job.platform + "\n";
+	stamp += QString("jnilibhack %1\n").arg(applyJnilibHack ? 1 : 0);
+	for(auto & jar: job.jars)
+	{
+		stamp += "jar " + jar.hash + "\n";
+	}
+	for(auto iter = owners.begin(); iter != owners.end(); iter++)
+	{
+		stamp += "file " + iter.key() + "\n";
+	}
+
+	if(!job.sharedCacheRoot.isEmpty())
+	{
+		QString key = QCryptographicHash::hash(stamp.toUtf8(), QCryptographicHash::Sha1).toHex();
+		// a folder is never replaced once it is there, another game may be loading from it.
+		// A damaged one is left alone and the next free name is used instead.
+		QString sharedPath;
+		QString freePath;
+		for(int i = 0; sharedPath.isEmpty() && freePath.isEmpty(); i++)
+		{
+			auto candidate = FS::PathCombine(job.sharedCacheRoot, i ? QString("%1-%2").arg(key).arg(i) : key);
+			if(!QFileInfo(candidate).exists())
+			{
+				freePath = candidate;
+			}
+			else if(isUpToDate(candidate, stamp, owners))
+			{
+				sharedPath = candidate;
+			}
+		}
+		if(sharedPath.isEmpty())
+		{
+			// extract next to the final folder and move it in place, so other launches never see it half-done
+			QString tempPath = freePath + ".tmp-" + QUuid::createUuid().toString().mid(1, 36);
+			result.error = extractInto(job.jars, tempPath, stamp);
+			if(!result.error.isEmpty())
+			{
+				FS::deletePath(tempPath);
+				return result;
+			}
+			if(!QDir().rename(tempPath, freePath))
+			{
+				// another launch may have been faster
+				FS::deletePath(tempPath);
+				if(!isUpToDate(freePath, stamp, owners))
+				{
+					result.error = QObject::tr("Couldn't move the natives into the shared cache folder '%1'").arg(freePath);
+					return result;
+				}
+			}
+			sharedPath = freePath;
+		}
+		if(linkNatives(sharedPath, job.outputPath))
+		{
+			result.shared = true;
+			result.upToDate = true;
+			return result;
+		}
+		qWarning() << "Couldn't link" << job.outputPath << "to the shared natives in" << sharedPath << ", extracting into the instance.";
+	}
+
+	if(isUpToDate(job.outputPath, stamp, owners))
+	{
+		result.upToDate = true;
+		return result;
+	}
+	result.error = extractInto(job.jars, job.outputPath, stamp);
+	return result;
 }
 
 void ExtractNatives::executeTask()
 {
 	auto instance = m_parent->instance();
 	std::shared_ptr<MinecraftInstance> minecraftInstance = std::dynamic_pointer_cast<MinecraftInstance>(instance);
-	auto outputPath  = minecraftInstance->getNativePath();
-	auto toExtract = minecraftInstance->getNativeJars();
 	auto javaVersion = minecraftInstance->getJavaVersion();
-	bool jniHackEnabled = javaVersion.major() >= 8;
-	for(const auto &source: toExtract)
+
+	ExtractionJob job;
+	job.outputPath = minecraftInstance->getNativePath();
+	job.applyJnilibHack = javaVersion.major() >= 8;
+	job.platform = OpSys_toString(currentSystem) + "-" + instance->settings()->get("JavaArchitecture").toString();
+	if(instance->settings()->get("SharedNatives").toBool())
 	{
-		if(!unzipNatives(source, outputPath, jniHackEnabled))
-		{
-			emitFailed(tr("Couldn't extract native jar '%1' to destination '%2'").arg(source, outputPath));
-		}
+		job.sharedCacheRoot = QDir::current().absoluteFilePath("natives");
+	}
+	auto excludes = minecraftInstance->getNativeJarExcludes();
+	for(const auto &source: minecraftInstance->getNativeJars())
+	{
+		NativeJar jar;
+		jar.source = source;
+		jar.excludes = excludes.value(source);
+		job.jars.append(jar);
+	}
+
+	connect(&m_watcher, &QFutureWatcher<Result>::finished, this, &ExtractNatives::extractionFinished);
+	m_watcher.setFuture(QtConcurrent::run(runExtraction, job));
+}
+
+void ExtractNatives::extractionFinished()
+{
+	auto result = m_watcher.result();
+	if(!result.error.isEmpty())
+	{
+		emit logLine(result.error, MessageLevel::Fatal);
+		emitFailed(result.error);
+		return;
+	}
+	if(result.shared)
+	{
+		emit logLine(tr("Using shared native libraries.\n"), MessageLevel::MultiMC);
+	}
+	else if(result.upToDate)
+	{
+		emit logLine(tr("Native libraries are up to date.\n"), MessageLevel::MultiMC);
 	}
 	emitSucceeded();
 }
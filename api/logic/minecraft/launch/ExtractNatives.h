@@ -17,9 +17,18 @@
 
 #include <launch/LaunchStep.h>
 #include <memory>
+#include <QFutureWatcher>
 #include "minecraft/auth/AuthSession.h"
 
-// FIXME: temporary wrapper for existing task.
+/*
+ * Extracts the shared libraries from the native jars of the instance, using a pool of worker threads.
+ *
+ * The output folder is stamped with the hashes of the jars it was extracted from,
+ * so if nothing changed since the last launch, nothing is extracted.
+ *
+ * With the shared natives cache enabled, the natives go into a global folder keyed by that stamp
+ * and the instance natives folder becomes a symlink to it.
+ */
 class ExtractNatives: public LaunchStep
 {
 	Q_OBJECT
@@ -32,6 +41,19 @@ public:
 	{
 		return false;
 	}
+
+	struct Result
+	{
+		bool upToDate = false;
+		bool shared = false;
+		QString error;
+	};
+
+private slots:
+	void extractionFinished();
+
+private:
+	QFutureWatcher<Result> m_watcher;
 };
 
 
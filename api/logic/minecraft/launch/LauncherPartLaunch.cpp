@@ -19,6 +19,7 @@
 #include <minecraft/MinecraftInstance.h>
 #include <FileSystem.h>
 #include <QStandardPaths>
+#include <QDebug>
 
 LauncherPartLaunch::LauncherPartLaunch(LaunchTask *parent) : LaunchStep(parent)
 {
@@ -26,12 +27,68 @@ LauncherPartLaunch::LauncherPartLaunch(LaunchTask *parent) : LaunchStep(parent)
 	connect(&m_process, &LoggedProcess::stateChanged, this, &LauncherPartLaunch::on_state);
 }
 
+void LauncherPartLaunch::prewarm()
+{
+	if(m_prewarmed)
+	{
+		return;
+	}
+	m_prewarmed = true;
+	// the process outlives this object (it is detachable), so make sure it goes away if the launch doesn't get this far
+	connect(m_parent, &Task::failed, this, &LauncherPartLaunch::on_parentFailed);
+	QString reason;
+	if(!startProcess(reason))
+	{
+		m_prewarmFailure = reason;
+	}
+}
+
 void LauncherPartLaunch::executeTask()
 {
 	auto instance = m_parent->instance();
 	std::shared_ptr<MinecraftInstance> minecraftInstance = std::dynamic_pointer_cast<MinecraftInstance>(instance);
 
 	m_launchScript = minecraftInstance->createLaunchScript(m_session);
+
+	if(!m_prewarmed)
+	{
+		QString reason;
+		if(!startProcess(reason))
+		{
+			emitFailed(reason);
+		}
+		return;
+	}
+
+	if(!m_prewarmFailure.isEmpty())
+	{
+		emitFailed(m_prewarmFailure);
+		return;
+	}
+	switch(m_process.state())
+	{
+		case LoggedProcess::NotRunning:
+		case LoggedProcess::Starting:
+			// on_state will send the script once the process is up
+			break;
+		case LoggedProcess::Running:
+			sendLaunchScript();
+			break;
+		default:
+		{
+			QString reason = tr("The pre-started Java process exited before the game could be launched.");
+			emit logLine(reason, MessageLevel::Fatal);
+			emitFailed(reason);
+			break;
+		}
+	}
+}
+
+bool LauncherPartLaunch::startProcess(QString &failReason)
+{
+	auto instance = m_parent->instance();
+	std::shared_ptr<MinecraftInstance> minecraftInstance = std::dynamic_pointer_cast<MinecraftInstance>(instance);
+
 	QStringList args = minecraftInstance->javaArguments();
 	QString allArgs = args.join(", ");
 	emit logLine("Java Arguments:\n[" + m_parent->censorPrivateInfo(allArgs) + "]\n\n", MessageLevel::MultiMC);
@@ -51,10 +108,9 @@ void LauncherPartLaunch::executeTask()
 		auto realWrapperCommand = QStandardPaths::findExecutable(wrapperCommand);
 		if (realWrapperCommand.isEmpty())
 		{
-			QString reason = tr("The wrapper command \"%1\" couldn't be found.").arg(wrapperCommand);
-			emit logLine(reason, MessageLevel::Fatal);
-			emitFailed(reason);
-			return;
+			failReason = tr("The wrapper command \"%1\" couldn't be found.").arg(wrapperCommand);
+			emit logLine(failReason, MessageLevel::Fatal);
+			return false;
 		}
 		emit logLine("Wrapper command is:\n" + wrapperCommand + "\n\n", MessageLevel::MultiMC);
 		args.prepend(javaPath);
@@ -64,6 +120,26 @@ void LauncherPartLaunch::executeTask()
 	{
 		m_process.start(javaPath, args);
 	}
+	return true;
+}
+
+void LauncherPartLaunch::sendLaunchScript()
+{
+	if(m_scriptSent)
+	{
+		return;
+	}
+	m_scriptSent = true;
+	// only now the process becomes the game, a pre-started one may have been waiting for updates
+	emit logLine(tr("Minecraft process ID: %1\n\n").arg(m_process.processId()), MessageLevel::MultiMC);
+	m_parent->setPid(m_process.processId());
+	m_parent->instance()->setLastLaunch();
+	// send the launch script to the launcher part
+	m_process.write(m_launchScript.toUtf8());
+	qDebug() << m_launchScript;
+
+	mayProceed = true;
+	emit readyForLaunch();
 }
 
 void LauncherPartLaunch::on_state(LoggedProcess::State state)
@@ -75,6 +151,12 @@ void LauncherPartLaunch::on_state(LoggedProcess::State state)
 			//: Error message displayed if instace can't start
 			QString reason = tr("Could not launch minecraft!");
 			emit logLine(reason, MessageLevel::Fatal);
+			// pre-started and this step isn't running yet -> report it when it is
+			if(!isRunning())
+			{
+				m_prewarmFailure = reason;
+				return;
+			}
 			emitFailed(reason);
 			return;
 		}
@@ -83,12 +165,22 @@ void LauncherPartLaunch::on_state(LoggedProcess::State state)
 
 		{
 			m_parent->setPid(-1);
+			if(!isRunning())
+			{
+				m_prewarmFailure = tr("The pre-started Java process exited before the game could be launched.");
+				return;
+			}
 			emitFailed("Game crashed.");
 			return;
 		}
 		case LoggedProcess::Finished:
 		{
 			m_parent->setPid(-1);
+			if(!isRunning())
+			{
+				m_prewarmFailure = tr("The pre-started Java process exited before the game could be launched.");
+				return;
+			}
 			// if the exit code wasn't 0, report this as a crash
 			auto exitCode = m_process.exitCode();
 			if(exitCode != 0)
@@ -103,21 +195,30 @@ void LauncherPartLaunch::on_state(LoggedProcess::State state)
 			break;
 		}
 		case LoggedProcess::Running:
-			emit logLine(tr("Minecraft process ID: %1\n\n").arg(m_process.processId()), MessageLevel::MultiMC);
-			m_parent->setPid(m_process.processId());
-			m_parent->instance()->setLastLaunch();
-			// send the launch script to the launcher part
-			m_process.write(m_launchScript.toUtf8());
-			qDebug() << m_launchScript;
-
-			mayProceed = true;
-			emit readyForLaunch();
+			// a pre-started process waits for the step to run before it gets the script
+			if(isRunning())
+			{
+				sendLaunchScript();
+			}
 			break;
 		default:
 			break;
 	}
 }
 
+void LauncherPartLaunch::on_parentFailed()
+{
+	if(m_scriptSent)
+	{
+		return;
+	}
+	auto state = m_process.state();
+	if (state == LoggedProcess::Running || state == LoggedProcess::Starting)
+	{
+		m_process.kill();
+	}
+}
+
 void LauncherPartLaunch::setWorkingDirectory(const QString &wd)
 {
 	m_process.setWorkingDirectory(wd);
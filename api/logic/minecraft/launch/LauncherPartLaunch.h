@@ -37,8 +37,19 @@ public:
 		m_session = session;
 	}
 
+	/**
+	 * Start the java process ahead of time, before this step runs.
+	 * The launch script is only sent once the step itself is executed.
+	 */
+	void prewarm();
+
 private slots:
 	void on_state(LoggedProcess::State state);
+	void on_parentFailed();
+
+private:
+	bool startProcess(QString &failReason);
+	void sendLaunchScript();
 
 private:
 	LoggedProcess m_process;
@@ -46,4 +57,7 @@ private:
 	AuthSessionPtr m_session;
 	QString m_launchScript;
 	bool mayProceed = false;
+	bool m_prewarmed = false;
+	bool m_scriptSent = false;
+	QString m_prewarmFailure;
 };
@@ -0,0 +1,44 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <launch/LaunchStep.h>
+#include <memory>
+
+class LauncherPartLaunch;
+
+/*
+ * Starts the java process of a LauncherPartLaunch step early, so JVM startup overlaps with the
+ * update and jar modding steps. The actual launch still happens when the LauncherPartLaunch step runs.
+ */
+class PrewarmLauncherPart: public LaunchStep
+{
+	Q_OBJECT
+public:
+	explicit PrewarmLauncherPart(LaunchTask *parent, std::shared_ptr<LauncherPartLaunch> launchStep)
+		: LaunchStep(parent), m_launchStep(launchStep) {};
+	virtual ~PrewarmLauncherPart(){};
+
+	virtual void executeTask();
+	virtual bool canAbort() const
+	{
+		return true;
+	}
+	virtual bool abort();
+
+private:
+	std::shared_ptr<LauncherPartLaunch> m_launchStep;
+};
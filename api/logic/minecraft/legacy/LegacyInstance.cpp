@@ -234,7 +234,7 @@ std::shared_ptr<ModList> LegacyInstance::coreModList() const
 {
 	if (!core_mod_list)
 	{
-		core_mod_list.reset(new ModList(coreModsDir()));
+		core_mod_list.reset(new ModList(coreModsDir(), modListCacheFile("coremods")));
 	}
 	core_mod_list->update();
 	return core_mod_list;
@@ -244,7 +244,7 @@ std::shared_ptr<LegacyModList> LegacyInstance::jarModList() const
 {
 	if (!jar_mod_list)
 	{
-		auto list = new LegacyModList(jarModsDir(), modListFile());
+		auto list = new LegacyModList(jarModsDir(), modListFile(), modListCacheFile("jarmods"));
 		connect(list, SIGNAL(changed()), SLOT(jarModsChanged()));
 		jar_mod_list.reset(list);
 	}
@@ -267,7 +267,7 @@ std::shared_ptr<ModList> LegacyInstance::loaderModList() const
 {
 	if (!loader_mod_list)
 	{
-		loader_mod_list.reset(new ModList(loaderModsDir()));
+		loader_mod_list.reset(new ModList(loaderModsDir(), modListCacheFile("mods")));
 	}
 	loader_mod_list->update();
 	return loader_mod_list;
@@ -277,7 +277,7 @@ std::shared_ptr<ModList> LegacyInstance::texturePackList() const
 {
 	if (!texture_pack_list)
 	{
-		texture_pack_list.reset(new ModList(texturePacksDir()));
+		texture_pack_list.reset(new ModList(texturePacksDir(), modListCacheFile("texturepacks")));
 	}
 	texture_pack_list->update();
 	return texture_pack_list;
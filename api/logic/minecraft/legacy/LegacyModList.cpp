@@ -22,8 +22,8 @@
 #include <QFileSystemWatcher>
 #include <QDebug>
 
-LegacyModList::LegacyModList(const QString &dir, const QString &list_file)
-	: QAbstractListModel(), m_dir(dir), m_list_file(list_file)
+LegacyModList::LegacyModList(const QString &dir, const QString &list_file, const QString &cacheFile)
+	: QAbstractListModel(), m_dir(dir), m_list_file(list_file), m_cache(cacheFile)
 {
 	FS::ensureFolderPathExists(m_dir.absolutePath());
 	m_dir.setFilter(QDir::Readable | QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs |
@@ -119,7 +119,7 @@ bool LegacyModList::update()
 			// remove from the actual folder contents list
 			folderContents.takeAt(idx);
 			// append the new mod
-			orderedMods.append(Mod(info));
+			orderedMods.append(m_cache.get(info));
 			if (isEnabled != item.enabled)
 				orderOrStateChanged = true;
 		}
@@ -134,7 +134,7 @@ bool LegacyModList::update()
 		// the order surely changed!
 		for (auto entry : folderContents)
 		{
-			newMods.append(Mod(entry));
+			newMods.append(m_cache.get(entry));
 		}
 		internalSort(newMods);
 		orderedMods.append(newMods);
@@ -157,6 +157,7 @@ bool LegacyModList::update()
 				}
 			}
 	}
+	m_cache.save();
 	beginResetModel();
 	mods.swap(orderedMods);
 	endResetModel();
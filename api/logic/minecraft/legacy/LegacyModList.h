@@ -21,6 +21,7 @@
 #include <QAbstractListModel>
 
 #include "minecraft/Mod.h"
+#include "minecraft/ModMetadataCache.h"
 
 #include "multimc_logic_export.h"
 
@@ -42,7 +43,8 @@ public:
 		NameColumn,
 		VersionColumn
 	};
-	LegacyModList(const QString &dir, const QString &list_file = QString());
+	/// cacheFile keeps what was read from the mod files between runs, see ModMetadataCache
+	LegacyModList(const QString &dir, const QString &list_file = QString(), const QString &cacheFile = QString());
 
 	virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
 	virtual bool setData(const QModelIndex &index, const QVariant &value,
@@ -156,5 +158,6 @@ protected:
 	QDir m_dir;
 	QString m_list_file;
 	QString m_list_id;
+	ModMetadataCache m_cache;
 	QList<Mod> mods;
 };
@@ -393,7 +393,34 @@ std::shared_ptr<Task> OneSixInstance::createJarModdingTask()
 				tempJar.remove();
 			}
 			auto finalJarPath = QDir(m_inst->instanceRoot()).absoluteFilePath("minecraft.jar");
+			auto keyPath = QDir(m_inst->instanceRoot()).absoluteFilePath("minecraft.jar.key");
 			QFile finalJar(finalJarPath);
+			QFile keyFile(keyPath);
+
+			auto jarMods = m_inst->getJarMods();
+			auto sourceJarPath = m_inst->versionsPath().absoluteFilePath(version_id + "/" + version_id + ".jar");
+
+			// if the jar was already built from the same inputs, keep it
+			QString key;
+			if(jarMods.size())
+			{
+				key = MMCZip::moddedJarKey(sourceJarPath, jarMods);
+				if(finalJar.exists() && keyFile.open(QIODevice::ReadOnly))
+				{
+					auto oldKey = QString::fromUtf8(keyFile.readAll());
+					keyFile.close();
+					if(oldKey == key)
+					{
+						emitSucceeded();
+						return;
+					}
+				}
+			}
+
+			if(keyFile.exists())
+			{
+				keyFile.remove();
+			}
 			if(finalJar.exists())
 			{
 				if(!finalJar.remove())
@@ -404,19 +431,22 @@ std::shared_ptr<Task> OneSixInstance::createJarModdingTask()
 			}
 
 			// create temporary modded jar, if needed
-			auto jarMods = m_inst->getJarMods();
 			if(jarMods.size())
 			{
-				auto sourceJarPath = m_inst->versionsPath().absoluteFilePath(version_id + "/" + version_id + ".jar");
-				QString localPath = version_id + "/" + version_id + ".jar";
-				auto metacache = ENV.metacache();
-				auto entry = metacache->resolveEntry("versions", localPath);
-				QString fullJarPath = entry->getFullPath();
 				if(!MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods))
 				{
 					emitFailed(tr("Failed to create the custom Minecraft jar file."));
 					return;
 				}
+				try
+				{
+					FS::write(keyPath, key.toUtf8());
+				}
+				catch (FileSystemException & e)
+				{
+					// not fatal, the jar will be rebuilt next time
+					qWarning() << "Couldn't write the modded jar key:" << e.cause();
+				}
 			}
 			emitSucceeded();
 		}
@@ -427,16 +457,14 @@ std::shared_ptr<Task> OneSixInstance::createJarModdingTask()
 
 void OneSixInstance::cleanupAfterRun()
 {
-	QString target_dir = FS::PathCombine(instanceRoot(), "natives/");
-	QDir dir(target_dir);
-	dir.removeRecursively();
+	// NOTE: natives are kept around. ExtractNatives only replaces them when the native jars change.
 }
 
 std::shared_ptr<ModList> OneSixInstance::loaderModList() const
 {
 	if (!m_loader_mod_list)
 	{
-		m_loader_mod_list.reset(new ModList(loaderModsDir()));
+		m_loader_mod_list.reset(new ModList(loaderModsDir(), modListCacheFile("mods")));
 	}
 	m_loader_mod_list->update();
 	return m_loader_mod_list;
@@ -446,7 +474,7 @@ std::shared_ptr<ModList> OneSixInstance::coreModList() const
 {
 	if (!m_core_mod_list)
 	{
-		m_core_mod_list.reset(new ModList(coreModsDir()));
+		m_core_mod_list.reset(new ModList(coreModsDir(), modListCacheFile("coremods")));
 	}
 	m_core_mod_list->update();
 	return m_core_mod_list;
@@ -456,7 +484,7 @@ std::shared_ptr<ModList> OneSixInstance::resourcePackList() const
 {
 	if (!m_resource_pack_list)
 	{
-		m_resource_pack_list.reset(new ModList(resourcePacksDir()));
+		m_resource_pack_list.reset(new ModList(resourcePacksDir(), modListCacheFile("resourcepacks")));
 	}
 	m_resource_pack_list->update();
 	return m_resource_pack_list;
@@ -466,7 +494,7 @@ std::shared_ptr<ModList> OneSixInstance::texturePackList() const
 {
 	if (!m_texture_pack_list)
 	{
-		m_texture_pack_list.reset(new ModList(texturePacksDir()));
+		m_texture_pack_list.reset(new ModList(texturePacksDir(), modListCacheFile("texturepacks")));
 	}
 	m_texture_pack_list->update();
 	return m_texture_pack_list;
@@ -677,3 +705,9 @@ QStringList OneSixInstance::getNativeJars() const
 	m_profile->getLibraryFiles(javaArchitecture, jars, nativeJars, getLocalLibraryPath());
 	return nativeJars;
 }
+
+QMap<QString, QStringList> OneSixInstance::getNativeJarExcludes() const
+{
+	auto javaArchitecture = settings()->get("JavaArchitecture").toString();
+	return m_profile->getNativeJarExcludes(javaArchitecture, getLocalLibraryPath());
+}
@@ -102,6 +102,7 @@ public:
 	QString getMainClass() const override;
 
 	QStringList getNativeJars() const override;
+	QMap<QString, QStringList> getNativeJarExcludes() const override;
 	QString getNativePath() const override;
 
 	QString getLocalLibraryPath() const override;
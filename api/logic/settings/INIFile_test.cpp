@@ -1,7 +1,10 @@
 #include <QTest>
+#include <QTemporaryDir>
 #include "TestUtil.h"
 
 #include "settings/INIFile.h"
+#include "settings/INISettingsObject.h"
+#include "settings/Setting.h"
 
 class IniFileTest : public QObject
 {
@@ -55,6 +58,40 @@ slots:
 		QCOMPARE(a, f2.get("a","NOT SET").toString());
 		QCOMPARE(b, f2.get("b","NOT SET").toString());
 	}
+
+	void test_setContents()
+	{
+		QTemporaryDir dir;
+		QString filename = dir.path() + "/instance.cfg";
+		INIFile f;
+		f.set("name", "old");
+		f.set("notes", "same");
+		f.saveFile(filename);
+
+		INISettingsObject settings(filename);
+		settings.registerSetting("name", "");
+		settings.registerSetting("notes", "");
+		settings.registerSetting("iconKey", "default");
+		QStringList changed;
+		connect(&settings, &SettingsObject::SettingChanged, [&](const Setting &setting, QVariant)
+		{
+			changed.append(setting.id());
+		});
+
+		INIFile contents = f;
+		contents.set("name", "new");
+		contents.set("iconKey", "grass");
+		settings.setContents(contents);
+		changed.sort();
+		QCOMPARE(changed, QStringList({"iconKey", "name"}));
+		QCOMPARE(settings.get("name").toString(), QString("new"));
+		QCOMPARE(settings.get("iconKey").toString(), QString("grass"));
+
+		// nothing is written back
+		INIFile onDisk;
+		onDisk.loadFile(filename);
+		QCOMPARE(onDisk.get("name", "NOT SET").toString(), QString("old"));
+	}
 };
 
 QTEST_GUILESS_MAIN(IniFileTest)
@@ -16,6 +16,8 @@
 #include "INISettingsObject.h"
 #include "Setting.h"
 
+#include <QVector>
+
 INISettingsObject::INISettingsObject(const QString &path, QObject *parent)
 	: SettingsObject(parent)
 {
@@ -23,6 +25,13 @@ INISettingsObject::INISettingsObject(const QString &path, QObject *parent)
 	m_ini.loadFile(path);
 }
 
+INISettingsObject::INISettingsObject(const QString &path, const INIFile &contents, QObject *parent)
+	: SettingsObject(parent)
+{
+	m_filePath = path;
+	m_ini = contents;
+}
+
 void INISettingsObject::setFilePath(const QString &filePath)
 {
 	m_filePath = filePath;
@@ -33,6 +42,27 @@ bool INISettingsObject::reload()
 	return m_ini.loadFile(m_filePath) && SettingsObject::reload();
 }
 
+void INISettingsObject::setContents(const INIFile &contents)
+{
+	auto settings = allSettings();
+	QVector<QVariant> previous;
+	previous.reserve(settings.size());
+	for(auto setting: settings)
+	{
+		previous.append(setting->get());
+	}
+	m_ini = contents;
+	// only this object tells about the change, the settings themselves would write it back
+	for(int i = 0; i < settings.size(); i++)
+	{
+		auto value = settings[i]->get();
+		if(value != previous[i])
+		{
+			emit SettingChanged(*settings[i], value);
+		}
+	}
+}
+
 void INISettingsObject::suspendSave()
 {
 	m_suspendSave = true;
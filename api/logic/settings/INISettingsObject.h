@@ -31,6 +31,8 @@ class MULTIMC_LOGIC_EXPORT INISettingsObject : public SettingsObject
 	Q_OBJECT
 public:
 	explicit INISettingsObject(const QString &path, QObject *parent = 0);
+	/// Use contents that were already read from path, elsewhere
+	INISettingsObject(const QString &path, const INIFile &contents, QObject *parent = 0);
 
 	/*!
 	 * \brief Gets the path to the INI file.
@@ -49,6 +51,18 @@ public:
 
 	bool reload() override;
 
+	/// What the file holds, as it was last read or written
+	const INIFile &contents() const
+	{
+		return m_ini;
+	}
+
+	/**
+	 * Take contents that were read from the file elsewhere, without writing them back.
+	 * SettingChanged() is emitted for every setting that has a different value now.
+	 */
+	void setContents(const INIFile &contents);
+
 	void suspendSave() override;
 	void resumeSave() override;
 
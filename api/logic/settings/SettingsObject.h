@@ -204,6 +204,12 @@ protected:
 	 */
 	virtual QVariant retrieveValue(const Setting &setting) = 0;
 
+	/// all the registered settings
+	QList<std::shared_ptr<Setting>> allSettings() const
+	{
+		return m_settings.values();
+	}
+
 	friend class Setting;
 
 private:
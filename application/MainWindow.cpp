@@ -49,7 +49,8 @@
 #include <BaseInstance.h>
 #include <Env.h>
 #include <InstanceList.h>
-#include <MMCZip.h>
+#include <ZipExtractTask.h>
+#include <InstanceCopyTask.h>
 #include <icons/IconList.h>
 #include <java/JavaUtils.h>
 #include <java/JavaInstallList.h>
@@ -67,6 +68,7 @@
 #include <updater/DownloadTask.h>
 #include <updater/UpdateChecker.h>
 #include <DesktopServices.h>
+#include <TrashBin.h>
 #include "InstanceWindow.h"
 #include "InstancePageProvider.h"
 #include "InstanceProxyModel.h"
@@ -471,13 +473,31 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new MainWindow
 	connect(MMC->icons().get(), &IconList::iconUpdated, this, &MainWindow::iconUpdated);
 
 	// model reset -> selection is invalid. All the instance pointers are wrong.
-	connect(MMC->instances().get(), &InstanceList::dataIsInvalid, this, &MainWindow::selectionBad);
+	connect(MMC->instances().get(), &InstanceList::dataIsInvalid, this, [this]()
+	{
+		// the selection only has to be redone if the selected instance is no longer in the list
+		if(m_selectedInstance && MMC->instances()->getInstanceById(m_selectedInstance->id()) == m_selectedInstance)
+		{
+			return;
+		}
+		selectionBad();
+	});
 
 	m_statusLeft = new QLabel(tr("No instance selected"), this);
 	m_statusRight = new ServerStatus(this);
 	statusBar()->addPermanentWidget(m_statusLeft, 1);
 	statusBar()->addPermanentWidget(m_statusRight, 0);
 
+	// deleted folders go away in the background, show how far along that is
+	connect(ENV.trash().get(), &TrashBin::progress, this, [this](qint64 deleted, qint64 total)
+	{
+		statusBar()->showMessage(tr("Deleting files: %1 of %2").arg(deleted).arg(total));
+	});
+	connect(ENV.trash().get(), &TrashBin::emptied, this, [this]()
+	{
+		statusBar()->clearMessage();
+	});
+
 	// Add "manage accounts" button, right align
 	QWidget *spacer = new QWidget();
 	spacer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -1062,9 +1082,15 @@ InstancePtr MainWindow::instanceFromZipPack(QString instName, QString instGroup,
 	QTemporaryDir extractTmpDir;
 	QDir extractDir(extractTmpDir.path());
 	qDebug() << "Attempting to create instance from" << archivePath;
-	if (MMCZip::extractDir(archivePath, extractDir.absolutePath()).isEmpty())
+	ZipExtractTask extractTask(archivePath, extractDir.absolutePath());
+	ProgressDialog extractDialog(this);
+	extractDialog.setSkipButton(true, tr("Abort"));
+	if (extractDialog.execWithTask(&extractTask) != QDialog::Accepted)
 	{
-		CustomMessageBox::selectable(this, tr("Error"), tr("Failed to extract modpack"), QMessageBox::Warning)->show();
+		if (!extractTask.successful() && extractTask.isFinished())
+		{
+			CustomMessageBox::selectable(this, tr("Error"), tr("Failed to extract modpack:\n%1").arg(extractTask.failReason()), QMessageBox::Warning)->show();
+		}
 		return nullptr;
 	}
 	const QFileInfo instanceCfgFile = findRecursive(extractDir.absolutePath(), "instance.cfg");
@@ -1263,10 +1289,20 @@ void MainWindow::on_actionCopyInstance_triggered()
 	QString instancesDir = MMC->settings()->get("InstanceDir").toString();
 	QString instDirName = FS::DirNameFromString(copyInstDlg.instName(), instancesDir);
 	QString instDir = FS::PathCombine(instancesDir, instDirName);
-	bool copySaves = copyInstDlg.shouldCopySaves();
+
+	InstanceCopyTask copyTask(m_selectedInstance, instDir, copyInstDlg.shouldCopySaves(), copyInstDlg.shouldLinkFiles());
+	ProgressDialog copyDialog(this);
+	if (copyDialog.execWithTask(&copyTask) != QDialog::Accepted)
+	{
+		if (!copyTask.successful() && copyTask.isFinished())
+		{
+			CustomMessageBox::selectable(this, tr("Error"), tr("Failed to create instance %1: %2").arg(instDirName, copyTask.failReason()), QMessageBox::Warning)->show();
+		}
+		return;
+	}
 
 	InstancePtr newInstance;
-	auto error = MMC->instances()->copyInstance(newInstance, m_selectedInstance, instDir, copySaves);
+	auto error = MMC->instances()->copyInstance(newInstance, m_selectedInstance, instDir);
 
 	QString errorMsg = tr("Failed to create instance %1: ").arg(instDirName);
 	switch (error)
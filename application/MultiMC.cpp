@@ -8,6 +8,7 @@
 #include "pages/global/ExternalToolsPage.h"
 #include "pages/global/AccountListPage.h"
 #include "pages/global/PasteEEPage.h"
+#include "pages/global/DiskUsagePage.h"
 
 #include <iostream>
 #include <QDir>
@@ -50,6 +51,7 @@
 
 #include <Commandline.h>
 #include <FileSystem.h>
+#include <TrashBin.h>
 #include <DesktopServices.h>
 
 #if defined Q_OS_WIN32
@@ -267,6 +269,9 @@ MultiMC::MultiMC(int &argc, char **argv, bool test_mode) : QApplication(argc, ar
 	// init the http meta cache
 	ENV.initHttpMetaCache();
 
+	// finish deleting whatever was left over last time
+	ENV.trash()->setRegistry(FS::PathCombine(QDir::currentPath(), "trash.lst"));
+
 	// create the global network manager
 	ENV.m_qnam.reset(new QNetworkAccessManager(this));
 
@@ -482,6 +487,8 @@ void MultiMC::initGlobalSettings(bool test_mode)
 	m_settings->registerSetting("ConsoleFontSize", defaultSize);
 	m_settings->registerSetting("ConsoleMaxLines", 100000);
 	m_settings->registerSetting("ConsoleOverflowStop", true);
+	m_settings->registerSetting("ConsoleSpillToDisk", false);
+	m_settings->registerSetting("ConsoleMaxLinesPerSecond", 0);
 
 	FTBPlugin::initialize(m_settings);
 
@@ -537,9 +544,18 @@ void MultiMC::initGlobalSettings(bool test_mode)
 	// Minecraft launch method
 	m_settings->registerSetting("MCLaunchMethod", "LauncherPart");
 
+	// Start the launcher part JVM while the instance is being updated
+	m_settings->registerSetting("PrewarmJVM", false);
+
+	// Extract natives into a cache shared by all instances
+	m_settings->registerSetting("SharedNatives", false);
+
 	// Wrapper command for launch
 	m_settings->registerSetting("WrapperCommand", "");
 
+	// zlib level for instance exports, 0 stores everything
+	m_settings->registerSetting("ExportCompressionLevel", 6);
+
 	// Custom Commands
 	m_settings->registerSetting({"PreLaunchCommand", "PreLaunchCmd"}, "");
 	m_settings->registerSetting({"PostExitCommand", "PostExitCmd"}, "");
@@ -577,6 +593,7 @@ void MultiMC::initGlobalSettings(bool test_mode)
 		m_globalSettingsProvider->addPage<ExternalToolsPage>();
 		m_globalSettingsProvider->addPage<AccountListPage>();
 		m_globalSettingsProvider->addPage<PasteEEPage>();
+		m_globalSettingsProvider->addPage<DiskUsagePage>();
 	}
 }
 
@@ -16,7 +16,7 @@
 #include "ExportInstanceDialog.h"
 #include "ui_ExportInstanceDialog.h"
 #include <BaseInstance.h>
-#include <MMCZip.h>
+#include <ZipCompressTask.h>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <qfilesystemmodel.h>
@@ -30,6 +30,7 @@
 #include "MultiMC.h"
 #include <icons/IconList.h>
 #include <FileSystem.h>
+#include "ProgressDialog.h"
 
 class PackIgnoreProxy : public QSortFilterProxyModel
 {
@@ -328,6 +329,8 @@ ExportInstanceDialog::ExportInstanceDialog(InstancePtr instance, QWidget *parent
 	auto headerView = ui->treeView->header();
 	headerView->setSectionResizeMode(QHeaderView::ResizeToContents);
 	headerView->setSectionResizeMode(0, QHeaderView::Stretch);
+
+	ui->compressionLevelSpinBox->setValue(MMC->settings()->get("ExportCompressionLevel").toInt());
 }
 
 ExportInstanceDialog::~ExportInstanceDialog()
@@ -405,9 +408,15 @@ bool ExportInstanceDialog::doExport()
 
 	SaveIcon(m_instance);
 
-	if (!MMCZip::compressDir(output, m_instance->instanceRoot(), name, &proxyModel->blockedPaths()))
+	MMC->settings()->set("ExportCompressionLevel", ui->compressionLevelSpinBox->value());
+	ZipCompressTask task(output, m_instance->instanceRoot(), name, proxyModel->blockedPaths());
+	task.setCompressionLevel(ui->compressionLevelSpinBox->value());
+	ProgressDialog progress(this);
+	progress.setSkipButton(true, tr("Abort"));
+	progress.execWithTask(&task);
+	if (!task.successful())
 	{
-		QMessageBox::warning(this, tr("Error"), tr("Unable to export instance"));
+		QMessageBox::warning(this, tr("Error"), tr("Unable to export instance:\n%1").arg(task.failReason()));
 		return false;
 	}
 	return true;
@@ -456,15 +465,17 @@ QString ExportInstanceDialog::ignoreFileName()
 
 void ExportInstanceDialog::loadPackIgnore()
 {
+	// caches and records MultiMC keeps for itself, they have no place in a pack
+	QStringList paths = {"modcache", "natives", "launch_history.log"};
 	auto filename = ignoreFileName();
 	QFile ignoreFile(filename);
-	if(!ignoreFile.open(QIODevice::ReadOnly))
+	if(ignoreFile.open(QIODevice::ReadOnly))
 	{
-		return;
+		auto data = ignoreFile.readAll();
+		auto string = QString::fromUtf8(data);
+		paths += string.split('\n', QString::SkipEmptyParts);
 	}
-	auto data = ignoreFile.readAll();
-	auto string = QString::fromUtf8(data);
-	proxyModel->setBlockedPaths(string.split('\n', QString::SkipEmptyParts));
+	proxyModel->setBlockedPaths(paths);
 }
 
 void ExportInstanceDialog::savePackIgnore()
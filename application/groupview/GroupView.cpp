@@ -50,11 +50,111 @@ void GroupView::setModel(QAbstractItemModel *model)
 void GroupView::dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
 							const QVector<int> &roles)
 {
-	scheduleDelayedItemsLayout();
+	// most changes, like the running state or the disk usage, only need the items drawn again
+	QRegion changed;
+	for (int i = topLeft.row(); i <= bottomRight.row(); ++i)
+	{
+		auto index = model()->index(i, 0);
+		auto group = category(index);
+		if (!group)
+		{
+			// a new group has to find its place among the others
+			scheduleDelayedItemsLayout();
+			return;
+		}
+		auto current = visualCategory(index);
+		if (current != group)
+		{
+			markDirty(current);
+			markDirty(group);
+			continue;
+		}
+		auto &row = group->rows[group->positionOf(index).second];
+		int height = 0;
+		for (auto &item : row.items)
+		{
+			height = qMax(height, itemDelegate()->sizeHint(viewOptions(), item).height());
+		}
+		if (height != row.height)
+		{
+			markDirty(group);
+			continue;
+		}
+		changed += visualRect(index);
+	}
+	viewport()->update(changed);
 }
+
 void GroupView::rowsInserted(const QModelIndex &parent, int start, int end)
 {
-	scheduleDelayedItemsLayout();
+	QAbstractItemView::rowsInserted(parent, start, end);
+	for (int i = start; i <= end; ++i)
+	{
+		auto group = category(model()->index(i, 0));
+		if (!group)
+		{
+			scheduleDelayedItemsLayout();
+			return;
+		}
+		markDirty(group);
+	}
+}
+
+void GroupView::markDirty(VisualGroup *group)
+{
+	if (!group)
+	{
+		return;
+	}
+	m_dirtyGroups.insert(group->text);
+	if (!m_dirtyGroupsQueued)
+	{
+		// the model may well have more changes coming, do it once they are in
+		m_dirtyGroupsQueued = true;
+		QMetaObject::invokeMethod(this, "updateDirtyGroups", Qt::QueuedConnection);
+	}
+}
+
+void GroupView::updateDirtyGroups()
+{
+	m_dirtyGroupsQueued = false;
+	if (m_dirtyGroups.isEmpty())
+	{
+		return;
+	}
+	if (!layoutDirtyGroups())
+	{
+		updateGeometries();
+		return;
+	}
+	viewport()->update();
+}
+
+bool GroupView::layoutDirtyGroups()
+{
+	if (m_dirtyGroups.isEmpty())
+	{
+		return true;
+	}
+	geometryCache.clear();
+	bool emptied = false;
+	for (auto group : m_groups)
+	{
+		if (!m_dirtyGroups.contains(group->text))
+		{
+			continue;
+		}
+		group->update();
+		emptied |= group->rows.first().items.isEmpty();
+	}
+	m_dirtyGroups.clear();
+	if (emptied)
+	{
+		// the last item moved out, the group has to go
+		return false;
+	}
+	positionGroups();
+	return true;
 }
 
 void GroupView::rowsAboutToBeRemoved(const QModelIndex &parent, int start, int end)
@@ -81,7 +181,6 @@ inline bool operator<(const LocaleString &lhs, const LocaleString &rhs)
 void GroupView::updateGeometries()
 {
 	geometryCache.clear();
-	int previousScroll = verticalScrollBar()->value();
 
 	QMap<LocaleString, VisualGroup *> cats;
 
@@ -110,12 +209,20 @@ void GroupView::updateGeometries()
 
 	qDeleteAll(m_groups);
 	m_groups = cats.values();
+	m_dirtyGroups.clear();
 
 	for (auto cat : m_groups)
 	{
 		cat->update();
 	}
 
+	positionGroups();
+	viewport()->update();
+}
+
+void GroupView::positionGroups()
+{
+	int previousScroll = verticalScrollBar()->value();
 	if (m_groups.isEmpty())
 	{
 		verticalScrollBar()->setRange(0, 0);
@@ -148,8 +255,6 @@ void GroupView::updateGeometries()
 	}
 
 	verticalScrollBar()->setValue(qMin(previousScroll, verticalScrollBar()->maximum()));
-
-	viewport()->update();
 }
 
 void GroupView::modelReset()
@@ -188,6 +293,21 @@ VisualGroup *GroupView::category(const QString &cat) const
 	return nullptr;
 }
 
+VisualGroup *GroupView::visualCategory(const QModelIndex &index) const
+{
+	for (auto group : m_groups)
+	{
+		for (auto &row : group->rows)
+		{
+			if (row.items.contains(index))
+			{
+				return group;
+			}
+		}
+	}
+	return nullptr;
+}
+
 VisualGroup *GroupView::categoryAt(const QPoint &pos, VisualGroup::HitResults & result) const
 {
 	for (auto group : m_groups)
@@ -406,6 +526,10 @@ void GroupView::mouseDoubleClickEvent(QMouseEvent *event)
 void GroupView::paintEvent(QPaintEvent *event)
 {
 	executeDelayedItemsLayout();
+	if (!layoutDirtyGroups())
+	{
+		updateGeometries();
+	}
 
 	QPainter painter(this->viewport());
 
@@ -4,6 +4,7 @@
 #include <QLineEdit>
 #include <QScrollBar>
 #include <QCache>
+#include <QSet>
 #include "VisualGroup.h"
 
 struct GroupViewRoles
@@ -61,6 +62,9 @@ protected slots:
 	virtual void rowsAboutToBeRemoved(const QModelIndex &parent, int start, int end) override;
 	void modelReset();
 
+private slots:
+	void updateDirtyGroups();
+
 protected:
 	virtual bool isIndexHidden(const QModelIndex &index) const override;
 	void mousePressEvent(QMouseEvent *event) override;
@@ -91,6 +95,9 @@ private:
 	int m_currentItemsPerRow = -1;
 	int m_currentCursorColumn= -1;
 	mutable QCache<int, QRect> geometryCache;
+	// groups whose items changed, laid out again on their own instead of everything
+	QSet<QString> m_dirtyGroups;
+	bool m_dirtyGroupsQueued = false;
 
 	// point where the currently active mouse action started in geometry coordinates
 	QPoint m_pressedPosition;
@@ -103,6 +110,8 @@ private:
 	VisualGroup *category(const QModelIndex &index) const;
 	VisualGroup *category(const QString &cat) const;
 	VisualGroup *categoryAt(const QPoint &pos, VisualGroup::HitResults & result) const;
+	/// the group the item is laid out in, which is not the one it belongs to after it moved
+	VisualGroup *visualCategory(const QModelIndex &index) const;
 
 	int itemsPerRow() const
 	{
@@ -124,4 +133,10 @@ private: /* methods */
 	QPair<VisualGroup *, int> rowDropPos(const QPoint &pos);
 
 	QPoint offset() const;
+
+	void markDirty(VisualGroup *group);
+	/// lay out the groups in m_dirtyGroups again, returns false if that needs a full layout
+	bool layoutDirtyGroups();
+	/// stack the groups on top of each other and size the scroll bar to fit
+	void positionGroups();
 };
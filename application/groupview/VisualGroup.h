@@ -4,6 +4,7 @@
 #include <QRect>
 #include <QVector>
 #include <QStyleOption>
+#include <QPersistentModelIndex>
 
 class GroupView;
 class QPainter;
@@ -11,14 +12,15 @@ class QModelIndex;
 
 struct VisualRow
 {
-	QList<QModelIndex> items;
+	// persistent, so the rows stay right while other groups get items added
+	QList<QPersistentModelIndex> items;
 	int height = 0;
 	int top = 0;
 	inline int size() const
 	{
 		return items.size();
 	}
-	inline QModelIndex &operator[](int i)
+	inline QPersistentModelIndex &operator[](int i)
 	{
 		return items[i];
 	}
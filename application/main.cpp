@@ -3,6 +3,7 @@
 #include "LaunchController.h"
 #include <InstanceList.h>
 #include <QDebug>
+#include <QEventLoop>
 
 int launchMainWindow(MultiMC &app)
 {
@@ -28,12 +29,30 @@ int launchInstance(MultiMC &app, InstancePtr inst)
 int main_gui(MultiMC &app)
 {
 	app.setIconTheme(MMC->settings()->get("IconTheme").toString());
-	// show main window
-	auto inst = app.instances()->getInstanceById(app.launchId);
-	if(inst)
+	if(!app.launchId.isEmpty())
 	{
-		return launchInstance(app, inst);
+		auto instances = app.instances();
+		if(instances->isLoading())
+		{
+			// the list fills in the background, the instance may not be in it yet
+			QEventLoop loop;
+			QObject::connect(instances.get(), &InstanceList::dataIsInvalid, &loop, [&]()
+			{
+				if(!instances->isLoading())
+				{
+					loop.quit();
+				}
+			});
+			loop.exec();
+		}
+		auto inst = instances->getInstanceById(app.launchId);
+		if(inst)
+		{
+			return launchInstance(app, inst);
+		}
+		qWarning() << "Instance to launch" << app.launchId << "doesn't exist";
 	}
+	// show main window
 	return launchMainWindow(app);
 }
 
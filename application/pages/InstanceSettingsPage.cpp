@@ -47,11 +47,27 @@ void InstanceSettingsPage::applySettings()
 	{
 		m_settings->set("ShowConsole", ui->showConsoleCheck->isChecked());
 		m_settings->set("AutoCloseConsole", ui->autoCloseConsoleCheck->isChecked());
+		m_settings->set("ConsoleMaxLinesPerSecond", ui->rateLimitSpinBox->value());
 	}
 	else
 	{
 		m_settings->reset("ShowConsole");
 		m_settings->reset("AutoCloseConsole");
+		m_settings->reset("ConsoleMaxLinesPerSecond");
+	}
+
+	// Launch
+	bool launch = ui->launchGroupBox->isChecked();
+	m_settings->set("OverrideLaunch", launch);
+	if (launch)
+	{
+		m_settings->set("PrewarmJVM", ui->prewarmJVMCheckBox->isChecked());
+		m_settings->set("SharedNatives", ui->sharedNativesCheckBox->isChecked());
+	}
+	else
+	{
+		m_settings->reset("PrewarmJVM");
+		m_settings->reset("SharedNatives");
 	}
 
 	// Window Size
@@ -137,6 +153,12 @@ void InstanceSettingsPage::loadSettings()
 	ui->consoleSettingsBox->setChecked(m_settings->get("OverrideConsole").toBool());
 	ui->showConsoleCheck->setChecked(m_settings->get("ShowConsole").toBool());
 	ui->autoCloseConsoleCheck->setChecked(m_settings->get("AutoCloseConsole").toBool());
+	ui->rateLimitSpinBox->setValue(m_settings->get("ConsoleMaxLinesPerSecond").toInt());
+
+	// Launch
+	ui->launchGroupBox->setChecked(m_settings->get("OverrideLaunch").toBool());
+	ui->prewarmJVMCheckBox->setChecked(m_settings->get("PrewarmJVM").toBool());
+	ui->sharedNativesCheckBox->setChecked(m_settings->get("SharedNatives").toBool());
 
 	// Window Size
 	ui->windowSizeGroupBox->setChecked(m_settings->get("OverrideWindow").toBool());
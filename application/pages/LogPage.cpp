@@ -4,14 +4,19 @@
 #include "MultiMC.h"
 
 #include <QIcon>
+#include <QMessageBox>
 #include <QScrollBar>
 #include <QShortcut>
 
 #include "launch/LaunchTask.h"
+#include "launch/LogSearch.h"
+#include "launch/LogSpillModel.h"
 #include <settings/Setting.h>
 #include "GuiUtil.h"
 #include <ColorCache.h>
 
+const qint64 maxTextSize = 50ll * 1024ll * 1024ll;
+
 class LogFormatProxyModel : public QIdentityProxyModel
 {
 public:
@@ -49,60 +54,6 @@ public:
 		m_colors.reset(colors);
 	}
 
-	QModelIndex find(const QModelIndex &start, const QString &value, bool reverse) const
-	{
-		QModelIndex parentIndex = parent(start);
-		auto compare = [&](int r) -> QModelIndex
-		{
-			QModelIndex idx = index(r, start.column(), parentIndex);
-			if (!idx.isValid() || idx == start)
-			{
-				return QModelIndex();
-			}
-			QVariant v = data(idx, Qt::DisplayRole);
-			QString t = v.toString();
-			if (t.contains(value, Qt::CaseInsensitive))
-				return idx;
-			return QModelIndex();
-		};
-		if(reverse)
-		{
-			int from = start.row();
-			int to = 0;
-
-			for (int i = 0; i < 2; ++i)
-			{
-				for (int r = from; (r >= to); --r)
-				{
-					auto idx = compare(r);
-					if(idx.isValid())
-						return idx;
-				}
-				// prepare for the next iteration
-				from = rowCount() - 1;
-				to = start.row();
-			}
-		}
-		else
-		{
-			int from = start.row();
-			int to = rowCount(parentIndex);
-
-			for (int i = 0; i < 2; ++i)
-			{
-				for (int r = from; (r < to); ++r)
-				{
-					auto idx = compare(r);
-					if(idx.isValid())
-						return idx;
-				}
-				// prepare for the next iteration
-				from = 0;
-				to = start.row();
-			}
-		}
-		return QModelIndex();
-	}
 private:
 	QFont m_font;
 	std::unique_ptr<LogColorCache> m_colors;
@@ -115,14 +66,16 @@ LogPage::LogPage(InstancePtr instance, QWidget *parent)
 	ui->tabWidget->tabBar()->hide();
 
 	m_proxy = new LogFormatProxyModel(this);
-	// set up text colors in the log proxy and adapt them to the current theme foreground and background
+	m_spilledProxy = new LogFormatProxyModel(this);
+	// set up text colors in the log proxies and adapt them to the current theme foreground and background
 	{
 		auto origForeground = ui->text->palette().color(ui->text->foregroundRole());
 		auto origBackground = ui->text->palette().color(ui->text->backgroundRole());
 		m_proxy->setColors(new LogColorCache(origForeground, origBackground));
+		m_spilledProxy->setColors(new LogColorCache(origForeground, origBackground));
 	}
 
-	// set up fonts in the log proxy
+	// set up fonts in the log proxies
 	{
 		QString fontFamily = MMC->settings()->get("ConsoleFont").toString();
 		bool conversionOk = false;
@@ -132,10 +85,19 @@ LogPage::LogPage(InstancePtr instance, QWidget *parent)
 			fontSize = 11;
 		}
 		m_proxy->setFont(QFont(fontFamily, fontSize));
+		m_spilledProxy->setFont(QFont(fontFamily, fontSize));
 	}
 
 	ui->text->setModel(m_proxy);
 
+	m_spilled = new LogSpillModel(this);
+	m_spilledProxy->setSourceModel(m_spilled);
+	ui->spilledText->setModel(m_spilledProxy);
+
+	m_search = new LogSearch(this);
+	connect(m_search, &LogSearch::matchesFound, this, &LogPage::jumpToMatch);
+	connect(m_search, &LogSearch::finished, this, &LogPage::searchFinished);
+
 	// set up instance and launch process recognition
 	{
 		auto launchTask = m_instance->getLaunchTask();
@@ -147,6 +109,7 @@ LogPage::LogPage(InstancePtr instance, QWidget *parent)
 	}
 
 	ui->text->setWordWrap(true);
+	ui->spilledText->setWordWrap(true);
 
 	auto findShortcut = new QShortcut(QKeySequence(QKeySequence::Find), this);
 	connect(findShortcut, SIGNAL(activated()), SLOT(findActivated()));
@@ -178,14 +141,19 @@ void LogPage::on_InstanceLaunchTask_changed(std::shared_ptr<LaunchTask> proc)
 		}
 		m_model->setMaxLines(maxLines);
 		m_model->setStopOnOverflow(MMC->settings()->get("ConsoleOverflowStop").toBool());
+		m_model->setSpillToDisk(MMC->settings()->get("ConsoleSpillToDisk").toBool());
 		m_model->setOverflowMessage(tr("MultiMC stopped watching the game log because the log length surpassed %1 lines.\n"
 			"You may have to fix your mods because the game is still loggging to files and"
 			" likely wasting harddrive space at an alarming rate!").arg(maxLines));
 		m_proxy->setSourceModel(m_model.get());
+		m_spilled->setSourceModel(m_model.get());
+		m_search->setModel(m_model.get());
 	}
 	else
 	{
 		m_proxy->setSourceModel(nullptr);
+		m_spilled->setSourceModel(nullptr);
+		m_search->setModel(nullptr);
 		m_model.reset();
 	}
 }
@@ -207,7 +175,14 @@ void LogPage::on_btnPaste_clicked()
 
 	//FIXME: turn this into a proper task and move the upload logic out of GuiUtil!
 	m_model->append(MessageLevel::MultiMC, tr("MultiMC: Log upload triggered at: %1").arg(QDateTime::currentDateTime().toString(Qt::RFC2822Date)));
-	auto url = GuiUtil::uploadPaste(m_model->toPlainText(), this);
+	QString text;
+	if(!m_model->toPlainText(text, maxTextSize))
+	{
+		QMessageBox::warning(this, tr("Too big"), tr("The log is too big to upload. Try again after clearing it, or upload the "
+			"log file from the Other logs page."));
+		return;
+	}
+	auto url = GuiUtil::uploadPaste(text, this);
 	if(!url.isEmpty())
 	{
 		m_model->append(MessageLevel::MultiMC, tr("MultiMC: Log uploaded to: %1").arg(url));
@@ -223,7 +198,14 @@ void LogPage::on_btnCopy_clicked()
 	if(!m_model)
 		return;
 	m_model->append(MessageLevel::MultiMC, QString("Clipboard copy at: %1").arg(QDateTime::currentDateTime().toString(Qt::RFC2822Date)));
-	GuiUtil::setClipboardText(m_model->toPlainText());
+	QString text;
+	if(!m_model->toPlainText(text, maxTextSize))
+	{
+		QMessageBox::warning(this, tr("Too big"), tr("The log is too big to copy as a whole. "
+			"You can still select and copy parts of it."));
+		return;
+	}
+	GuiUtil::setClipboardText(text);
 }
 
 void LogPage::on_btnClear_clicked()
@@ -235,9 +217,15 @@ void LogPage::on_btnClear_clicked()
 
 void LogPage::on_btnBottom_clicked()
 {
+	ui->logStack->setCurrentWidget(ui->livePage);
 	ui->text->scrollToBottom();
 }
 
+void LogPage::on_btnLiveLog_clicked()
+{
+	ui->logStack->setCurrentWidget(ui->livePage);
+}
+
 void LogPage::on_trackLogCheckbox_clicked(bool checked)
 {
 	m_write_active = checked;
@@ -246,23 +234,124 @@ void LogPage::on_trackLogCheckbox_clicked(bool checked)
 void LogPage::on_wrapCheckbox_clicked(bool checked)
 {
 	ui->text->setWordWrap(checked);
+	ui->spilledText->setWordWrap(checked);
 }
 
 void LogPage::on_findButton_clicked()
 {
 	auto modifiers = QApplication::keyboardModifiers();
 	bool reverse = modifiers & Qt::ShiftModifier;
-	ui->text->findNext(ui->searchBar->text(), reverse);
+	findNext(reverse);
 }
 
 void LogPage::findNextActivated()
 {
-	ui->text->findNext(ui->searchBar->text(), false);
+	findNext(false);
 }
 
 void LogPage::findPreviousActivated()
 {
-	ui->text->findNext(ui->searchBar->text(), true);
+	findNext(true);
+}
+
+void LogPage::findNext(bool reverse)
+{
+	if(!m_model)
+	{
+		return;
+	}
+	LogSearch::Query query;
+	query.pattern = ui->searchBar->text();
+	query.regex = ui->regexCheckbox->isChecked();
+	// the same order as in levelCombo
+	switch(ui->levelCombo->currentIndex())
+	{
+		case 1:
+			query.levels = {MessageLevel::Warning, MessageLevel::Error, MessageLevel::Fatal};
+			break;
+		case 2:
+			query.levels = {MessageLevel::Error, MessageLevel::Fatal};
+			break;
+		case 3:
+			query.levels = {MessageLevel::MultiMC};
+			break;
+		default:
+			break;
+	}
+	if(query.pattern.isEmpty())
+	{
+		return;
+	}
+	m_findReverse = reverse;
+	m_findPending = true;
+	if(!m_search->isActive() || m_search->query() != query)
+	{
+		// the results come in from a worker thread, jumpToMatch is called again as they do
+		m_search->start(query);
+		ui->searchBar->setToolTip(m_search->errorString());
+	}
+	jumpToMatch();
+}
+
+void LogPage::jumpToMatch()
+{
+	if(!m_findPending || !m_model)
+	{
+		return;
+	}
+	qint64 firstLine = m_model->firstLineNumber();
+	// lines before this were dropped before they could be spilled
+	qint64 firstKept = m_spilled->firstLineNumber();
+	bool showingSpilled = ui->logStack->currentWidget() == ui->spilledPage;
+	int row, column;
+	(showingSpilled ? ui->spilledText : ui->text)->selectionStart(row, column);
+	qint64 line = (showingSpilled ? firstKept : firstLine) + row;
+	auto & matches = m_search->matches();
+	auto isBefore = [&](int index)
+	{
+		auto & match = matches[index];
+		return match.line < line || (match.line == line && match.start <= column);
+	};
+
+	int index = m_findReverse ? m_search->previousMatch(line, column) : m_search->nextMatch(line, column);
+	if(index == -1)
+	{
+		return;
+	}
+	// while the search is running, more matches can still show up before wrapping around
+	if(m_search->isRunning() && (m_findReverse ? !isBefore(index) : isBefore(index)))
+	{
+		return;
+	}
+	// matches in lines that are gone can't be shown, go around them
+	if(matches[index].line < firstKept)
+	{
+		index = m_findReverse ? m_search->previousMatch(firstLine + m_model->rowCount(), 0) : m_search->nextMatch(firstKept, -1);
+		if(matches[index].line < firstKept)
+		{
+			return;
+		}
+	}
+	auto & match = matches[index];
+	if(match.line < firstLine)
+	{
+		// only on disk now, show it from there
+		ui->logStack->setCurrentWidget(ui->spilledPage);
+		ui->spilledText->selectRange(match.line - firstKept, match.start, match.length);
+	}
+	else
+	{
+		ui->logStack->setCurrentWidget(ui->livePage);
+		ui->text->selectRange(match.line - firstLine, match.start, match.length);
+	}
+	m_findPending = false;
+}
+
+void LogPage::searchFinished()
+{
+	jumpToMatch();
+	// nothing to go to
+	m_findPending = false;
 }
 
 void LogPage::findActivated()
@@ -28,6 +28,8 @@ class LogPage;
 }
 class QTextCharFormat;
 class LogFormatProxyModel;
+class LogSearch;
+class LogSpillModel;
 
 class LogPage : public QWidget, public BasePage
 {
@@ -61,6 +63,7 @@ private slots:
 	void on_btnCopy_clicked();
 	void on_btnClear_clicked();
 	void on_btnBottom_clicked();
+	void on_btnLiveLog_clicked();
 
 	void on_trackLogCheckbox_clicked(bool checked);
 	void on_wrapCheckbox_clicked(bool checked);
@@ -71,6 +74,11 @@ private slots:
 	void findPreviousActivated();
 
 	void on_InstanceLaunchTask_changed(std::shared_ptr<LaunchTask> proc);
+	void jumpToMatch();
+	void searchFinished();
+
+private:
+	void findNext(bool reverse);
 
 private:
 	Ui::LogPage *ui;
@@ -85,5 +93,12 @@ private:
 
 	BasePageContainer * m_parentContainer;
 	LogFormatProxyModel * m_proxy;
+	// lines spilled to disk, shown instead of the live log to go to matches in them
+	LogSpillModel * m_spilled;
+	LogFormatProxyModel * m_spilledProxy;
 	shared_qobject_ptr <LogModel> m_model;
+	LogSearch * m_search;
+	// a find was requested, but there were no results to go to yet
+	bool m_findPending = false;
+	bool m_findReverse = false;
 };
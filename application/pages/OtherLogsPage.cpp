@@ -20,15 +20,24 @@
 
 #include "GuiUtil.h"
 #include "RecursiveFileSystemWatcher.h"
-#include <GZip.h>
+#include <LogFileModel.h>
 #include <FileSystem.h>
 
+namespace
+{
+// larger files can still be viewed, but not copied or uploaded as a whole
+const qint64 maxTextSize = 50ll * 1024ll * 1024ll;
+}
+
 OtherLogsPage::OtherLogsPage(QString path, IPathMatcher::Ptr fileFilter, QWidget *parent)
 	: QWidget(parent), ui(new Ui::OtherLogsPage), m_path(path), m_fileFilter(fileFilter),
-	  m_watcher(new RecursiveFileSystemWatcher(this))
+	  m_watcher(new RecursiveFileSystemWatcher(this)), m_model(new LogFileModel(this))
 {
 	ui->setupUi(this);
 	ui->tabWidget->tabBar()->hide();
+	ui->text->setWordWrap(true);
+	ui->text->setModel(m_model);
+	connect(m_model, &LogFileModel::loaded, this, &OtherLogsPage::fileLoaded);
 
 	m_watcher->setMatcher(fileFilter);
 	m_watcher->setRootDir(QDir::current().absoluteFilePath(m_path));
@@ -86,7 +95,7 @@ void OtherLogsPage::on_selectLogBox_currentIndexChanged(const int index)
 	if (file.isEmpty() || !QFile::exists(FS::PathCombine(m_path, file)))
 	{
 		m_currentFile = QString();
-		ui->text->clear();
+		m_model->close();
 		setControlsEnabled(false);
 	}
 	else
@@ -115,50 +124,45 @@ void OtherLogsPage::on_btnReload_clicked()
 	}
 	else
 	{
-		auto showTooBig = [&]()
-		{
-			ui->text->setPlainText(
-				tr("The file (%1) is too big. You may want to open it in a viewer optimized "
-				   "for large files.").arg(file.fileName()));
-		};
-		if(file.size() > (1024ll * 1024ll * 12ll))
-		{
-			showTooBig();
-			return;
-		}
-		QString content;
-		if(file.fileName().endsWith(".gz"))
-		{
-			QByteArray temp;
-			if(!GZip::unzip(file.readAll(), temp))
-			{
-				ui->text->setPlainText(
-					tr("The file (%1) is not readable.").arg(file.fileName()));
-				return;
-			}
-			content = QString::fromUtf8(temp);
-		}
-		else
-		{
-			content = QString::fromUtf8(file.readAll());
-		}
-		if (content.size() >= 50000000ll)
-		{
-			showTooBig();
-			return;
-		}
-		ui->text->setPlainText(content);
+		// only the index is built here, the lines are read as they are shown
+		file.close();
+		m_model->open(file.fileName());
 	}
 }
 
+void OtherLogsPage::fileLoaded(bool success)
+{
+	if(!success)
+	{
+		QMessageBox::critical(this, tr("Error"), tr("The file (%1) is not readable: %2")
+													 .arg(m_currentFile, m_model->errorString()));
+		return;
+	}
+	ui->text->scrollToBottom();
+}
+
 void OtherLogsPage::on_btnPaste_clicked()
 {
-	GuiUtil::uploadPaste(ui->text->toPlainText(), this);
+	QString text;
+	if(!m_model->toPlainText(text, maxTextSize))
+	{
+		QMessageBox::warning(this, tr("Too big"), tr("The file (%1) is too big to upload. You may want to open it in a viewer optimized "
+			"for large files.").arg(m_currentFile));
+		return;
+	}
+	GuiUtil::uploadPaste(text, this);
 }
 
 void OtherLogsPage::on_btnCopy_clicked()
 {
-	GuiUtil::setClipboardText(ui->text->toPlainText());
+	QString text;
+	if(!m_model->toPlainText(text, maxTextSize))
+	{
+		QMessageBox::warning(this, tr("Too big"), tr("The file (%1) is too big to copy as a whole. "
+			"You can still select and copy parts of it.").arg(m_currentFile));
+		return;
+	}
+	GuiUtil::setClipboardText(text);
 }
 
 void OtherLogsPage::on_btnDelete_clicked()
@@ -174,6 +178,8 @@ void OtherLogsPage::on_btnDelete_clicked()
 	{
 		return;
 	}
+	// the file is mapped while it's shown, let go of it first
+	m_model->close();
 	QFile file(FS::PathCombine(m_path, m_currentFile));
 	if (!file.remove())
 	{
@@ -212,6 +218,7 @@ void OtherLogsPage::on_btnClean_clicked()
 	{
 		return;
 	}
+	m_model->close();
 	QStringList failed;
 	for(auto item: toDelete)
 	{
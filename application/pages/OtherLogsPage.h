@@ -27,6 +27,7 @@ class OtherLogsPage;
 }
 
 class RecursiveFileSystemWatcher;
+class LogFileModel;
 
 class OtherLogsPage : public QWidget, public BasePage
 {
@@ -63,6 +64,7 @@ private slots:
 	void on_btnCopy_clicked();
 	void on_btnDelete_clicked();
 	void on_btnClean_clicked();
+	void fileLoaded(bool success);
 
 private:
 	void setControlsEnabled(const bool enabled);
@@ -73,4 +75,5 @@ private:
 	QString m_currentFile;
 	IPathMatcher::Ptr m_fileFilter;
 	RecursiveFileSystemWatcher *m_watcher;
+	LogFileModel *m_model;
 };
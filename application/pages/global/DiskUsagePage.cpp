@@ -0,0 +1,321 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DiskUsagePage.h"
+#include "ui_DiskUsagePage.h"
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <QHeaderView>
+#include <QMessageBox>
+
+#include <InstanceList.h>
+#include <FileSystem.h>
+#include <icons/IconList.h>
+#include <minecraft/ModStore.h>
+
+#include "dialogs/ProgressDialog.h"
+
+static QString formatSize(qint64 bytes)
+{
+	const char *units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+	double size = bytes;
+	int unit = 0;
+	while (size >= 1024.0 && unit < 4)
+	{
+		size /= 1024.0;
+		unit++;
+	}
+	return QString("%1 %2").arg(size, 0, 'f', unit ? 1 : 0).arg(units[unit]);
+}
+
+/// The instance list as a table of sizes, one column for the whole instance and one for each part
+class DiskUsageModel : public QAbstractTableModel
+{
+	Q_OBJECT
+public:
+	enum Column
+	{
+		NameColumn,
+		TotalColumn,
+		WorldsColumn,
+		ModsColumn,
+		LogsColumn,
+		ScreenshotsColumn,
+		NativesColumn,
+		ColumnCount
+	};
+
+	DiskUsageModel(std::shared_ptr<InstanceList> instances, QObject *parent)
+		: QAbstractTableModel(parent), m_instances(instances)
+	{
+		auto list = m_instances.get();
+		connect(list, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &tl, const QModelIndex &br)
+		{
+			emit dataChanged(index(tl.row(), 0), index(br.row(), ColumnCount - 1));
+		});
+		connect(list, &QAbstractItemModel::rowsAboutToBeInserted, this, [this](const QModelIndex &, int first, int last)
+		{
+			beginInsertRows(QModelIndex(), first, last);
+		});
+		connect(list, &QAbstractItemModel::rowsInserted, this, &DiskUsageModel::endInsertRows);
+		connect(list, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &, int first, int last)
+		{
+			beginRemoveRows(QModelIndex(), first, last);
+		});
+		connect(list, &QAbstractItemModel::rowsRemoved, this, &DiskUsageModel::endRemoveRows);
+		connect(list, &QAbstractItemModel::modelAboutToBeReset, this, &DiskUsageModel::beginResetModel);
+		connect(list, &QAbstractItemModel::modelReset, this, &DiskUsageModel::endResetModel);
+	}
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override
+	{
+		return parent.isValid() ? 0 : m_instances->rowCount();
+	}
+
+	int columnCount(const QModelIndex &parent = QModelIndex()) const override
+	{
+		return parent.isValid() ? 0 : ColumnCount;
+	}
+
+	QVariant headerData(int section, Qt::Orientation orientation, int role) const override
+	{
+		if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+		{
+			return QVariant();
+		}
+		switch (section)
+		{
+		case NameColumn:
+			return tr("Instance");
+		case TotalColumn:
+			return tr("Total");
+		case WorldsColumn:
+			return tr("Worlds");
+		case ModsColumn:
+			return tr("Mods");
+		case LogsColumn:
+			return tr("Logs");
+		case ScreenshotsColumn:
+			return tr("Screenshots");
+		case NativesColumn:
+			return tr("Natives");
+		default:
+			return QVariant();
+		}
+	}
+
+	QVariant data(const QModelIndex &index, int role) const override
+	{
+		if (!index.isValid())
+		{
+			return QVariant();
+		}
+		auto source = m_instances->index(index.row());
+		if (index.column() == NameColumn)
+		{
+			switch (role)
+			{
+			case Qt::DisplayRole:
+			case Qt::UserRole:
+				return source.data(Qt::DisplayRole);
+			case Qt::DecorationRole:
+				return MMC->icons()->getIcon(source.data(Qt::DecorationRole).toString());
+			case Qt::ToolTipRole:
+				return source.data(Qt::ToolTipRole);
+			default:
+				return QVariant();
+			}
+		}
+		QVariant bytes;
+		if (index.column() == TotalColumn)
+		{
+			bytes = source.data(InstanceList::DiskUsageRole);
+		}
+		else
+		{
+			auto parts = source.data(InstanceList::DiskUsagePartsRole);
+			if (parts.isValid())
+			{
+				bytes = parts.toMap().value(partName(index.column()), 0);
+			}
+		}
+		switch (role)
+		{
+		case Qt::DisplayRole:
+			return bytes.isValid() ? formatSize(bytes.toLongLong()) : tr("...");
+		// sort by the real number
+		case Qt::UserRole:
+			return bytes.isValid() ? bytes.toLongLong() : -1;
+		case Qt::TextAlignmentRole:
+			return int(Qt::AlignRight | Qt::AlignVCenter);
+		default:
+			return QVariant();
+		}
+	}
+
+	/// sum of the total column
+	qint64 total() const
+	{
+		qint64 sum = 0;
+		for (int i = 0; i < m_instances->rowCount(); i++)
+		{
+			sum += m_instances->index(i).data(InstanceList::DiskUsageRole).toLongLong();
+		}
+		return sum;
+	}
+
+private:
+	static QString partName(int column)
+	{
+		switch (column)
+		{
+		case WorldsColumn:
+			return "worlds";
+		case ModsColumn:
+			return "mods";
+		case LogsColumn:
+			return "logs";
+		case ScreenshotsColumn:
+			return "screenshots";
+		case NativesColumn:
+			return "natives";
+		default:
+			return QString();
+		}
+	}
+
+private:
+	std::shared_ptr<InstanceList> m_instances;
+};
+
+DiskUsagePage::DiskUsagePage(QWidget *parent) :
+	QWidget(parent),
+	ui(new Ui::DiskUsagePage)
+{
+	ui->setupUi(this);
+	ui->tabWidget->tabBar()->hide();
+
+	m_model = new DiskUsageModel(MMC->instances(), this);
+	m_proxy = new QSortFilterProxyModel(this);
+	m_proxy->setSourceModel(m_model);
+	m_proxy->setSortRole(Qt::UserRole);
+	m_proxy->setSortCaseSensitivity(Qt::CaseInsensitive);
+	m_proxy->sort(DiskUsageModel::TotalColumn, Qt::DescendingOrder);
+	ui->usageView->setModel(m_proxy);
+	ui->usageView->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+	ui->usageView->header()->setSectionResizeMode(DiskUsageModel::NameColumn, QHeaderView::Stretch);
+	ui->usageView->header()->setStretchLastSection(false);
+
+	connect(m_model, &QAbstractItemModel::dataChanged, this, &DiskUsagePage::updateTotal);
+	connect(m_model, &QAbstractItemModel::rowsRemoved, this, &DiskUsagePage::updateTotal);
+	connect(m_model, &QAbstractItemModel::modelReset, this, &DiskUsagePage::updateTotal);
+	updateTotal();
+}
+
+DiskUsagePage::~DiskUsagePage()
+{
+	delete ui;
+}
+
+void DiskUsagePage::opened()
+{
+	MMC->instances()->updateDiskUsage();
+}
+
+void DiskUsagePage::on_refreshButton_clicked()
+{
+	MMC->instances()->updateDiskUsage();
+}
+
+void DiskUsagePage::on_findDuplicateModsButton_clicked()
+{
+	runModStore(false);
+}
+
+void DiskUsagePage::on_deduplicateModsButton_clicked()
+{
+	auto answer = QMessageBox::question(this, tr("Deduplicate mods"),
+		tr("Identical mod files in all instances will be replaced by links to one shared copy in the mod store.\n"
+		   "Replacing or removing a mod still only affects its own instance.\n\n"
+		   "Do you want to continue?"),
+		QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+	if (answer != QMessageBox::Yes)
+	{
+		return;
+	}
+	runModStore(true);
+	MMC->instances()->updateDiskUsage();
+}
+
+void DiskUsagePage::runModStore(bool deduplicate)
+{
+	QStringList folders;
+	int skipped = 0;
+	auto instances = MMC->instances();
+	for (int i = 0; i < instances->count(); i++)
+	{
+		auto instance = instances->at(i);
+		// the game has its mods open
+		if (deduplicate && instance->isRunning())
+		{
+			skipped++;
+			continue;
+		}
+		folders << instance->modFolders();
+	}
+
+	// links only work within one drive, the instances are most likely on the same one as their folder
+	auto storePath = FS::PathCombine(instances->instDir(), ".modstore");
+	ModStore store(storePath, folders);
+	store.setDeduplicate(deduplicate);
+	ProgressDialog progress(this);
+	progress.setSkipButton(true, tr("Abort"));
+	progress.execWithTask(&store);
+	if (!store.successful())
+	{
+		QMessageBox::warning(this, tr("Error"), tr("Unable to look for duplicate mods:\n%1").arg(store.failReason()));
+		return;
+	}
+
+	auto report = store.report();
+	QString text = tr("%1 mod files take %2. %3 of them are duplicates, sharing them would free %4.")
+					   .arg(report.files)
+					   .arg(formatSize(report.bytes))
+					   .arg(report.duplicates)
+					   .arg(formatSize(report.reclaimable));
+	if (report.saved)
+	{
+		text += " " + tr("The mod store already saves %1.").arg(formatSize(report.saved));
+	}
+	if (skipped)
+	{
+		text += " " + tr("%n running instance(s) were left alone.", "", skipped);
+	}
+	if (report.unshared)
+	{
+		text += " " + tr("%n duplicate(s) couldn't share their data with the mod store in %1. "
+						 "They may be on another drive, or the file system can't link files.", "", report.unshared)
+						  .arg(QDir(storePath).absolutePath());
+	}
+	ui->modStoreLabel->setText(text);
+}
+
+void DiskUsagePage::updateTotal()
+{
+	ui->totalLabel->setText(tr("All instances together take %1.").arg(formatSize(m_model->total())));
+}
+
+#include "DiskUsagePage.moc"
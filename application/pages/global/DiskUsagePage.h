@@ -0,0 +1,65 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QWidget>
+
+#include "pages/BasePage.h"
+#include <MultiMC.h>
+
+namespace Ui {
+class DiskUsagePage;
+}
+
+class DiskUsageModel;
+class QSortFilterProxyModel;
+
+class DiskUsagePage : public QWidget, public BasePage
+{
+	Q_OBJECT
+
+public:
+	explicit DiskUsagePage(QWidget *parent = 0);
+	~DiskUsagePage();
+
+	QString displayName() const override
+	{
+		return tr("Disk Usage");
+	}
+	QIcon icon() const override
+	{
+		return MMC->getThemedIcon("viewfolder");
+	}
+	QString id() const override
+	{
+		return "disk-usage";
+	}
+	void opened() override;
+
+private slots:
+	void on_refreshButton_clicked();
+	void on_findDuplicateModsButton_clicked();
+	void on_deduplicateModsButton_clicked();
+	void updateTotal();
+
+private:
+	void runModStore(bool deduplicate);
+
+private:
+	Ui::DiskUsagePage *ui;
+	DiskUsageModel *m_model;
+	QSortFilterProxyModel *m_proxy;
+};
@@ -62,6 +62,10 @@ void MinecraftPage::applySettings()
 	s->set("LaunchMaximized", ui->maximizedCheckBox->isChecked());
 	s->set("MinecraftWinWidth", ui->windowWidthSpinBox->value());
 	s->set("MinecraftWinHeight", ui->windowHeightSpinBox->value());
+
+	// Launch
+	s->set("PrewarmJVM", ui->prewarmJVMCheckBox->isChecked());
+	s->set("SharedNatives", ui->sharedNativesCheckBox->isChecked());
 }
 
 void MinecraftPage::loadSettings()
@@ -72,4 +76,8 @@ void MinecraftPage::loadSettings()
 	ui->maximizedCheckBox->setChecked(s->get("LaunchMaximized").toBool());
 	ui->windowWidthSpinBox->setValue(s->get("MinecraftWinWidth").toInt());
 	ui->windowHeightSpinBox->setValue(s->get("MinecraftWinHeight").toInt());
+
+	// Launch
+	ui->prewarmJVMCheckBox->setChecked(s->get("PrewarmJVM").toBool());
+	ui->sharedNativesCheckBox->setChecked(s->get("SharedNatives").toBool());
 }
@@ -313,6 +313,8 @@ void MultiMCPage::applySettings()
 	s->set("ConsoleFontSize", ui->fontSizeBox->value());
 	s->set("ConsoleMaxLines", ui->lineLimitSpinBox->value());
 	s->set("ConsoleOverflowStop", ui->checkStopLogging->checkState() != Qt::Unchecked);
+	s->set("ConsoleSpillToDisk", ui->checkSpillLog->checkState() != Qt::Unchecked);
+	s->set("ConsoleMaxLinesPerSecond", ui->rateLimitSpinBox->value());
 
 	// FTB
 	s->set("TrackFTBInstances", ui->trackFtbBox->isChecked());
@@ -403,6 +405,8 @@ void MultiMCPage::loadSettings()
 	refreshFontPreview();
 	ui->lineLimitSpinBox->setValue(s->get("ConsoleMaxLines").toInt());
 	ui->checkStopLogging->setChecked(s->get("ConsoleOverflowStop").toBool());
+	ui->checkSpillLog->setChecked(s->get("ConsoleSpillToDisk").toBool());
+	ui->rateLimitSpinBox->setValue(s->get("ConsoleMaxLinesPerSecond").toInt());
 
 	// FTB
 	ui->trackFtbBox->setChecked(s->get("TrackFTBInstances").toBool());
@@ -1,30 +1,49 @@
 #include "LogView.h"
-#include <QTextBlock>
 #include <QScrollBar>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QKeyEvent>
+#include <QMenu>
+#include <QApplication>
+#include <QClipboard>
+#include <QtMath>
 
-LogView::LogView(QWidget* parent) : QPlainTextEdit(parent)
+#include "launch/LogModel.h"
+
+namespace {
+// space between the text and the left edge of the view
+const int leftMargin = 4;
+// keep at most this many row layouts around, more than fit on any screen
+const int maxCachedRows = 1000;
+}
+
+LogView::LogView(QWidget* parent) : QAbstractScrollArea(parent)
 {
-	setWordWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
-	m_defaultFormat = new QTextCharFormat(currentCharFormat());
+	setBackgroundRole(QPalette::Base);
+	viewport()->setBackgroundRole(QPalette::Base);
+	viewport()->setCursor(Qt::IBeamCursor);
+	setFocusPolicy(Qt::StrongFocus);
+	verticalScrollBar()->setSingleStep(1);
+	setWordWrap(false);
 }
 
 LogView::~LogView()
 {
-	delete m_defaultFormat;
 }
 
 void LogView::setWordWrap(bool wrapping)
 {
+	m_wordWrap = wrapping;
 	if(wrapping)
 	{
 		setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-		setLineWrapMode(QPlainTextEdit::WidgetWidth);
 	}
 	else
 	{
 		setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-		setLineWrapMode(QPlainTextEdit::NoWrap);
 	}
+	invalidateLayout();
 }
 
 void LogView::setModel(QAbstractItemModel* model)
@@ -63,13 +82,224 @@ void LogView::modelDestroyed(QObject* model)
 
 void LogView::repopulate()
 {
-	auto doc = document();
-	doc->clear();
+	m_styles.clear();
+	m_selectionStart = m_selectionEnd = Position();
+	invalidateLayout();
+	scrollToBottom();
+}
+
+void LogView::invalidateLayout()
+{
+	m_rows.clear();
+	m_maxWidth = 0;
+	updateScrollBars();
+	viewport()->update();
+}
+
+const LogView::Style & LogView::styleFor(const QModelIndex &index)
+{
+	int level = m_model->data(index, LogModel::LevelRole).toInt();
+	auto iter = m_styles.find(level);
+	if(iter != m_styles.end())
+	{
+		return *iter;
+	}
+	Style style;
+	style.font = font();
+	auto fontData = m_model->data(index, Qt::FontRole);
+	if(fontData.isValid())
+	{
+		style.font = fontData.value<QFont>();
+	}
+	style.foreground = palette().color(QPalette::Text);
+	auto fg = m_model->data(index, Qt::TextColorRole);
+	if(fg.isValid())
+	{
+		style.foreground = fg.value<QColor>();
+	}
+	auto bg = m_model->data(index, Qt::BackgroundRole);
+	if(bg.isValid())
+	{
+		style.background = bg.value<QColor>();
+	}
+	return *m_styles.insert(level, style);
+}
+
+LogView::Row & LogView::row(int index)
+{
+	auto iter = m_rows.find(index);
+	if(iter != m_rows.end())
+	{
+		return **iter;
+	}
+	auto modelIndex = m_model->index(index, 0);
+	auto entry = std::make_shared<Row>();
+	entry->style = styleFor(modelIndex);
+
+	auto & layout = entry->layout;
+	layout.setText(m_model->data(modelIndex, Qt::DisplayRole).toString());
+	layout.setFont(entry->style.font);
+	QTextOption option;
+	option.setWrapMode(m_wordWrap ? QTextOption::WrapAtWordBoundaryOrAnywhere : QTextOption::NoWrap);
+	layout.setTextOption(option);
+	layout.setCacheEnabled(true);
+
+	qreal lineWidth = m_wordWrap ? qMax(1, viewport()->width() - 2 * leftMargin) : QWIDGETSIZE_MAX;
+	qreal height = 0;
+	layout.beginLayout();
+	while(true)
+	{
+		auto line = layout.createLine();
+		if(!line.isValid())
+		{
+			break;
+		}
+		line.setLineWidth(lineWidth);
+		line.setPosition(QPointF(0, height));
+		height += line.height();
+		if(!m_wordWrap)
+		{
+			m_maxWidth = qMax(m_maxWidth, qCeil(line.naturalTextWidth()) + 2 * leftMargin);
+		}
+	}
+	layout.endLayout();
+	entry->height = qMax(qCeil(height), QFontMetrics(entry->style.font).height());
+
+	if(m_rows.size() >= maxCachedRows)
+	{
+		m_rows.clear();
+	}
+	return **m_rows.insert(index, entry);
+}
+
+void LogView::updateScrollBars()
+{
+	int count = m_model ? m_model->rowCount() : 0;
+	int height = viewport()->height();
+	// find out how many rows at the end fit on the screen, that's how far the view can scroll
+	int fit = 0;
+	int used = 0;
+	for(int i = count - 1; i >= 0; i--)
+	{
+		used += row(i).height;
+		if(used > height)
+		{
+			break;
+		}
+		fit++;
+	}
+	auto vbar = verticalScrollBar();
+	vbar->setRange(0, qMax(0, count - qMax(fit, 1)));
+	vbar->setPageStep(qMax(fit, 1));
+
+	auto hbar = horizontalScrollBar();
+	if(m_wordWrap)
+	{
+		hbar->setRange(0, 0);
+	}
+	else
+	{
+		hbar->setRange(0, qMax(0, m_maxWidth - viewport()->width()));
+		hbar->setPageStep(viewport()->width());
+	}
+}
+
+int LogView::lastVisibleRow()
+{
+	int count = m_model ? m_model->rowCount() : 0;
+	int height = viewport()->height();
+	int y = 0;
+	int i = verticalScrollBar()->value();
+	for(; i < count; i++)
+	{
+		y += row(i).height;
+		if(y > height)
+		{
+			break;
+		}
+	}
+	return qMin(i, count) - 1;
+}
+
+void LogView::paintEvent(QPaintEvent* event)
+{
+	QPainter painter(viewport());
 	if(!m_model)
 	{
 		return;
 	}
-	rowsInserted(QModelIndex(), 0, m_model->rowCount() - 1);
+	Position selStart, selEnd;
+	normalizedSelection(selStart, selEnd);
+
+	QTextLayout::FormatRange selectionFormat;
+	selectionFormat.format.setBackground(palette().brush(QPalette::Highlight));
+	selectionFormat.format.setForeground(palette().brush(QPalette::HighlightedText));
+
+	int count = m_model->rowCount();
+	int width = viewport()->width();
+	int x = leftMargin - horizontalScrollBar()->value();
+	int y = 0;
+	auto rect = event->rect();
+	for(int i = verticalScrollBar()->value(); i < count && y < rect.bottom() + 1; i++)
+	{
+		auto & entry = row(i);
+		if(y + entry.height >= rect.top())
+		{
+			if(entry.style.background.isValid())
+			{
+				painter.fillRect(0, y, width, entry.height, entry.style.background);
+			}
+			QVector<QTextLayout::FormatRange> selections;
+			if(selStart.row != -1 && i >= selStart.row && i <= selEnd.row)
+			{
+				int from = i == selStart.row ? selStart.column : 0;
+				int to = i == selEnd.row ? selEnd.column : entry.layout.text().size();
+				if(to > from)
+				{
+					selectionFormat.start = from;
+					selectionFormat.length = to - from;
+					selections.append(selectionFormat);
+				}
+			}
+			painter.setPen(entry.style.foreground);
+			entry.layout.draw(&painter, QPointF(x, y), selections);
+		}
+		y += entry.height;
+	}
+}
+
+void LogView::resizeEvent(QResizeEvent* event)
+{
+	QAbstractScrollArea::resizeEvent(event);
+	bool atBottom = verticalScrollBar()->value() == verticalScrollBar()->maximum();
+	if(m_wordWrap)
+	{
+		invalidateLayout();
+	}
+	else
+	{
+		updateScrollBars();
+	}
+	if(atBottom)
+	{
+		verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+	}
+}
+
+void LogView::changeEvent(QEvent* event)
+{
+	QAbstractScrollArea::changeEvent(event);
+	if(event->type() == QEvent::FontChange || event->type() == QEvent::PaletteChange)
+	{
+		// the styles and everything laid out with them are out of date
+		m_styles.clear();
+		invalidateLayout();
+	}
+}
+
+void LogView::scrollContentsBy(int, int)
+{
+	viewport()->update();
 }
 
 void LogView::rowsAboutToBeInserted(const QModelIndex& parent, int first, int last)
@@ -92,31 +322,11 @@ void LogView::rowsAboutToBeInserted(const QModelIndex& parent, int first, int la
 
 void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
 {
-	for(int i = first; i <= last; i++)
-	{
-		auto idx = m_model->index(i, 0, parent);
-		auto text = m_model->data(idx, Qt::DisplayRole).toString();
-		QTextCharFormat format(*m_defaultFormat);
-		auto font = m_model->data(idx, Qt::FontRole);
-		if(font.isValid())
-		{
-			format.setFont(font.value<QFont>());
-		}
-		auto fg = m_model->data(idx, Qt::TextColorRole);
-		if(fg.isValid())
-		{
-			format.setForeground(fg.value<QColor>());
-		}
-		auto bg = m_model->data(idx, Qt::BackgroundRole);
-		if(bg.isValid())
-		{
-			format.setBackground(bg.value<QColor>());
-		}
-		auto workCursor = textCursor();
-		workCursor.movePosition(QTextCursor::End);
-		workCursor.insertText(text, format);
-		workCursor.insertBlock();
-	}
+	Q_UNUSED(parent)
+	Q_UNUSED(first)
+	Q_UNUSED(last)
+	updateScrollBars();
+	viewport()->update();
 	if(m_scroll && !m_scrolling)
 	{
 		m_scrolling = true;
@@ -126,10 +336,46 @@ void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
 
 void LogView::rowsRemoved(const QModelIndex& parent, int first, int last)
 {
-	// TODO: some day... maybe
 	Q_UNUSED(parent)
 	Q_UNUSED(first)
-	Q_UNUSED(last)
+	int removed = last + 1;
+
+	// row numbers of everything that is left moved up
+	QHash<int, std::shared_ptr<Row>> rows;
+	for(auto iter = m_rows.begin(); iter != m_rows.end(); iter++)
+	{
+		if(iter.key() >= removed)
+		{
+			rows.insert(iter.key() - removed, iter.value());
+		}
+	}
+	m_rows.swap(rows);
+
+	auto shift = [&](Position & position)
+	{
+		position.row -= removed;
+		if(position.row < 0)
+		{
+			position.row = 0;
+			position.column = 0;
+		}
+	};
+	if(m_selectionStart.row != -1)
+	{
+		shift(m_selectionStart);
+		shift(m_selectionEnd);
+		if(m_selectionStart.row == m_selectionEnd.row && m_selectionStart.column == m_selectionEnd.column)
+		{
+			m_selectionStart = m_selectionEnd = Position();
+		}
+	}
+
+	// keep showing the same lines, unless they are gone
+	auto bar = verticalScrollBar();
+	int value = bar->value();
+	updateScrollBars();
+	bar->setValue(qMax(0, value - removed));
+	viewport()->update();
 }
 
 void LogView::scrollToBottom()
@@ -138,7 +384,243 @@ void LogView::scrollToBottom()
 	verticalScrollBar()->setSliderPosition(verticalScrollBar()->maximum());
 }
 
-void LogView::findNext(const QString& what, bool reverse)
+void LogView::ensureVisible(int rowIndex, int column)
+{
+	auto bar = verticalScrollBar();
+	if(rowIndex < bar->value() || rowIndex > lastVisibleRow())
+	{
+		bar->setValue(rowIndex - bar->pageStep() / 2);
+	}
+	if(!m_wordWrap)
+	{
+		auto & entry = row(rowIndex);
+		auto line = entry.layout.lineForTextPosition(column);
+		if(line.isValid())
+		{
+			int x = qFloor(line.cursorToX(column)) + leftMargin;
+			auto hbar = horizontalScrollBar();
+			if(x < hbar->value() || x > hbar->value() + viewport()->width() - leftMargin)
+			{
+				hbar->setValue(x - viewport()->width() / 2);
+			}
+		}
+	}
+}
+
+LogView::Position LogView::positionAt(const QPoint& point)
+{
+	Position position;
+	if(!m_model)
+	{
+		return position;
+	}
+	int count = m_model->rowCount();
+	if(count == 0)
+	{
+		return position;
+	}
+	int first = verticalScrollBar()->value();
+	if(point.y() < 0)
+	{
+		position.row = qMax(first - 1, 0);
+		return position;
+	}
+	int y = 0;
+	for(int i = first; i < count; i++)
+	{
+		auto & entry = row(i);
+		if(point.y() < y + entry.height)
+		{
+			position.row = i;
+			qreal x = point.x() - leftMargin + horizontalScrollBar()->value();
+			for(int l = 0; l < entry.layout.lineCount(); l++)
+			{
+				auto line = entry.layout.lineAt(l);
+				if(point.y() < y + line.y() + line.height() || l == entry.layout.lineCount() - 1)
+				{
+					position.column = line.xToCursor(x);
+					break;
+				}
+			}
+			return position;
+		}
+		y += entry.height;
+	}
+	// below the last row
+	position.row = count - 1;
+	position.column = row(count - 1).layout.text().size();
+	return position;
+}
+
+void LogView::normalizedSelection(Position &start, Position &end) const
+{
+	start = m_selectionStart;
+	end = m_selectionEnd;
+	if(end.row < start.row || (end.row == start.row && end.column < start.column))
+	{
+		std::swap(start, end);
+	}
+}
+
+void LogView::select(Position start, Position end)
+{
+	m_selectionStart = start;
+	m_selectionEnd = end;
+	viewport()->update();
+}
+
+bool LogView::hasSelection() const
+{
+	return m_selectionStart.row != -1 && (m_selectionStart.row != m_selectionEnd.row || m_selectionStart.column != m_selectionEnd.column);
+}
+
+QString LogView::selectedText() const
+{
+	if(!m_model || !hasSelection())
+	{
+		return QString();
+	}
+	Position start, end;
+	normalizedSelection(start, end);
+	QStringList lines;
+	for(int i = start.row; i <= end.row && i < m_model->rowCount(); i++)
+	{
+		auto text = m_model->data(m_model->index(i, 0), Qt::DisplayRole).toString();
+		int from = i == start.row ? start.column : 0;
+		int to = i == end.row ? end.column : text.size();
+		lines.append(text.mid(from, to - from));
+	}
+	return lines.join('\n');
+}
+
+void LogView::selectionStart(int &row, int &column) const
+{
+	if(hasSelection())
+	{
+		Position start, end;
+		normalizedSelection(start, end);
+		row = start.row;
+		column = start.column;
+		return;
+	}
+	row = verticalScrollBar()->value();
+	column = -1;
+}
+
+void LogView::selectRange(int rowIndex, int column, int length)
+{
+	if(!m_model || rowIndex < 0 || rowIndex >= m_model->rowCount())
+	{
+		return;
+	}
+	Position start, end;
+	start.row = end.row = rowIndex;
+	start.column = column;
+	end.column = column + length;
+	select(start, end);
+	ensureVisible(rowIndex, column);
+}
+
+void LogView::copy()
+{
+	if(hasSelection())
+	{
+		QApplication::clipboard()->setText(selectedText());
+	}
+}
+
+void LogView::selectAll()
+{
+	if(!m_model || m_model->rowCount() == 0)
+	{
+		return;
+	}
+	int last = m_model->rowCount() - 1;
+	Position start, end;
+	start.row = 0;
+	end.row = last;
+	end.column = m_model->data(m_model->index(last, 0), Qt::DisplayRole).toString().size();
+	select(start, end);
+}
+
+void LogView::mousePressEvent(QMouseEvent* event)
+{
+	if(event->button() != Qt::LeftButton)
+	{
+		QAbstractScrollArea::mousePressEvent(event);
+		return;
+	}
+	auto position = positionAt(event->pos());
+	if(event->modifiers() & Qt::ShiftModifier && m_selectionStart.row != -1)
+	{
+		select(m_selectionStart, position);
+	}
+	else
+	{
+		select(position, position);
+	}
+	m_selecting = true;
+}
+
+void LogView::mouseMoveEvent(QMouseEvent* event)
+{
+	if(!m_selecting)
+	{
+		QAbstractScrollArea::mouseMoveEvent(event);
+		return;
+	}
+	// drag past the edges to scroll
+	auto bar = verticalScrollBar();
+	if(event->pos().y() < 0)
+	{
+		bar->setValue(bar->value() - 1);
+	}
+	else if(event->pos().y() > viewport()->height())
+	{
+		bar->setValue(bar->value() + 1);
+	}
+	select(m_selectionStart, positionAt(event->pos()));
+}
+
+void LogView::mouseReleaseEvent(QMouseEvent* event)
+{
+	if(event->button() == Qt::LeftButton)
+	{
+		m_selecting = false;
+	}
+	QAbstractScrollArea::mouseReleaseEvent(event);
+}
+
+void LogView::keyPressEvent(QKeyEvent* event)
+{
+	if(event == QKeySequence::Copy)
+	{
+		copy();
+	}
+	else if(event == QKeySequence::SelectAll)
+	{
+		selectAll();
+	}
+	else if(event == QKeySequence::MoveToStartOfDocument)
+	{
+		verticalScrollBar()->setValue(0);
+	}
+	else if(event == QKeySequence::MoveToEndOfDocument)
+	{
+		scrollToBottom();
+	}
+	else
+	{
+		QAbstractScrollArea::keyPressEvent(event);
+	}
+}
+
+void LogView::contextMenuEvent(QContextMenuEvent* event)
 {
-	find(what, reverse ? QTextDocument::FindFlag::FindBackward : QTextDocument::FindFlag(0));
+	QMenu menu(this);
+	auto copyAction = menu.addAction(tr("&Copy"), this, SLOT(copy()), QKeySequence::Copy);
+	copyAction->setEnabled(hasSelection());
+	menu.addSeparator();
+	menu.addAction(tr("Select All"), this, SLOT(selectAll()), QKeySequence::SelectAll);
+	menu.exec(event->globalPos());
 }
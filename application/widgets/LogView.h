@@ -1,10 +1,21 @@
 #pragma once
-#include <QPlainTextEdit>
+#include <QAbstractScrollArea>
 #include <QAbstractItemView>
+#include <QTextLayout>
+#include <QHash>
+#include <memory>
 
 class QAbstractItemModel;
 
-class LogView: public QPlainTextEdit
+/*
+ * Read-only view of a log model.
+ *
+ * Only the rows that are on screen are laid out and painted, straight from the model.
+ * Nothing is copied out of the model, so memory use is bounded by the model's line limit.
+ * Scrolling is done in whole rows, like QPlainTextEdit does with blocks, so word wrapping
+ * never needs the whole log to be laid out.
+ */
+class LogView: public QAbstractScrollArea
 {
 	Q_OBJECT
 public:
@@ -14,10 +25,18 @@ public:
 	virtual void setModel(QAbstractItemModel *model);
 	QAbstractItemModel *model() const;
 
+	bool hasSelection() const;
+	QString selectedText() const;
+	/// start of the selection, or the top of the view with column -1 if nothing is selected
+	void selectionStart(int &row, int &column) const;
+	/// select length characters of the row, starting at column, and scroll there
+	void selectRange(int row, int column, int length);
+
 public slots:
 	void setWordWrap(bool wrapping);
-	void findNext(const QString & what, bool reverse);
 	void scrollToBottom();
+	void copy();
+	void selectAll();
 
 protected slots:
 	void repopulate();
@@ -28,9 +47,60 @@ protected slots:
 	void rowsRemoved(const QModelIndex &parent, int first, int last);
 	void modelDestroyed(QObject * model);
 
+protected:
+	void paintEvent(QPaintEvent *event) override;
+	void resizeEvent(QResizeEvent *event) override;
+	void changeEvent(QEvent *event) override;
+	void scrollContentsBy(int dx, int dy) override;
+	void mousePressEvent(QMouseEvent *event) override;
+	void mouseMoveEvent(QMouseEvent *event) override;
+	void mouseReleaseEvent(QMouseEvent *event) override;
+	void keyPressEvent(QKeyEvent *event) override;
+	void contextMenuEvent(QContextMenuEvent *event) override;
+
+private: /* types */
+	struct Position
+	{
+		int row = -1;
+		int column = 0;
+	};
+	struct Style
+	{
+		QFont font;
+		QColor foreground;
+		QColor background;
+	};
+	struct Row
+	{
+		QTextLayout layout;
+		Style style;
+		int height = 0;
+	};
+
+private: /* methods */
+	Row & row(int index);
+	const Style & styleFor(const QModelIndex &index);
+	void invalidateLayout();
+	void updateScrollBars();
+	int lastVisibleRow();
+	void ensureVisible(int rowIndex, int column);
+	Position positionAt(const QPoint &point);
+	void select(Position start, Position end);
+	void normalizedSelection(Position &start, Position &end) const;
+
 protected:
 	QAbstractItemModel *m_model = nullptr;
-	QTextCharFormat *m_defaultFormat = nullptr;
 	bool m_scroll = false;
 	bool m_scrolling = false;
+
+private:
+	bool m_wordWrap = false;
+	int m_maxWidth = 0;
+	bool m_selecting = false;
+	Position m_selectionStart;
+	Position m_selectionEnd;
+	// layouts of the rows that were recently on screen, by row number
+	QHash<int, std::shared_ptr<Row>> m_rows;
+	// styles by message level, they are the same for every row of a level
+	QHash<int, Style> m_styles;
 };
@@ -55,6 +55,7 @@ void WonkoClient::initGlobalSettings()
     m_settings->registerSetting("RaiseConsole", true);
     m_settings->registerSetting("AutoCloseConsole", true);
     m_settings->registerSetting("LogPrePostOutput", true);
+    m_settings->registerSetting("ConsoleMaxLinesPerSecond", 0);
     // Window Size
     m_settings->registerSetting({"LaunchMaximized", "MCWindowMaximize"}, false);
     m_settings->registerSetting({"MinecraftWinWidth", "MCWindowWidth"}, 854);
@@ -83,4 +84,6 @@ void WonkoClient::initGlobalSettings()
 
     // Minecraft launch method
     m_settings->registerSetting("MCLaunchMethod", "LauncherPart");
+    m_settings->registerSetting("PrewarmJVM", false);
+    m_settings->registerSetting("SharedNatives", false);
 }